@@ -0,0 +1,62 @@
+QT += core gui network charts
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++17
+
+TARGET = esp32_v5
+
+# Включение обработки ошибок, связанных с устаревшими API:
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+include(ingest.pri)
+include(processing.pri)
+
+# Источники
+SOURCES += \
+    connectionManager.cpp \
+    dataProcessor.cpp \
+    dataReceiver.cpp \
+    deviceSession.cpp \
+    ingestWorker.cpp \
+    ipsettingsdialog.cpp \
+    main.cpp \
+    mainwindow.cpp \
+    pipelineStatsPanel.cpp \
+    sessionDashboard.cpp \
+    sessionManager.cpp \
+    sessionView.cpp \
+    stripChart.cpp
+
+# Заголовочные файлы
+HEADERS += \
+    connectionManager.h \
+    dataProcessor.h \
+    dataReceiver.h \
+    deviceSession.h \
+    ingestWorker.h \
+    ipsettingsdialog.h \
+    mainwindow.h \
+    pipelineStatsPanel.h \
+    sessionDashboard.h \
+    sessionManager.h \
+    sessionView.h \
+    spscRingBuffer.h \
+    stripChart.h
+
+# Формы Qt Designer
+FORMS += \
+    ipsettingsdialog.ui \
+    mainwindow.ui
+
+# Правила сборки
+unix:!android {
+    target.path = /opt/$${TARGET}/bin
+    INSTALLS += target
+}
+
+qnx: target.path = /tmp/$${TARGET}/bin
+
+# Windows специфические настройки
+win32:CONFIG(release, debug|release): DESTDIR = release
+win32:CONFIG(debug, debug|release): DESTDIR = debug
+
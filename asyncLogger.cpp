@@ -0,0 +1,251 @@
+#include "asyncLogger.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <cstdio>
+
+namespace {
+
+const char* const tracingRules = "esp32.sample.debug=true\nesp32.beat.debug=true";
+const int repeatFlushMs = 1000; // через сколько выводить счётчик повторов, если новых сообщений нет
+
+struct Entry {
+    QtMsgType type;
+    const char* category; // имя категории — строковый литерал из Q_LOGGING_CATEGORY
+    qint64 epochMs;
+    QString message;
+};
+
+char severity(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg: return 'D';
+    case QtInfoMsg: return 'I';
+    case QtWarningMsg: return 'W';
+    case QtCriticalMsg: return 'C';
+    case QtFatalMsg: return 'F';
+    }
+    return '?';
+}
+
+class LogWriter : public QThread
+{
+public:
+    LogWriter(const QString& filePath, int capacity)
+        : ring(qMax(16, capacity))
+    {
+        setObjectName("log");
+        if (!filePath.isEmpty()) {
+            file.setFileName(filePath);
+            // Ошибку открытия некуда сообщить, кроме stderr — через qDebug был бы цикл
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+                std::fprintf(stderr, "AsyncLogger: cannot open %s\n", qPrintable(filePath));
+        }
+    }
+
+    // Поток-отправитель: только копия строки (неявно разделяемой) под мьютексом
+    void push(QtMsgType type, const char* category, const QString& message)
+    {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        QMutexLocker locker(&mutex);
+        if (count == ring.size()) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Entry& entry = ring[(head + count) % ring.size()];
+        entry = { type, category, now, message };
+        ++count;
+        wake.wakeOne();
+    }
+
+    // Ждать, пока всё накопленное не будет выведено
+    void flush()
+    {
+        QMutexLocker locker(&mutex);
+        while (count > 0 || writing)
+            drained.wait(&mutex);
+    }
+
+    void stop()
+    {
+        {
+            QMutexLocker locker(&mutex);
+            stopping = true;
+            wake.wakeOne();
+        }
+        wait();
+    }
+
+    std::atomic<quint64> dropped { 0 };
+
+protected:
+    void run() override
+    {
+        QVector<Entry> batch;
+        for (;;) {
+            {
+                QMutexLocker locker(&mutex);
+                if (count == 0 && !stopping)
+                    wake.wait(&mutex, repeatFlushMs);
+                for (; count > 0; --count) {
+                    batch.append(std::move(ring[head]));
+                    head = (head + 1) % ring.size();
+                }
+                writing = !batch.isEmpty();
+                if (batch.isEmpty() && stopping)
+                    break;
+            }
+            for (const Entry& entry : std::as_const(batch))
+                write(entry);
+            if (batch.isEmpty())
+                flushRepeats();
+            flushOutput();
+            batch.resize(0);
+
+            QMutexLocker locker(&mutex);
+            writing = false;
+            drained.wakeAll();
+        }
+        flushRepeats();
+        flushOutput();
+    }
+
+private:
+    void write(const Entry& entry)
+    {
+        // Повтор предыдущего сообщения — только счётчик (его выводим не реже раза в секунду)
+        if (entry.type == last.type && entry.category == last.category && entry.message == last.message) {
+            if (repeats == 0)
+                repeatsSinceMs = entry.epochMs;
+            ++repeats;
+            if (entry.epochMs - repeatsSinceMs >= repeatFlushMs)
+                flushRepeats();
+            return;
+        }
+        flushRepeats();
+        last = entry;
+        append(QString("%1 %2 %3: %4\n")
+                   .arg(QDateTime::fromMSecsSinceEpoch(entry.epochMs).toString("hh:mm:ss.zzz"))
+                   .arg(severity(entry.type))
+                   .arg(QLatin1String(entry.category), entry.message));
+    }
+
+    void flushRepeats()
+    {
+        if (repeats == 0)
+            return;
+        append(QString("    (last message repeated %1 times)\n").arg(repeats));
+        repeats = 0;
+    }
+
+    void append(const QString& line)
+    {
+        output.append(line.toLocal8Bit());
+        if (output.size() >= 16 * 1024)
+            flushOutput();
+    }
+
+    void flushOutput()
+    {
+        if (output.isEmpty())
+            return;
+        std::fwrite(output.constData(), 1, output.size(), stderr);
+        if (file.isOpen())
+            file.write(output);
+        output.resize(0);
+    }
+
+    QMutex mutex;
+    QWaitCondition wake;
+    QWaitCondition drained;
+    QVector<Entry> ring;
+    int head = 0;
+    int count = 0;
+    bool writing = false;
+    bool stopping = false;
+
+    // Только поток вывода
+    QFile file;
+    QByteArray output;
+    Entry last { QtDebugMsg, nullptr, 0, QString() };
+    int repeats = 0;
+    qint64 repeatsSinceMs = 0;
+};
+
+LogWriter* writer = nullptr;
+QtMessageHandler previousHandler = nullptr;
+QMutex rulesMutex;
+QString baseRules;
+bool tracing = false;
+
+void handleMessage(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    writer->push(type, context.category ? context.category : "default", message);
+    // После фатального сообщения Qt завершит процесс — всё должно быть выведено до этого
+    if (type == QtFatalMsg)
+        writer->flush();
+}
+
+void applyRules()
+{
+    QString rules = baseRules;
+    if (tracing)
+        rules += (rules.isEmpty() ? "" : "\n") + QString(tracingRules);
+    QLoggingCategory::setFilterRules(rules);
+}
+
+} // namespace
+
+namespace AsyncLogger {
+
+void install(const QString& filePath, int capacity)
+{
+    if (writer)
+        return;
+    writer = new LogWriter(filePath, capacity);
+    writer->start(QThread::LowPriority);
+    previousHandler = qInstallMessageHandler(handleMessage);
+}
+
+void shutdown()
+{
+    if (!writer)
+        return;
+    qInstallMessageHandler(previousHandler);
+    writer->stop();
+    delete writer;
+    writer = nullptr;
+}
+
+quint64 droppedCount()
+{
+    return writer ? writer->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+void setFilterRules(const QString& rules)
+{
+    QMutexLocker locker(&rulesMutex);
+    baseRules = rules;
+    applyRules();
+}
+
+void setSampleTracing(bool enabled)
+{
+    QMutexLocker locker(&rulesMutex);
+    tracing = enabled;
+    applyRules();
+}
+
+bool sampleTracing()
+{
+    QMutexLocker locker(&rulesMutex);
+    return tracing;
+}
+
+} // namespace AsyncLogger
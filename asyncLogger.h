@@ -0,0 +1,58 @@
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+// Асинхронный вывод сообщений Qt (qDebug, qCWarning, ...). Обработчик сообщений только
+// кладёт готовый текст в кольцевой буфер; оформление строки (время, уровень, категория)
+// и запись в stderr и файл — в отдельном потоке, так что потоки обработки и GUI не ждут
+// вывода. Буфер переполнен — сообщение отбрасывается и учитывается в droppedCount().
+// Подряд идущие одинаковые сообщения выводятся один раз с числом повторов.
+//
+// Категории (каждая объявлена в файле, который её использует):
+//   esp32.sample  — каждый отсчёт (SignalProcessor), отладка выключена по умолчанию
+//   esp32.beat    — каждый пик и BPM, отладка выключена по умолчанию
+//   esp32.parse   — ошибки разбора потока, не чаще раза в 5 с на устройство
+//   esp32.net, esp32.session, esp32.record, esp32.replay, esp32.export
+// Правила — как у QLoggingCategory::setFilterRules() (или переменная QT_LOGGING_RULES).
+namespace AsyncLogger {
+
+// Устанавливает обработчик сообщений; filePath — дополнительно дописывать в файл
+void install(const QString& filePath = QString(), int capacity = 4096);
+// Дописывает очередь, останавливает поток и возвращает прежний обработчик
+void shutdown();
+
+quint64 droppedCount();
+
+// Постоянные правила (например, из QSettings "logRules") и трассировка по отсчётам поверх них:
+// esp32.sample и esp32.beat включаются и выключаются на ходу, без пересборки
+void setFilterRules(const QString& rules);
+void setSampleTracing(bool enabled);
+bool sampleTracing();
+
+} // namespace AsyncLogger
+
+// Не чаще одного сообщения за intervalMs: для повторяющихся ошибок (разбор потока и т. п.).
+// Не потокобезопасен — по объекту на поток.
+class LogRateLimiter
+{
+public:
+    explicit LogRateLimiter(qint64 intervalMs = 5000) : intervalMs(intervalMs) {}
+
+    // true — можно писать; иначе сообщение не формируется вовсе
+    bool allow()
+    {
+        if (timer.isValid() && timer.elapsed() < intervalMs)
+            return false;
+        timer.start();
+        return true;
+    }
+    qint64 interval() const { return intervalMs; }
+
+private:
+    QElapsedTimer timer;
+    qint64 intervalMs;
+};
+
+#endif // ASYNCLOGGER_H
@@ -0,0 +1,28 @@
+QT = core
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = esp32_bench
+
+include(../ingest.pri)
+include(../processing.pri)
+
+SOURCES += \
+    benchFixtures.cpp \
+    benchReport.cpp \
+    dspBench.cpp \
+    exportBench.cpp \
+    historyBench.cpp \
+    journalBench.cpp \
+    main.cpp \
+    parserBench.cpp \
+    peakBench.cpp \
+    pipelineBench.cpp \
+    protocolBench.cpp \
+    replayBench.cpp \
+    statsBench.cpp
+
+HEADERS += \
+    benchFixtures.h \
+    benchHarness.h \
+    benchReport.h
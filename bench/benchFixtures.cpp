@@ -0,0 +1,53 @@
+#include "benchFixtures.h"
+#include "sampleStreamDecoder.h"
+#include "streamRecording.h"
+
+#include <QFile>
+#include <QtMath>
+#include <cmath>
+
+// Пульсовая волна ~72 уд/мин с шумом и дрейфом; значения целые, как у АЦП, поэтому в окне бывают равные точки
+QVector<SensorSample> makePpg(int count, int rateHz)
+{
+    QVector<SensorSample> samples(count);
+    quint32 noise = 12345;
+    auto nextNoise = [&noise]() {
+        noise = noise * 1664525u + 1013904223u;
+        return int(noise >> 24) - 128;
+    };
+    for (int i = 0; i < count; ++i) {
+        const double t = double(i) / rateHz;
+        const double phase = std::fmod(t * 1.2 + 0.05 * std::sin(t * 0.3), 1.0);
+        const double pulse = phase < 0.15 ? std::pow(std::sin(phase / 0.15 * M_PI / 2), 2) : 1.0 - (phase - 0.15) / 0.85;
+        SensorSample& s = samples[i];
+        s.timestamp = 100000 + qint64(i) * 1000 / rateHz;
+        s.irValue = std::round(100000 + 2000 * pulse + 300 * std::sin(t * 1.5) + nextNoise() / 16);
+        s.redValue = std::round(60000 + 700 * pulse + 120 * std::sin(t * 1.5) + nextNoise() / 16);
+        s.tempValue = 36.6;
+    }
+    return samples;
+}
+
+// Отсчёты из записи .esprec или сырого дампа потока
+QVector<SensorSample> loadRecording(const QString& path)
+{
+    QVector<SensorSample> samples;
+    SampleStreamDecoder decoder;
+    StreamRecordingReader reader;
+    if (reader.open(path)) {
+        StreamRecording::Chunk chunk;
+        while (reader.readNext(chunk)) {
+            if (chunk.type == StreamRecording::Chunk::StreamReset)
+                decoder.reset();
+            else
+                decoder.feed(chunk.data.constData(), chunk.data.size(), samples);
+        }
+    } else {
+        QFile file(path);
+        if (file.open(QIODevice::ReadOnly)) {
+            const QByteArray data = file.readAll();
+            decoder.feed(data.constData(), data.size(), samples);
+        }
+    }
+    return samples;
+}
@@ -0,0 +1,16 @@
+#ifndef BENCHFIXTURES_H
+#define BENCHFIXTURES_H
+
+#include <QString>
+#include <QVector>
+#include "sensorSample.h"
+
+// Входные данные бенчмарков: синтетические детерминированы, записи — с диска (аргументы esp32_bench)
+
+// Пульсовая волна ~72 уд/мин с шумом и дрейфом, метки времени с 100000 мс
+QVector<SensorSample> makePpg(int count, int rateHz);
+
+// Отсчёты из записи .esprec или сырого дампа потока; пусто — файл не прочитан
+QVector<SensorSample> loadRecording(const QString& path);
+
+#endif // BENCHFIXTURES_H
@@ -0,0 +1,70 @@
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+
+// Минимальный набор для замеров: лучший результат из нескольких прогонов
+struct BenchResult {
+    QString group;        // группа бенчмарков (--group); вместе с name — ключ для сравнения с эталоном
+    QString name;
+    qint64 items = 0;     // число обработанных элементов (строк, отсчётов) за прогон
+    qint64 bestNs = 0;    // лучшее время одного прогона
+
+    double itemsPerSec() const { return bestNs > 0 ? items * 1e9 / bestNs : 0.0; }
+    double nsPerItem() const { return items > 0 ? double(bestNs) / items : 0.0; }
+};
+
+// Не даёт компилятору выбросить результат вычислений
+template<typename T>
+inline void benchKeep(const T& value)
+{
+    static volatile T sink;
+    sink = value;
+}
+
+template<typename Body>
+BenchResult runBench(const QString& name, qint64 items, int repeats, Body&& body)
+{
+    BenchResult result;
+    result.name = name;
+    result.items = items;
+    body(); // прогрев
+    for (int i = 0; i < repeats; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        body();
+        const qint64 ns = timer.nsecsElapsed();
+        result.bestNs = (i == 0) ? ns : std::min(result.bestNs, ns);
+    }
+    return result;
+}
+
+// Группа, которая сейчас выполняется (задаёт main)
+inline QString& currentBenchGroup()
+{
+    static QString group;
+    return group;
+}
+
+// Все выведенные результаты прогона — для JSON и сравнения с эталоном (benchReport.h)
+inline QVector<BenchResult>& benchResults()
+{
+    static QVector<BenchResult> results;
+    return results;
+}
+
+inline void printBenchResult(QTextStream& out, const BenchResult& result)
+{
+    BenchResult r = result;
+    r.group = currentBenchGroup();
+    benchResults().append(r);
+    out << qSetFieldWidth(40) << Qt::left << r.name << qSetFieldWidth(0)
+        << QString::number(r.itemsPerSec(), 'f', 0) << " items/s, "
+        << QString::number(r.nsPerItem(), 'f', 1) << " ns/item\n";
+}
+
+#endif // BENCHHARNESS_H
@@ -0,0 +1,110 @@
+#include "benchReport.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+namespace {
+
+QString resultKey(const QString& group, const QString& name)
+{
+    return group + "/" + name;
+}
+
+} // namespace
+
+namespace BenchReport {
+
+bool writeJson(const QString& path, const QVector<BenchResult>& results)
+{
+    QJsonArray array;
+    for (const BenchResult& r : results) {
+        QJsonObject json;
+        json["group"] = r.group;
+        json["name"] = r.name;
+        json["items"] = double(r.items);
+        json["best_ns"] = double(r.bestNs);
+        json["ns_per_item"] = r.nsPerItem();
+        json["items_per_sec"] = r.itemsPerSec();
+        array.append(json);
+    }
+    QJsonObject root;
+    root["generated"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["qt"] = QString(qVersion());
+#ifdef QT_NO_DEBUG
+    root["build"] = "release";
+#else
+    root["build"] = "debug";
+#endif
+    root["threads"] = QThread::idealThreadCount();
+    root["results"] = array;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot write benchmark results to" << path << ":" << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+bool compareWithBaseline(QTextStream& out, const QVector<BenchResult>& results,
+                         const QString& baselinePath, double thresholdPercent)
+{
+    QFile file(baselinePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        out << "Cannot read baseline " << baselinePath << "\n";
+        return false;
+    }
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (document.isNull()) {
+        out << "Baseline " << baselinePath << ": " << error.errorString() << "\n";
+        return false;
+    }
+    QHash<QString, double> baseline;
+    for (const QJsonValue& value : document.object().value("results").toArray()) {
+        const QJsonObject json = value.toObject();
+        baseline.insert(resultKey(json.value("group").toString(), json.value("name").toString()),
+                        json.value("ns_per_item").toDouble());
+    }
+
+    out << "== Comparison with " << baselinePath << " (threshold " << thresholdPercent << " %) ==\n";
+    int regressions = 0;
+    int improvements = 0;
+    int unmatched = 0;
+    for (const BenchResult& r : results) {
+        const QString key = resultKey(r.group, r.name);
+        const auto it = baseline.constFind(key);
+        if (it == baseline.constEnd() || it.value() <= 0.0) {
+            ++unmatched;
+            continue;
+        }
+        const double changePercent = (r.nsPerItem() / it.value() - 1.0) * 100.0;
+        QString verdict;
+        if (changePercent > thresholdPercent) {
+            verdict = "REGRESSION";
+            ++regressions;
+        } else if (changePercent < -thresholdPercent) {
+            verdict = "faster";
+            ++improvements;
+        } else {
+            continue;
+        }
+        out << qSetFieldWidth(56) << Qt::left << key << qSetFieldWidth(0)
+            << QString::number(it.value(), 'f', 1) << " -> " << QString::number(r.nsPerItem(), 'f', 1)
+            << " ns/item (" << (changePercent > 0 ? "+" : "") << QString::number(changePercent, 'f', 1)
+            << " %) " << verdict << "\n";
+    }
+    out << regressions << " regression(s), " << improvements << " improvement(s), "
+        << results.size() - regressions - improvements - unmatched << " within threshold, "
+        << unmatched << " not in baseline\n\n";
+    return regressions == 0;
+}
+
+} // namespace BenchReport
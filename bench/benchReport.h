@@ -0,0 +1,22 @@
+#ifndef BENCHREPORT_H
+#define BENCHREPORT_H
+
+#include "benchHarness.h"
+
+// Результаты прогона в JSON и сравнение с сохранённым эталоном (тот же JSON прошлого прогона).
+// Сравниваются нс на элемент по ключу группа/имя; лучший из нескольких прогонов уже
+// отсекает большую часть шума, порог задаёт остальное.
+namespace BenchReport {
+
+// {"generated", "qt", "build", "threads", "results": [{"group", "name", "items", "best_ns",
+//  "ns_per_item", "items_per_sec"}]}
+bool writeJson(const QString& path, const QVector<BenchResult>& results);
+
+// Печатает изменения относительно эталона; false — есть замедление больше thresholdPercent
+// (или эталон не прочитан)
+bool compareWithBaseline(QTextStream& out, const QVector<BenchResult>& results,
+                         const QString& baselinePath, double thresholdPercent);
+
+} // namespace BenchReport
+
+#endif // BENCHREPORT_H
@@ -0,0 +1,200 @@
+#include "bandPassFilter.h"
+#include "benchHarness.h"
+#include "rollingStatistics.h"
+#include "slidingWindowMean.h"
+#include "spectralHeartRate.h"
+
+#include <QQueue>
+#include <QVector>
+#include <QtMath>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// Прежний способ: очередь по времени и полный пересчёт суммы на каждом отсчёте
+class LegacyWindowMean
+{
+public:
+    explicit LegacyWindowMean(qint64 windowMs) : windowMs(windowMs) {}
+
+    double add(qint64 timestamp, double value)
+    {
+        buffer.push_back({ timestamp, value });
+        while (!buffer.isEmpty() && timestamp - buffer.front().first > windowMs)
+            buffer.pop_front();
+        double sum = 0.0;
+        for (const auto& p : buffer)
+            sum += p.second;
+        return sum / buffer.size();
+    }
+
+private:
+    qint64 windowMs;
+    QQueue<std::pair<qint64, double>> buffer;
+};
+
+// Пульсовая волна 72 уд/мин с дрейфом и шумом на заданной частоте дискретизации
+QVector<SensorSample> makeSamples(int count, int rateHz)
+{
+    QVector<SensorSample> samples(count);
+    for (int i = 0; i < count; ++i) {
+        const double t = double(i) / rateHz;
+        const double pulse = std::sin(2 * M_PI * 1.2 * t);
+        samples[i] = { qint64(i) * 1000 / rateHz, 100000 + 2000 * pulse + 500 * std::sin(t * 0.7) + 30 * std::sin(i * 1.7),
+                       60000 + 700 * pulse + 200 * std::sin(t * 0.7) + 20 * std::sin(i * 2.3), 36.6 };
+    }
+    return samples;
+}
+
+// Фильтр обрабатывает блоки по 256 отсчётов, как при приёме из сокета
+template<typename Process>
+void filterBlocks(const QVector<SensorSample>& samples, QVector<double>& out, Process&& process)
+{
+    constexpr int blockSize = 256;
+    for (int offset = 0; offset < samples.size(); offset += blockSize)
+        process(samples.constData() + offset, std::min(blockSize, int(samples.size()) - offset), out.data() + 2 * offset);
+}
+
+void runFilterBenchmarks(QTextStream& out)
+{
+    constexpr int count = 200000;
+    BandPassFilter::Settings settings;
+    settings.enabled = true;
+
+    out << "== Band-pass filter, IR + Red (" << count << " samples, 0.5-5 Hz, order " << settings.order << ") ==\n";
+    for (const int rateHz : { 100, 400, 3200 }) {
+        const QVector<SensorSample> samples = makeSamples(count, rateHz);
+        QVector<double> scalarOut(2 * count);
+        QVector<double> vectorOut(2 * count);
+        const QString suffix = QString(" %1 Hz").arg(rateHz);
+
+        printBenchResult(out, runBench("scalar:" + suffix, count, 5, [&]() {
+            BandPassFilter filter;
+            filter.design(settings, rateHz);
+            filter.prime(samples[0].irValue, samples[0].redValue);
+            filterBlocks(samples, scalarOut, [&filter](const SensorSample* s, int n, double* o) {
+                filter.processScalar(s, n, o);
+            });
+            benchKeep(scalarOut.last());
+        }));
+        printBenchResult(out, runBench("SSE2 (IR/Red lanes):" + suffix, count, 5, [&]() {
+            BandPassFilter filter;
+            filter.design(settings, rateHz);
+            filter.prime(samples[0].irValue, samples[0].redValue);
+            filterBlocks(samples, vectorOut, [&filter](const SensorSample* s, int n, double* o) {
+                filter.process(s, n, o);
+            });
+            benchKeep(vectorOut.last());
+        }));
+        if (scalarOut != vectorOut)
+            out << "WARNING: SSE2 and scalar outputs differ\n";
+    }
+    out << "\n";
+}
+
+// Острый пульсовой импульс (с гармониками) на заданной частоте пульса, дрейф и шум
+QVector<SensorSample> makePulse(int count, int rateHz, double bpm)
+{
+    QVector<SensorSample> samples(count);
+    const double beatHz = bpm / 60.0;
+    for (int i = 0; i < count; ++i) {
+        const double t = double(i) / rateHz;
+        const double phase = beatHz * t - std::floor(beatHz * t);
+        const double pulse = std::exp(-phase * 8.0) - 0.3;
+        samples[i] = { qint64(i) * 1000 / rateHz, 100000 + 2000 * pulse + 500 * std::sin(t * 0.7) + 30 * std::sin(i * 1.7),
+                       60000, 36.6 };
+    }
+    return samples;
+}
+
+void runSpectralBenchmarks(QTextStream& out)
+{
+    constexpr int seconds = 120;
+    out << "== Spectral heart rate (" << seconds << " s per run, 10 s window) ==\n";
+    for (const int rateHz : { 100, 400 }) {
+        const int count = seconds * rateHz;
+        // Точность по всей полосе: медленный и быстрый пульс, где гармоники сильнее основной
+        double worstError = 0.0;
+        for (const double bpm : { 40.0, 55.0, 72.0, 90.0, 130.0, 180.0 }) {
+            const QVector<SensorSample> samples = makePulse(count, rateHz, bpm);
+            SpectralHeartRate estimator;
+            for (const SensorSample& s : samples)
+                estimator.add(s.timestamp, s.irValue);
+            worstError = qMax(worstError, std::abs(estimator.bpm() - bpm));
+        }
+
+        const QVector<SensorSample> samples = makePulse(count, rateHz, 72.0);
+        printBenchResult(out, runBench(QString("sliding DFT: %1 Hz").arg(rateHz), count, 5, [&]() {
+            SpectralHeartRate estimator;
+            int estimates = 0;
+            for (const SensorSample& s : samples)
+                estimates += estimator.add(s.timestamp, s.irValue);
+            benchKeep(estimates);
+        }));
+        out << "worst error 40-180 BPM: " << QString::number(worstError, 'f', 2) << " BPM\n";
+    }
+    out << "\n";
+}
+
+void runRollingStatisticsBenchmarks(QTextStream& out)
+{
+    // 10 значений в секунду: в скользящем окне 1 ч их 36000
+    constexpr int count = 200000;
+    constexpr int rateHz = 10;
+    QVector<double> values(count);
+    for (int i = 0; i < count; ++i)
+        values[i] = 72 + 10 * std::sin(i * 0.01) + 3 * std::sin(i * 1.7);
+
+    out << "== Rolling statistics (" << count << " values at " << rateHz << " Hz) ==\n";
+    printBenchResult(out, runBench("10 s / 1 min / 5 min / 1 h windows:", count, 3, [&]() {
+        RollingStatistics statistics;
+        for (int i = 0; i < count; ++i)
+            statistics.add(qint64(i) * 1000 / rateHz, values[i]);
+        benchKeep(statistics.sliding(statistics.resolutionCount() - 1).median);
+    }));
+    out << "\n";
+}
+
+} // namespace
+
+void runDspBenchmarks(QTextStream& out)
+{
+    constexpr int rateHz = 400;
+    constexpr int count = 200000;
+    QVector<double> values(count);
+    for (int i = 0; i < count; ++i)
+        values[i] = 100000 + std::round(2000 * std::sin(i * 0.02) + 30 * std::sin(i * 1.7));
+    auto timestampOf = [](int i) { return qint64(i) * 1000 / rateHz; };
+
+    out << "== DC window mean (" << count << " samples at " << rateHz << " Hz) ==\n";
+    for (const int windowMs : { 1000, 4000, 16000, 64000 }) {
+        const QString suffix = QString(" %1 s window").arg(windowMs / 1000);
+
+        double legacyLast = 0.0;
+        printBenchResult(out, runBench("QQueue re-sum:" + suffix, count, 3, [&]() {
+            LegacyWindowMean legacy(windowMs);
+            for (int i = 0; i < count; ++i)
+                legacyLast = legacy.add(timestampOf(i), values[i]);
+            benchKeep(legacyLast);
+        }));
+
+        double slidingLast = 0.0;
+        printBenchResult(out, runBench("SlidingWindowMean:" + suffix, count, 3, [&]() {
+            SlidingWindowMean sliding(windowMs);
+            for (int i = 0; i < count; ++i) {
+                sliding.add(timestampOf(i), values[i]);
+                slidingLast = sliding.mean();
+            }
+            benchKeep(slidingLast);
+        }));
+
+        if (std::abs(legacyLast - slidingLast) > 1e-9 * std::abs(legacyLast))
+            out << "WARNING: mean mismatch " << legacyLast << " vs " << slidingLast << "\n";
+    }
+    out << "\n";
+
+    runFilterBenchmarks(out);
+    runSpectralBenchmarks(out);
+    runRollingStatisticsBenchmarks(out);
+}
@@ -0,0 +1,159 @@
+#include "benchFixtures.h"
+#include "benchHarness.h"
+#include "columnFile.h"
+#include "exportdatatofiles.h"
+#include "signalProcessor.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QVector>
+
+namespace {
+
+constexpr int rateHz = 100;
+
+// Сессия hours часов: один час синтетического сигнала, повторённый со сдвигом меток времени
+struct ExportSession {
+    explicit ExportSession(int hours)
+    {
+        const QVector<SensorSample> hour = makePpg(3600 * rateHz, rateHz);
+        QVector<SensorSample> block;
+        QVector<PipelineEvent> events;
+        PipelineEventCollector collector(events);
+        SignalProcessor processor;
+        processor.setObserver(&collector);
+        for (int h = 0; h < hours; ++h) {
+            for (int i = 0; i < hour.size(); i += 4096) {
+                block = hour.mid(i, 4096);
+                for (SensorSample& s : block)
+                    s.timestamp += qint64(h) * 3600000;
+                events.resize(0);
+                processor.processBatch(block.constData(), block.size());
+                history.apply(events.constData(), events.size());
+                for (const PipelineEvent& event : std::as_const(events)) {
+                    if (event.type == PipelineEvent::Bpm)
+                        statistics.addBpm(event.timestamp, event.value);
+                }
+            }
+        }
+    }
+
+    SessionHistory history;
+    BpmStatistics statistics { 0 };
+};
+
+// Перезапуск ESP32 посреди блока и на границе блока: файл должен читаться, а диапазон,
+// повторяющийся после сброса, — отдаваться из обоих участков с исходными значениями
+bool checkTimestampReset(const QString& path)
+{
+    const int chunkRows = 1000;
+    const qint64 startEpochMs = 1714564800000; // 2024-05-01 12:00:00 UTC
+    QVector<qint64> timestamps;
+    for (int i = 0; i < 2500; ++i)
+        timestamps.append(5000000 + qint64(i) * 10);
+    for (int i = 0; i < 1000; ++i) // сброс на 2500-й строке — посреди третьего блока
+        timestamps.append(1000 + qint64(i) * 10);
+    for (int i = 0; i < 1000; ++i) // второй сброс сразу после полного блока — на его границе
+        timestamps.append(1000 + qint64(i) * 10);
+
+    ColumnFileWriter writer;
+    if (!writer.open(path, { { "IR", ColumnFileFormat::UInt32, 1.0 } }, timestamps.first(), startEpochMs,
+                     ColumnFileFormat::DeviceTime, chunkRows))
+        return false;
+    for (int i = 0; i < timestamps.size(); ++i) {
+        const double value = i;
+        writer.append(timestamps[i], &value);
+    }
+    if (!writer.close() || writer.segmentCount() != 3)
+        return false;
+
+    ColumnFileReader reader;
+    if (!reader.open(path) || reader.segmentCount() != 3 || reader.rowCount() != timestamps.size()
+        || reader.startEpochMs() != startEpochMs || reader.timeBase() != ColumnFileFormat::DeviceTime)
+        return false;
+    // Все строки файла по порядку
+    int row = 0;
+    for (const ColumnFileReader::Slice& slice : reader.slices(0, timestamps.first() + 100000)) {
+        const ColumnSpan<quint32> ir = slice.column<quint32>(0);
+        for (int i = 0; i < slice.timestamps.size(); ++i, ++row) {
+            if (row >= timestamps.size() || slice.timestamps[i] != timestamps[row] || ir[i] != quint32(row))
+                return false;
+        }
+    }
+    if (row != timestamps.size())
+        return false;
+    // 1000..1990 мс есть в двух участках после сброса, 100 строк в каждом
+    qint64 rangeRows = 0;
+    for (const ColumnFileReader::Slice& slice : reader.slices(1000, 1990))
+        rangeRows += slice.timestamps.size();
+    return rangeRows == 200;
+}
+
+qint64 directoryBytes(const QString& path)
+{
+    qint64 bytes = 0;
+    for (const QFileInfo& info : QDir(path).entryInfoList(QDir::Files))
+        bytes += info.size();
+    return bytes;
+}
+
+} // namespace
+
+// Экспорт пишет на диск во временный каталог; 24 ч — только с --long (сотни МиБ и десятки секунд)
+void runExportBenchmarks(QTextStream& out, bool longSessions)
+{
+    QVector<int> durations { 1 };
+    if (longSessions)
+        durations.append(24);
+
+    for (int hours : std::as_const(durations)) {
+        const ExportSession session(hours);
+        const qint64 rows = session.history.samples().size();
+        const QVector<MinuteBPMData> minutes = session.statistics.minuteRecords();
+        out << "== Export (" << hours << " h at " << rateHz << " Hz, " << rows << " samples) ==\n";
+
+        QTemporaryDir dir;
+        if (!dir.isValid()) {
+            out << "cannot create a temporary directory\n\n";
+            return;
+        }
+        const int repeats = hours > 1 ? 1 : 3;
+        bool ok = true;
+        printBenchResult(out, runBench(QString("text: %1 h").arg(hours), rows, repeats, [&]() {
+            ok &= ExportDataToFiles::exportAllDataToText(session.history, minutes, "bench", dir.filePath("text"));
+        }));
+        printBenchResult(out, runBench(QString("binary: %1 h").arg(hours), rows, repeats, [&]() {
+            ok &= ExportDataToFiles::exportAllDataToBinary(session.history, "bench", dir.filePath("binary"));
+        }));
+
+        // Чтение .espc: открытие (заголовок и индекс) и минута отсчётов из середины сессии через mmap
+        const QString samplesPath = dir.filePath("binary/bench_samples.espc");
+        ColumnFileReader reader;
+        printBenchResult(out, runBench(QString("binary open: %1 h").arg(hours), 1, 20, [&]() {
+            ok &= reader.open(samplesPath);
+        }));
+        const qint64 middle = (reader.firstTimestamp() + reader.lastTimestamp()) / 2;
+        qint64 rangeRows = 0;
+        for (const ColumnFileReader::Slice& slice : reader.slices(middle, middle + 60000))
+            rangeRows += slice.timestamps.size();
+        printBenchResult(out, runBench(QString("binary 1 min range: %1 h").arg(hours), rangeRows, 20, [&]() {
+            quint64 sum = 0;
+            for (const ColumnFileReader::Slice& slice : reader.slices(middle, middle + 60000)) {
+                for (quint32 ir : slice.column<quint32>(0))
+                    sum += ir;
+            }
+            benchKeep(sum);
+        }));
+        ok &= reader.rowCount() == rows;
+        reader.close();
+
+        out << "files: text " << QString::number(directoryBytes(dir.filePath("text")) / 1048576.0, 'f', 1)
+            << " MiB, binary " << QString::number(directoryBytes(dir.filePath("binary")) / 1048576.0, 'f', 1)
+            << " MiB" << (ok ? "" : ", WRITE FAILED") << "\n\n";
+    }
+
+    QTemporaryDir dir;
+    out << "binary timestamp reset: "
+        << (dir.isValid() && checkTimestampReset(dir.filePath("reset.espc")) ? "round trip OK" : "FAILED") << "\n\n";
+}
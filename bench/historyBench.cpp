@@ -0,0 +1,231 @@
+#include "benchHarness.h"
+#include "minMaxPyramid.h"
+#include "sampleStore.h"
+
+#include <QPointF>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Прежнее хранение в SessionHistory: три QVector<QPointF> (IR, Red, Temp), время — секунды в double
+struct LegacySampleHistory {
+    QVector<QPointF> ir;
+    QVector<QPointF> red;
+    QVector<QPointF> temp;
+    int reallocations = 0;
+    qint64 largestReallocationBytes = 0;
+
+    void append(double t, double irValue, double redValue, double tempValue)
+    {
+        const qsizetype capacity = ir.capacity();
+        ir.append(QPointF(t, irValue));
+        red.append(QPointF(t, redValue));
+        temp.append(QPointF(t, tempValue));
+        if (ir.capacity() != capacity) {
+            reallocations += 3;
+            largestReallocationBytes = qMax<qint64>(largestReallocationBytes, ir.capacity() * qint64(sizeof(QPointF)));
+        }
+    }
+
+    quint64 memoryBytes() const
+    {
+        return quint64(ir.capacity() + red.capacity() + temp.capacity()) * sizeof(QPointF);
+    }
+};
+
+struct Sample {
+    qint64 timestamp;
+    double ir, red, temp;
+};
+
+Sample sampleAt(int i, int rateHz)
+{
+    return { 1000000 + qint64(i) * 1000 / rateHz, std::round(100000 + 2000 * std::sin(i * 0.075)),
+             std::round(60000 + 700 * std::sin(i * 0.075 + 0.3)), 36.5 + (i % 10) * 0.01 };
+}
+
+QString megabytes(double bytes)
+{
+    return QString::number(bytes / 1048576.0, 'f', 1) + " MiB";
+}
+
+} // namespace
+
+void runHistoryBenchmarks(QTextStream& out)
+{
+    constexpr int rateHz = 100;
+    constexpr int count = 3600 * rateHz; // час записи
+    constexpr double samplesPerDay = 24.0 * 3600 * rateHz;
+
+    out << "== Session history, IR/Red/Temp (" << count << " samples = 1 h at " << rateHz << " Hz) ==\n";
+
+    LegacySampleHistory legacy;
+    printBenchResult(out, runBench("append: 3 x QVector<QPointF> (before)", count, 3, [&]() {
+        legacy = LegacySampleHistory();
+        for (int i = 0; i < count; ++i) {
+            const Sample s = sampleAt(i, rateHz);
+            legacy.append((s.timestamp - 1000000) / 1000.0, s.ir, s.red, s.temp);
+        }
+        benchKeep(legacy.ir.size());
+    }));
+
+    SampleStore store;
+    printBenchResult(out, runBench("append: SampleStore (after)", count, 3, [&]() {
+        store.clear();
+        for (int i = 0; i < count; ++i) {
+            const Sample s = sampleAt(i, rateHz);
+            store.append(s.timestamp, s.timestamp, s.ir, s.red, s.temp);
+        }
+        benchKeep(store.size());
+    }));
+
+    // Отсчёты должны возвращаться без потерь: время и IR/Red точно, температура — до 0.01 °C
+    bool exact = store.size() == count;
+    int index = 0;
+    store.forEach([&](const SampleStore::Row& row) {
+        const Sample s = sampleAt(index++, rateHz);
+        exact = exact && row.timestamp == s.timestamp && row.ir == s.ir && row.red == s.red
+                && std::abs(row.temp - s.temp) < 0.005;
+    });
+    exact = exact && store.at(count / 2).timestamp == sampleAt(count / 2, rateHz).timestamp;
+    out << "round trip: " << (exact ? "OK" : "FAILED") << "\n";
+
+    // Перезапуск ESP32 посреди блока: время датчика идёт назад, время сессии продолжается
+    // с последнего значения (как в SessionHistory); поиск по времени сессии совпадает с перебором
+    SampleStore restarted;
+    QVector<qint64> times;
+    qint64 shift = 0;
+    qint64 lastTime = 0;
+    for (int i = 0; i < 3 * SampleStore::chunkSize; ++i) {
+        const qint64 timestamp = i < 5000 ? sampleAt(i, rateHz).timestamp : 2000 + (i - 5000) * 10;
+        if (i > 0 && timestamp + shift < lastTime)
+            shift = lastTime - timestamp;
+        lastTime = timestamp + shift;
+        restarted.append(timestamp, lastTime, 1000 + i, 2000 + i, 36.6);
+        times.append(lastTime);
+    }
+    bool restartOk = true;
+    for (qint64 query = times.first() - 5; query <= times.last() + 5; query += 7) {
+        const qint64 expected = std::lower_bound(times.begin(), times.end(), query) - times.begin();
+        restartOk = restartOk && restarted.lowerBound(query) == expected;
+    }
+    for (int i = 0; i < times.size(); i += 97) {
+        const SampleStore::Row row = restarted.at(i);
+        const qint64 timestamp = i < 5000 ? sampleAt(i, rateHz).timestamp : 2000 + (i - 5000) * 10;
+        restartOk = restartOk && row.timestamp == timestamp && row.time == times[i] && row.ir == 1000 + i;
+    }
+    out << "device restart: " << (restartOk ? "OK" : "FAILED") << "\n";
+
+    const double legacyPerSample = double(legacy.memoryBytes()) / count;
+    out << "before: " << QString::number(legacyPerSample, 'f', 1) << " bytes/sample, "
+        << legacy.reallocations << " reallocations (largest " << megabytes(legacy.largestReallocationBytes)
+        << "), 24 h ~" << megabytes(legacyPerSample * samplesPerDay) << "\n";
+    out << "after:  " << QString::number(store.bytesPerSample(), 'f', 1) << " bytes/sample, "
+        << "no reallocation of stored chunks, 24 h ~" << megabytes(store.bytesPerSample() * samplesPerDay) << "\n";
+
+    // SpO₂ по AC/DC — почти точка на отсчёт
+    QVector<QPointF> legacySpo2;
+    SeriesStore spo2;
+    for (int i = 0; i < count; ++i) {
+        const double x = (sampleAt(i, rateHz).timestamp - 1000000) / 1000.0;
+        legacySpo2.append(QPointF(x, 95 + i % 4));
+        spo2.append(x, 95 + i % 4);
+    }
+    bool spo2Exact = spo2.size() == count;
+    qint64 spo2Index = 0;
+    spo2.forEach([&](const QPointF& p) {
+        const QPointF& expected = legacySpo2[spo2Index++];
+        spo2Exact = spo2Exact && p.x() == expected.x() && p.y() == expected.y();
+    });
+    spo2Exact = spo2Exact && spo2.lowerBound(legacySpo2[count / 3].x()) == count / 3;
+    out << "SpO2 series: " << QString::number(double(legacySpo2.capacity()) * sizeof(QPointF) / count, 'f', 1)
+        << " -> " << QString::number(double(spo2.memoryBytes()) / count, 'f', 1) << " bytes/point, round trip "
+        << (spo2Exact ? "OK" : "FAILED") << "\n\n";
+}
+
+void runPyramidBenchmarks(QTextStream& out)
+{
+    constexpr int rateHz = 100;
+    constexpr int count = 8 * 3600 * rateHz; // восемь часов записи
+    constexpr int columns = 1000;             // ширина графика в пикселях
+    const qint64 origin = sampleAt(0, rateHz).timestamp;
+    const qint64 end = sampleAt(count - 1, rateHz).timestamp;
+
+    out << "== Min/max pyramid (" << count << " samples = 8 h at " << rateHz << " Hz, "
+        << columns << " columns) ==\n";
+
+    SampleStore store;
+    for (int i = 0; i < count; ++i) {
+        const Sample s = sampleAt(i, rateHz);
+        store.append(s.timestamp, s.timestamp, s.ir, s.red, s.temp);
+    }
+    MinMaxPyramid pyramid;
+    printBenchResult(out, runBench("append: pyramid", count, 3, [&]() {
+        pyramid.clear();
+        for (int i = 0; i < count; ++i) {
+            const Sample s = sampleAt(i, rateHz);
+            pyramid.append(s.timestamp, s.ir, s.red, s.temp);
+        }
+        benchKeep(pyramid.levelSize(0));
+    }));
+
+    // Огибающая по сырым отсчётам — то, что пришлось бы делать без пирамиды
+    QVector<QPointF> points;
+    printBenchResult(out, runBench("whole session: raw scan", count, 3, [&]() {
+        QVector<float> low(columns, 1e30f), high(columns, -1e30f);
+        store.forEach([&](const SampleStore::Row& row) {
+            const int column = int(qMin<qint64>(columns - 1, (row.timestamp - origin) * columns / (end - origin)));
+            low[column] = qMin(low[column], float(row.ir));
+            high[column] = qMax(high[column], float(row.ir));
+        });
+        benchKeep(low[0] + high[0]);
+    }));
+    printBenchResult(out, runBench("whole session: pyramid", count, 3, [&]() {
+        pyramid.envelope(store, MinMaxPyramid::Ir, origin, end, columns, origin, points);
+        benchKeep(points.size());
+    }));
+    // Запросы разного масштаба: элементом считаем один отсчёт показанного интервала
+    const qint64 spansMs[] = { 5000, 60000, 3600000 };
+    for (qint64 spanMs : spansMs) {
+        const qint64 from = origin + (end - origin) / 2;
+        printBenchResult(out, runBench(QString("window %1 s: pyramid").arg(spanMs / 1000), spanMs * rateHz / 1000, 5, [&]() {
+            pyramid.envelope(store, MinMaxPyramid::Ir, from, from + spanMs, columns, origin, points);
+            benchKeep(points.size());
+        }));
+    }
+
+    // Кадр живого режима (последние 20 с) при разной частоте отсчётов: элемент — один кадр
+    for (int sampleRateHz : { 100, 400, 3200 }) {
+        SampleStore liveStore;
+        MinMaxPyramid livePyramid;
+        for (int i = 0; i < 3600 * sampleRateHz / 10; ++i) { // шесть минут
+            const Sample s = sampleAt(i, sampleRateHz);
+            liveStore.append(s.timestamp, s.timestamp, s.ir, s.red, s.temp);
+            livePyramid.append(s.timestamp, s.ir, s.red, s.temp);
+        }
+        const qint64 last = liveStore.at(liveStore.size() - 1).timestamp;
+        printBenchResult(out, runBench(QString("live frame at %1 Hz").arg(sampleRateHz), 1, 20, [&]() {
+            livePyramid.envelope(liveStore, MinMaxPyramid::Ir, last - 20000, last, columns, origin, points);
+            benchKeep(points.size());
+        }));
+    }
+
+    // Огибающая не теряет экстремумов: размах по всей сессии совпадает с сырыми данными
+    pyramid.envelope(store, MinMaxPyramid::Ir, origin, end, columns, origin, points);
+    double envelopeLow = points.first().y(), envelopeHigh = envelopeLow;
+    for (const QPointF& p : points) {
+        envelopeLow = qMin(envelopeLow, p.y());
+        envelopeHigh = qMax(envelopeHigh, p.y());
+    }
+    double rawLow = store.at(0).ir, rawHigh = rawLow;
+    store.forEach([&](const SampleStore::Row& row) {
+        rawLow = qMin(rawLow, row.ir);
+        rawHigh = qMax(rawHigh, row.ir);
+    });
+    out << "extremes: " << (envelopeLow == rawLow && envelopeHigh == rawHigh ? "OK" : "FAILED")
+        << ", " << points.size() << " points for the whole session\n";
+    out << "pyramid memory: " << QString::number(double(pyramid.memoryBytes()) / count, 'f', 2)
+        << " bytes/sample on top of " << QString::number(store.bytesPerSample(), 'f', 1) << "\n\n";
+}
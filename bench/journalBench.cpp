@@ -0,0 +1,112 @@
+#include "benchFixtures.h"
+#include "benchHarness.h"
+#include "sessionJournal.h"
+#include "signalProcessor.h"
+
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QVector>
+#include <cmath>
+
+namespace {
+
+constexpr int rateHz = 100;
+constexpr int blockSamples = 5; // 50 мс при 100 Гц — как приходит из сети
+
+// Все события часовой сессии по блокам, как их отдаёт SignalProcessor потоку приёма
+QVector<QVector<PipelineEvent>> makeSessionBlocks()
+{
+    const QVector<SensorSample> samples = makePpg(3600 * rateHz, rateHz);
+    QVector<PipelineEvent> events;
+    PipelineEventCollector collector(events);
+    SignalProcessor processor;
+    processor.setObserver(&collector);
+    QVector<QVector<PipelineEvent>> blocks;
+    for (int i = 0; i < samples.size(); i += blockSamples) {
+        events.resize(0);
+        processor.processBatch(samples.constData() + i, qMin(blockSamples, int(samples.size()) - i));
+        blocks.append(events);
+    }
+    return blocks;
+}
+
+// Запись с ожиданием, когда очередь заполнена наполовину: замеряем диск, а не потери
+QStringList writeJournal(const QVector<QVector<PipelineEvent>>& blocks, const SessionJournal::Settings& settings,
+                         qint64* finalizeNs, quint64* dropped)
+{
+    SessionJournal journal(settings);
+    journal.start();
+    for (const QVector<PipelineEvent>& block : blocks) {
+        while (journal.pendingEvents() > SessionJournal::queueCapacity / 2)
+            QThread::yieldCurrentThread();
+        journal.append(block.constData(), block.size());
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const QStringList segments = journal.finalizeSegments();
+    *finalizeNs = timer.nsecsElapsed();
+    *dropped = journal.droppedEvents();
+    return segments;
+}
+
+bool sameEvent(const PipelineEvent& a, const PipelineEvent& b)
+{
+    if (a.type != b.type || a.timestamp != b.timestamp || std::abs(a.timeSec - b.timeSec) > 1e-9)
+        return false;
+    if (a.type == PipelineEvent::Sample)
+        return std::abs(a.value - b.value) <= 0.5 && std::abs(a.value2 - b.value2) <= 0.5
+               && std::abs(a.value3 - b.value3) <= 0.005;
+    return a.value == b.value && a.value2 == b.value2;
+}
+
+} // namespace
+
+// Непрерывная запись (SessionJournal): поток записи, ротация сегментов, чтение обратно со сверкой
+void runJournalBenchmarks(QTextStream& out)
+{
+    const QVector<QVector<PipelineEvent>> blocks = makeSessionBlocks();
+    QVector<PipelineEvent> expected;
+    for (const QVector<PipelineEvent>& block : blocks)
+        expected += block;
+    out << "== Session journal (1 h at " << rateHz << " Hz, " << expected.size() << " events) ==\n";
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        out << "cannot create a temporary directory\n\n";
+        return;
+    }
+    SessionJournal::Settings settings;
+    settings.directory = dir.path();
+    settings.maxSegmentBytes = 4 << 20; // несколько сегментов — заодно проверка ротации
+
+    int run = 0;
+    qint64 finalizeNs = 0;
+    quint64 dropped = 0;
+    QStringList segments;
+    printBenchResult(out, runBench("write + finalize: 1 h", expected.size(), 3, [&]() {
+        settings.baseName = QString("bench%1").arg(run++);
+        segments = writeJournal(blocks, settings, &finalizeNs, &dropped);
+    }));
+
+    QVector<PipelineEvent> readBack;
+    printBenchResult(out, runBench("read back: 1 h", expected.size(), 3, [&]() {
+        readBack.resize(0);
+        SessionJournalReader reader;
+        PipelineEvent event;
+        for (const QString& segment : std::as_const(segments)) {
+            if (!reader.open(segment))
+                return;
+            while (reader.readNext(event))
+                readBack.append(event);
+            reader.close();
+        }
+    }));
+
+    bool ok = dropped == 0 && readBack.size() == expected.size();
+    for (int i = 0; ok && i < expected.size(); ++i)
+        ok = sameEvent(expected[i], readBack[i]);
+    out << "segments: " << segments.size() << ", finalize (export) "
+        << QString::number(finalizeNs / 1e6, 'f', 2) << " ms, dropped " << dropped << ", read back "
+        << (ok ? "matches" : "MISMATCH") << "\n\n";
+}
@@ -0,0 +1,98 @@
+#include "benchReport.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <algorithm>
+#include <functional>
+
+// Группы бенчмарков
+void runParserBenchmarks(QTextStream& out);
+void runProtocolBenchmarks(QTextStream& out);
+void runReplayBenchmarks(QTextStream& out);
+void runDspBenchmarks(QTextStream& out);
+void runHistoryBenchmarks(QTextStream& out);
+void runPyramidBenchmarks(QTextStream& out);
+void runPipelineStatsBenchmarks(QTextStream& out);
+void runPipelineBenchmarks(QTextStream& out, const QStringList& recordings);
+void runExportBenchmarks(QTextStream& out, bool longSessions);
+void runJournalBenchmarks(QTextStream& out);
+bool runPeakBenchmarks(QTextStream& out, const QStringList& recordings);
+
+// Аргументы — необязательные записи (.esprec или сырые дампы): сверка детекции пиков с эталоном
+// и замер обработки на реальных данных. Код возврата не 0 — сверка не прошла или есть замедление
+// относительно --baseline.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("esp32_bench");
+
+    struct Group {
+        QString name;
+        std::function<bool(QTextStream&)> run; // false — не прошла проверка корректности
+    };
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures parser, DSP, history and export hot paths on synthetic data "
+                                     "and optional recordings.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("recordings", "Recordings (.esprec) or raw stream dumps.", "[recordings...]");
+    const QCommandLineOption groupOption({ "g", "group" }, "Run only these groups (repeat or separate with ','): "
+                                                           "parser, protocol, replay, dsp, history, pyramid, "
+                                                           "stats, pipeline, export, journal, peaks.", "name");
+    const QCommandLineOption jsonOption("json", "Write results as JSON (use as a later --baseline).", "file");
+    const QCommandLineOption baselineOption("baseline", "Compare with results saved by --json.", "file");
+    const QCommandLineOption thresholdOption("threshold", "Slowdown, in percent, reported as a regression.",
+                                             "percent", "10");
+    const QCommandLineOption longOption("long", "Also export a 24 h session.");
+    parser.addOptions({ groupOption, jsonOption, baselineOption, thresholdOption, longOption });
+    parser.process(app);
+
+    const QStringList recordings = parser.positionalArguments();
+    const bool longSessions = parser.isSet(longOption);
+    const auto always = [](void (*run)(QTextStream&)) {
+        return [run](QTextStream& out) { run(out); return true; };
+    };
+    const QVector<Group> groups = {
+        { "parser", always(runParserBenchmarks) },
+        { "protocol", always(runProtocolBenchmarks) },
+        { "replay", always(runReplayBenchmarks) },
+        { "dsp", always(runDspBenchmarks) },
+        { "history", always(runHistoryBenchmarks) },
+        { "pyramid", always(runPyramidBenchmarks) },
+        { "stats", always(runPipelineStatsBenchmarks) },
+        { "pipeline", [&recordings](QTextStream& out) { runPipelineBenchmarks(out, recordings); return true; } },
+        { "export", [longSessions](QTextStream& out) { runExportBenchmarks(out, longSessions); return true; } },
+        { "journal", always(runJournalBenchmarks) },
+        { "peaks", [&recordings](QTextStream& out) { return runPeakBenchmarks(out, recordings); } },
+    };
+
+    QStringList selected;
+    for (const QString& value : parser.values(groupOption))
+        selected += value.split(',', Qt::SkipEmptyParts);
+    for (const QString& name : std::as_const(selected)) {
+        const bool known = std::any_of(groups.begin(), groups.end(), [&name](const Group& g) { return g.name == name; });
+        if (!known) {
+            QTextStream(stderr) << "Unknown benchmark group: " << name << "\n";
+            return 2;
+        }
+    }
+
+    QTextStream out(stdout);
+    bool ok = true;
+    for (const Group& group : groups) {
+        if (!selected.isEmpty() && !selected.contains(group.name))
+            continue;
+        currentBenchGroup() = group.name;
+        ok = group.run(out) && ok;
+        out.flush();
+    }
+
+    if (parser.isSet(jsonOption) && BenchReport::writeJson(parser.value(jsonOption), benchResults()))
+        out << "Results written to " << parser.value(jsonOption) << "\n";
+    if (parser.isSet(baselineOption))
+        ok = BenchReport::compareWithBaseline(out, benchResults(), parser.value(baselineOption),
+                                              parser.value(thresholdOption).toDouble()) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#include "benchHarness.h"
+#include "csvSampleParser.h"
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QStringList>
+#include <QVector>
+#include <cmath>
+
+namespace {
+
+// Синтетический поток в формате ESP32: "timestamp,IR,Red,Temp\n"
+QByteArray makeCsvStream(int lines)
+{
+    QByteArray stream;
+    stream.reserve(lines * 32);
+    for (int i = 0; i < lines; ++i) {
+        const qint64 timestamp = 100000 + i * 10;
+        const int ir = 100000 + static_cast<int>(2000 * std::sin(i * 0.075));
+        const int red = 25000 + static_cast<int>(800 * std::sin(i * 0.075 + 0.3));
+        const double temp = 36.5 + (i % 10) * 0.01;
+        stream += QByteArray::number(timestamp) + ',' + QByteArray::number(ir) + ','
+                + QByteArray::number(red) + ',' + QByteArray::number(temp, 'f', 2) + '\n';
+    }
+    return stream;
+}
+
+// Прежняя реализация DataReceiver::readData() (без qDebug) — точка отсчёта "до"
+double legacyParse(const QByteArray& stream)
+{
+    QBuffer device;
+    device.setData(stream);
+    device.open(QIODevice::ReadOnly);
+    double checksum = 0.0;
+    while (device.canReadLine()) {
+        QString line = device.readLine().trimmed();
+        QStringList parts = line.split(",");
+        if (parts.size() == 4) {
+            bool okTimestamp, ok1, ok2, ok3;
+            qint64 timestamp = parts[0].trimmed().toLongLong(&okTimestamp);
+            double irValue = parts[1].trimmed().toDouble(&ok1);
+            double redValue = parts[2].trimmed().toDouble(&ok2);
+            double tempValue = parts[3].trimmed().toDouble(&ok3);
+            if (okTimestamp && ok1 && ok2 && ok3)
+                checksum += timestamp + irValue + redValue + tempValue;
+        }
+    }
+    return checksum;
+}
+
+// Новый парсер; поток подаётся кусками по размеру TCP-сегмента, чтобы строки рвались между вызовами
+double byteParse(CsvSampleParser& parser, const QByteArray& stream)
+{
+    constexpr qsizetype chunkSize = 1460;
+    double checksum = 0.0;
+    for (qsizetype offset = 0; offset < stream.size(); offset += chunkSize) {
+        const qsizetype n = std::min(chunkSize, stream.size() - offset);
+        parser.feed(stream.constData() + offset, n, [&checksum](const SensorSample& s) {
+            checksum += s.timestamp + s.irValue + s.redValue + s.tempValue;
+        });
+    }
+    return checksum;
+}
+
+} // namespace
+
+void runParserBenchmarks(QTextStream& out)
+{
+    constexpr int lines = 200000;
+    const QByteArray stream = makeCsvStream(lines);
+
+    out << "== CSV parser (" << lines << " lines, " << stream.size() << " bytes) ==\n";
+
+    double legacySum = 0.0;
+    const BenchResult before = runBench("readData: QString split (before)", lines, 5, [&]() {
+        legacySum = legacyParse(stream);
+        benchKeep(legacySum);
+    });
+    printBenchResult(out, before);
+
+    CsvSampleParser parser;
+    double byteSum = 0.0;
+    const BenchResult after = runBench("readData: CsvSampleParser (after)", lines, 5, [&]() {
+        byteSum = byteParse(parser, stream);
+        benchKeep(byteSum);
+    });
+    printBenchResult(out, after);
+
+    if (legacySum != byteSum)
+        out << "WARNING: checksum mismatch " << legacySum << " vs " << byteSum << "\n";
+    out << "speedup: x" << QString::number(after.itemsPerSec() / before.itemsPerSec(), 'f', 1)
+        << ", parse errors: " << parser.errorCount() << "\n\n";
+}
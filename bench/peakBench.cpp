@@ -0,0 +1,192 @@
+#include "benchFixtures.h"
+#include "benchHarness.h"
+#include "signalProcessor.h"
+
+#include <QFileInfo>
+#include <QStringList>
+#include <QVector>
+#include <algorithm>
+
+namespace {
+
+// Прежняя детекция пиков из SignalProcessor::process() (без qDebug) — эталон для сравнения:
+// окно из 5 точек в QVector со сдвигом pop_front() и полный перебор интервала на каждом пике
+class LegacyPeakDetector
+{
+public:
+    void process(const SensorSample& sample, QVector<PipelineEvent>& events)
+    {
+        const qint64 timestamp = sample.timestamp;
+        if (timeStart == 0)
+            timeStart = timestamp;
+
+        peakWindowValues.push_back(sample.irValue);
+        peakWindowTimestamps.push_back(timestamp);
+        intervalIrValues.push_back(sample.irValue);
+        intervalRedValues.push_back(sample.redValue);
+        if (peakWindowValues.size() > windowSize) {
+            peakWindowValues.pop_front();
+            peakWindowTimestamps.pop_front();
+        }
+        if (peakWindowValues.size() != windowSize)
+            return;
+
+        const int mid = windowSize / 2;
+        for (int i = 0; i < windowSize; i++) {
+            if (i != mid && peakWindowValues[mid] <= peakWindowValues[i])
+                return;
+        }
+        const qint64 detectedPeakTime = peakWindowTimestamps[mid];
+        if (lastPeakTime != 0 && (detectedPeakTime - lastPeakTime) <= 300)
+            return;
+
+        const double peakTimeSec = static_cast<double>(detectedPeakTime - timeStart) / 1000.0;
+        events.append({PipelineEvent::Peak, detectedPeakTime, peakTimeSec, peakWindowValues[mid], 0.0, 0.0});
+        if (lastPeakTime != 0) {
+            const int deltaMs = static_cast<int>(detectedPeakTime - lastPeakTime);
+            if (deltaMs > 500 && deltaMs < 1333) {
+                const double bpm = 60000.0 / deltaMs;
+                bpmValues.push_back(bpm);
+                if (bpmValues.size() > 3)
+                    bpmValues.pop_front();
+                double sum = 0;
+                for (double v : bpmValues)
+                    sum += v;
+                events.append({PipelineEvent::Bpm, detectedPeakTime, peakTimeSec, bpm, sum / bpmValues.size(), 0.0});
+            }
+        }
+        if (lastPeakTime != 0 && !intervalIrValues.isEmpty() && !intervalRedValues.isEmpty()) {
+            const double irMax = *std::max_element(intervalIrValues.begin(), intervalIrValues.end());
+            const double irMin = *std::min_element(intervalIrValues.begin(), intervalIrValues.end());
+            const double redMax = *std::max_element(intervalRedValues.begin(), intervalRedValues.end());
+            const double redMin = *std::min_element(intervalRedValues.begin(), intervalRedValues.end());
+            const double irAC = irMax - irMin;
+            const double redAC = redMax - redMin;
+            const double irDC = (irMax + irMin) / 2.0;
+            const double redDC = (redMax + redMin) / 2.0;
+            if (irAC > 0 && redAC > 0 && irDC > 0 && redDC > 0) {
+                const double R = (redAC / redDC) / (irAC / irDC);
+                const int spo2p = qBound(80, static_cast<int>(110 - 25.0 * R), 100);
+                events.append({PipelineEvent::Spo2Peak, detectedPeakTime, peakTimeSec, double(spo2p), 0.0, 0.0});
+            }
+        }
+        intervalIrValues.clear();
+        intervalRedValues.clear();
+        intervalIrValues.push_back(sample.irValue);
+        intervalRedValues.push_back(sample.redValue);
+        lastPeakTime = detectedPeakTime;
+    }
+
+private:
+    static constexpr int windowSize = 5;
+    QVector<double> peakWindowValues;
+    QVector<qint64> peakWindowTimestamps;
+    QVector<double> intervalIrValues;
+    QVector<double> intervalRedValues;
+    QVector<double> bpmValues;
+    qint64 timeStart = 0;
+    qint64 lastPeakTime = 0;
+};
+
+QVector<PipelineEvent> peakEvents(const QVector<PipelineEvent>& events)
+{
+    QVector<PipelineEvent> result;
+    for (const PipelineEvent& e : events) {
+        if (e.type == PipelineEvent::Peak || e.type == PipelineEvent::Bpm || e.type == PipelineEvent::Spo2Peak)
+            result.append(e);
+    }
+    return result;
+}
+
+// Сравнение с эталоном побитно: тип, время и значения каждого события
+bool matchesLegacy(const QVector<SensorSample>& samples, int& peakCount)
+{
+    LegacyPeakDetector legacy;
+    QVector<PipelineEvent> expected;
+    for (const SensorSample& s : samples)
+        legacy.process(s, expected);
+
+    SignalProcessor processor;
+    QVector<PipelineEvent> events;
+    PipelineEventCollector collector(events);
+    processor.setObserver(&collector);
+    processor.processBatch(samples.constData(), samples.size());
+    const QVector<PipelineEvent> actual = peakEvents(events);
+
+    peakCount = int(std::count_if(expected.begin(), expected.end(),
+                                  [](const PipelineEvent& e) { return e.type == PipelineEvent::Peak; }));
+    if (actual.size() != expected.size())
+        return false;
+    for (int i = 0; i < actual.size(); ++i) {
+        const PipelineEvent& a = actual[i];
+        const PipelineEvent& b = expected[i];
+        if (a.type != b.type || a.timestamp != b.timestamp || a.timeSec != b.timeSec
+            || a.value != b.value || a.value2 != b.value2 || a.value3 != b.value3)
+            return false;
+    }
+    return true;
+}
+
+// Число пиков с полосовым фильтром перед детекцией и без него
+int countPeaks(const QVector<SensorSample>& samples, bool bandPass)
+{
+    struct PeakCounter : SignalObserver {
+        int peaks = 0;
+        void onPeak(qint64, double, double) override { ++peaks; }
+    } counter;
+    SignalProcessor processor;
+    BandPassFilter::Settings settings;
+    settings.enabled = bandPass;
+    processor.setPeakFilter(settings);
+    processor.setObserver(&counter);
+    processor.processBatch(samples.constData(), samples.size());
+    return counter.peaks;
+}
+
+} // namespace
+
+// Возвращает false, если новая детекция пиков разошлась с эталоном
+bool runPeakBenchmarks(QTextStream& out, const QStringList& recordings)
+{
+    constexpr int rateHz = 400;
+    constexpr int count = 200000;
+    const QVector<SensorSample> samples = makePpg(count, rateHz);
+
+    out << "== Peak detection (" << count << " samples at " << rateHz << " Hz) ==\n";
+    bool allMatch = true;
+    int peaks = 0;
+    bool match = matchesLegacy(samples, peaks);
+    allMatch = allMatch && match;
+    out << "golden (synthetic): " << (match ? "OK" : "FAILED") << ", " << peaks << " peaks\n";
+    for (const QString& path : recordings) {
+        const QVector<SensorSample> recorded = loadRecording(path);
+        match = !recorded.isEmpty() && matchesLegacy(recorded, peaks);
+        allMatch = allMatch && match;
+        out << "golden (" << QFileInfo(path).fileName() << ", " << recorded.size() << " samples): "
+            << (match ? "OK" : "FAILED") << ", " << peaks << " peaks\n";
+    }
+
+    // 1.2 Гц на 500 с — около 600 настоящих ударов; лишние пики дают шум и дрейф
+    out << "peaks on noisy input: raw IR " << countPeaks(samples, false) << ", band-pass "
+        << countPeaks(samples, true) << " (~" << qRound(count / double(rateHz) * 1.2) << " beats)\n";
+
+    printBenchResult(out, runBench("QVector window + rescans (before)", count, 3, [&]() {
+        LegacyPeakDetector legacy;
+        QVector<PipelineEvent> events;
+        for (const SensorSample& s : samples)
+            legacy.process(s, events);
+        benchKeep(events.size());
+    }));
+    // SignalProcessor целиком (вместе с окнами DC) — верхняя оценка для новой детекции
+    printBenchResult(out, runBench("SignalProcessor, incl. DC (after)", count, 3, [&]() {
+        SignalProcessor processor;
+        QVector<PipelineEvent> events;
+        events.reserve(count * 2);
+        PipelineEventCollector collector(events);
+        processor.setObserver(&collector);
+        processor.processBatch(samples.constData(), samples.size());
+        benchKeep(events.size());
+    }));
+    out << "\n";
+    return allMatch;
+}
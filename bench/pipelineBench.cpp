@@ -0,0 +1,90 @@
+#include "benchFixtures.h"
+#include "benchHarness.h"
+#include "minuteStatistics.h"
+#include "sessionHistory.h"
+#include "signalProcessor.h"
+
+#include <QFileInfo>
+#include <QStringList>
+#include <QVector>
+#include <cmath>
+
+namespace {
+
+// То же, что DataProcessor::processValues без графиков: обработка сигнала, история сессии
+// и статистика BPM (DataProcessor — виджетный класс, в бенчмарк не входит)
+struct SamplePipeline {
+    SamplePipeline() : collector(events) { processor.setObserver(&collector); }
+
+    void process(const SensorSample* samples, int count)
+    {
+        events.resize(0);
+        processor.processBatch(samples, count);
+        history.apply(events.constData(), events.size());
+        for (const PipelineEvent& event : std::as_const(events)) {
+            if (event.type == PipelineEvent::Bpm)
+                statistics.addBpm(event.timestamp, event.value);
+        }
+    }
+
+    SignalProcessor processor;
+    SessionHistory history;
+    BpmStatistics statistics { 0 };
+    QVector<PipelineEvent> events;
+    PipelineEventCollector collector;
+};
+
+void processInBlocks(const QVector<SensorSample>& samples, int blockSize)
+{
+    SamplePipeline pipeline;
+    for (int i = 0; i < samples.size(); i += blockSize)
+        pipeline.process(samples.constData() + i, qMin(blockSize, int(samples.size()) - i));
+    benchKeep(pipeline.history.samples().size());
+}
+
+} // namespace
+
+void runPipelineBenchmarks(QTextStream& out, const QStringList& recordings)
+{
+    constexpr int seconds = 600;
+    out << "== Sample pipeline: processor + history + BPM statistics (" << seconds << " s of data) ==\n";
+    // По одному отсчёту — как processValues(); блоками по 50 мс — как при приёме из сокета
+    for (int rateHz : { 25, 100, 400, 3200 }) {
+        const QVector<SensorSample> samples = makePpg(rateHz * seconds, rateHz);
+        printBenchResult(out, runBench(QString("per sample: %1 Hz").arg(rateHz), samples.size(), 3, [&]() {
+            processInBlocks(samples, 1);
+        }));
+        printBenchResult(out, runBench(QString("50 ms blocks: %1 Hz").arg(rateHz), samples.size(), 3, [&]() {
+            processInBlocks(samples, qMax(1, rateHz / 20));
+        }));
+    }
+
+    // Записи с диска — те же, что для сверки пиков; ключ результата — имя файла
+    for (const QString& path : recordings) {
+        const QVector<SensorSample> recorded = loadRecording(path);
+        if (recorded.isEmpty()) {
+            out << "recording " << path << ": no samples\n";
+            continue;
+        }
+        printBenchResult(out, runBench("recording: " + QFileInfo(path).fileName(), recorded.size(), 3, [&]() {
+            processInBlocks(recorded, 256);
+        }));
+    }
+    out << "\n";
+
+    // BPM раз в секунду, 60–90 уд/мин; миллион значений — почти 12 суток непрерывной записи
+    out << "== BPM statistics at large value counts ==\n";
+    for (int count : { 100000, 1000000 }) {
+        QVector<double> values(count);
+        for (int i = 0; i < count; ++i)
+            values[i] = 75.0 + 15.0 * std::sin(i * 0.01) + (i % 7) * 0.3;
+        printBenchResult(out, runBench(QString("BpmStatistics::addBpm: %1 values").arg(count), count,
+                                       count > 100000 ? 1 : 3, [&]() {
+            BpmStatistics statistics(0);
+            for (int i = 0; i < count; ++i)
+                statistics.addBpm(qint64(i) * 1000, values[i]);
+            benchKeep(statistics.minuteRecords().size());
+        }));
+    }
+    out << "\n";
+}
@@ -0,0 +1,105 @@
+#include "benchHarness.h"
+#include "binaryProtocol.h"
+#include "csvSampleParser.h"
+#include "sampleStreamDecoder.h"
+
+#include <QByteArray>
+#include <QVector>
+#include <cmath>
+
+namespace {
+
+QVector<SensorSample> makeSamples(int count)
+{
+    QVector<SensorSample> samples;
+    samples.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        SensorSample s;
+        s.timestamp = 100000 + i * 10;
+        s.irValue = 100000 + static_cast<int>(2000 * std::sin(i * 0.075));
+        s.redValue = 25000 + static_cast<int>(800 * std::sin(i * 0.075 + 0.3));
+        s.tempValue = 36.5 + (i % 10) * 0.01;
+        samples.append(s);
+    }
+    return samples;
+}
+
+QByteArray encodeCsv(const QVector<SensorSample>& samples)
+{
+    QByteArray stream;
+    for (const SensorSample& s : samples)
+        stream += QByteArray::number(s.timestamp) + ',' + QByteArray::number(s.irValue, 'f', 0) + ','
+                + QByteArray::number(s.redValue, 'f', 0) + ',' + QByteArray::number(s.tempValue, 'f', 2) + '\n';
+    return stream;
+}
+
+QByteArray encodeBinary(const QVector<SensorSample>& samples, int samplesPerFrame)
+{
+    QByteArray stream;
+    quint32 sequence = 0;
+    for (int i = 0; i < samples.size(); i += samplesPerFrame) {
+        const int n = std::min(samplesPerFrame, int(samples.size()) - i);
+        BinaryProtocol::encodeFrame(sequence++, samples.constData() + i, n, stream);
+    }
+    return stream;
+}
+
+template<typename Decoder>
+double decodeChunked(Decoder& decoder, const QByteArray& stream)
+{
+    constexpr qsizetype chunkSize = 1460;
+    double checksum = 0.0;
+    for (qsizetype offset = 0; offset < stream.size(); offset += chunkSize) {
+        const qsizetype n = std::min(chunkSize, stream.size() - offset);
+        decoder.feed(stream.constData() + offset, n, [&checksum](const SensorSample& s) {
+            checksum += s.timestamp + s.irValue + s.redValue + s.tempValue;
+        });
+    }
+    return checksum;
+}
+
+// Декодер должен вернуть ровно то, что закодировано (температура — с точностью до 0.01 °C)
+bool verifyRoundTrip(const QVector<SensorSample>& samples, const QByteArray& stream)
+{
+    SampleStreamDecoder decoder;
+    QVector<SensorSample> decoded;
+    decoder.feed(stream.constData(), stream.size(), decoded);
+    if (decoder.protocol() != SampleStreamDecoder::Protocol::Binary || decoded.size() != samples.size())
+        return false;
+    for (int i = 0; i < samples.size(); ++i) {
+        const SensorSample& a = samples[i];
+        const SensorSample& b = decoded[i];
+        if (a.timestamp != b.timestamp || a.irValue != b.irValue || a.redValue != b.redValue
+            || std::abs(a.tempValue - b.tempValue) > 0.005)
+            return false;
+    }
+    return decoder.errorCount() == 0;
+}
+
+} // namespace
+
+void runProtocolBenchmarks(QTextStream& out)
+{
+    constexpr int count = 200000;
+    constexpr int samplesPerFrame = 25; // 250 мс при 100 Гц
+    const QVector<SensorSample> samples = makeSamples(count);
+    const QByteArray csvStream = encodeCsv(samples);
+    const QByteArray binStream = encodeBinary(samples, samplesPerFrame);
+
+    out << "== Wire protocol (" << count << " samples) ==\n";
+    out << "CSV:    " << QString::number(double(csvStream.size()) / count, 'f', 2) << " bytes/sample\n";
+    out << "binary: " << QString::number(double(binStream.size()) / count, 'f', 2) << " bytes/sample ("
+        << samplesPerFrame << " samples/frame)\n";
+    out << "round trip: " << (verifyRoundTrip(samples, binStream) ? "OK" : "FAILED") << "\n";
+
+    CsvSampleParser csv;
+    printBenchResult(out, runBench("decode: CSV", count, 5, [&]() {
+        benchKeep(decodeChunked(csv, csvStream));
+    }));
+    BinaryFrameDecoder binary;
+    printBenchResult(out, runBench("decode: binary frames", count, 5, [&]() {
+        binary.reset();
+        benchKeep(decodeChunked(binary, binStream));
+    }));
+    out << "\n";
+}
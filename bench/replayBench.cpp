@@ -0,0 +1,96 @@
+#include "benchHarness.h"
+#include "csvSampleParser.h"
+#include "sampleStreamDecoder.h"
+#include "streamRecording.h"
+
+#include <QByteArray>
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <cmath>
+
+namespace {
+
+QByteArray makeCsvStream(int lines)
+{
+    QByteArray stream;
+    for (int i = 0; i < lines; ++i) {
+        const int ir = 100000 + static_cast<int>(2000 * std::sin(i * 0.075));
+        const int red = 25000 + static_cast<int>(800 * std::sin(i * 0.075 + 0.3));
+        stream += QByteArray::number(100000 + i * 10) + ',' + QByteArray::number(ir) + ','
+                + QByteArray::number(red) + ',' + QByteArray::number(36.5 + (i % 10) * 0.01, 'f', 2) + '\n';
+    }
+    return stream;
+}
+
+// Сумма по всем полям всех отсчётов — совпадение означает тот же поток отсчётов
+struct DecodeResult {
+    quint64 samples = 0;
+    double checksum = 0.0;
+};
+
+template<typename Decoder>
+void accumulate(Decoder& decoder, const char* data, qsizetype size, DecodeResult& result)
+{
+    decoder.feed(data, size, [&result](const SensorSample& s) {
+        ++result.samples;
+        result.checksum += s.timestamp + s.irValue * 3 + s.redValue * 7 + s.tempValue * 11;
+    });
+}
+
+DecodeResult replayFile(const QString& path)
+{
+    DecodeResult result;
+    SampleStreamDecoder decoder;
+    StreamRecordingReader reader;
+    if (!reader.open(path))
+        return result;
+    StreamRecording::Chunk chunk;
+    while (reader.readNext(chunk)) {
+        if (chunk.type == StreamRecording::Chunk::StreamReset)
+            decoder.reset();
+        else
+            accumulate(decoder, chunk.data.constData(), chunk.data.size(), result);
+    }
+    return result;
+}
+
+} // namespace
+
+void runReplayBenchmarks(QTextStream& out)
+{
+    constexpr int lines = 200000;
+    constexpr qsizetype chunkSize = 1460;
+    const QByteArray stream = makeCsvStream(lines);
+
+    QTemporaryDir dir;
+    const QString path = QDir(dir.path()).filePath("bench.esprec");
+    {
+        // Поток режется на блоки неровного размера, как при приёме из сокета
+        StreamRecorder recorder;
+        if (!recorder.open(path)) {
+            out << "== Replay: cannot create " << path << " ==\n\n";
+            return;
+        }
+        recorder.recordStreamReset();
+        for (qsizetype offset = 0, n = chunkSize; offset < stream.size(); offset += n, n = chunkSize - (offset % 97))
+            recorder.recordData(stream.constData() + offset, std::min(n, stream.size() - offset));
+    }
+
+    out << "== Replay (" << lines << " samples, " << QFileInfo(path).size() << " bytes on disk) ==\n";
+
+    DecodeResult direct;
+    CsvSampleParser parser;
+    accumulate(parser, stream.constData(), stream.size(), direct);
+
+    DecodeResult replayed;
+    const BenchResult result = runBench("replay: read + decode", lines, 5, [&]() {
+        replayed = replayFile(path);
+        benchKeep(replayed.checksum);
+    });
+    printBenchResult(out, result);
+
+    const bool identical = replayed.samples == direct.samples && replayed.checksum == direct.checksum;
+    out << "deterministic: " << (identical ? "OK" : "FAILED") << ", 24 h at 100 Hz replays in ~"
+        << QString::number(24 * 3600 * 100.0 / result.itemsPerSec(), 'f', 1) << " s\n\n";
+}
@@ -0,0 +1,56 @@
+#include "benchHarness.h"
+#include "pipelineStats.h"
+#include "traceSpans.h"
+
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+
+// Стоимость замеров конвейера: их платит каждый блок данных в потоке обработки
+void runPipelineStatsBenchmarks(QTextStream& out)
+{
+    out << "== Pipeline stats ==\n";
+    constexpr int count = 1000000;
+
+    // Логнормальные задержки от единиц мкс до десятков мс
+    QVector<qint64> latencies(count);
+    for (int i = 0; i < count; ++i)
+        latencies[i] = qint64(std::exp(9.0 + 2.0 * std::sin(i * 0.61803) * std::cos(i * 0.1373)));
+
+    LatencyHistogram histogram;
+    printBenchResult(out, runBench("LatencyHistogram::record", count, 5, [&]() {
+        histogram.reset();
+        for (qint64 ns : std::as_const(latencies))
+            histogram.record(ns);
+        benchKeep(histogram.count());
+    }));
+    printBenchResult(out, runBench("monotonicNs", count, 5, [&]() {
+        qint64 last = 0;
+        for (int i = 0; i < count; ++i)
+            last += monotonicNs() & 1;
+        benchKeep(last);
+    }));
+    // Интервал трассировки: выключенный — одна проверка флага, включённый — два чтения часов и запись в кольцо
+    const bool wasEnabled = Trace::enabled();
+    for (bool enabled : { false, true }) {
+        Trace::setEnabled(enabled);
+        printBenchResult(out, runBench(enabled ? "TRACE_SPAN (recording)" : "TRACE_SPAN (disabled)", count, 5, [&]() {
+            for (int i = 0; i < count; ++i) {
+                TRACE_SPAN("bench");
+                benchKeep(i);
+            }
+        }));
+    }
+    Trace::setEnabled(wasEnabled);
+
+    // Квантили гистограммы против точных по отсортированным значениям
+    QVector<qint64> sorted = latencies;
+    std::sort(sorted.begin(), sorted.end());
+    double worstError = 0.0;
+    for (double p : { 0.5, 0.9, 0.99, 0.999 }) {
+        const qint64 exact = sorted[qMin(count - 1, int(std::ceil(p * count)) - 1)];
+        worstError = qMax(worstError, std::abs(double(histogram.percentile(p)) / exact - 1.0));
+    }
+    out << "percentile error: " << QString::number(worstError * 100.0, 'f', 1)
+        << " % (bucket width 12.5 %)\n\n";
+}
@@ -0,0 +1,136 @@
+#include "binaryProtocol.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr std::array<quint32, 256> makeCrcTable()
+{
+    std::array<quint32, 256> table {};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 c = i;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        table[i] = c;
+    }
+    return table;
+}
+
+constexpr std::array<quint32, 256> crcTable = makeCrcTable();
+
+} // namespace
+
+namespace BinaryProtocol {
+
+quint32 crc32(const char* data, qsizetype size)
+{
+    quint32 crc = 0xFFFFFFFFu;
+    for (qsizetype i = 0; i < size; ++i)
+        crc = crcTable[(crc ^ quint8(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+const char* findFrame(const char* data, qsizetype size)
+{
+    const char* const end = data + size;
+    const char* frame = data;
+    while (end - frame >= frameSize(0)) {
+        frame = static_cast<const char*>(std::memchr(frame, magicBytes[0], size_t(end - frame)));
+        if (!frame || end - frame < frameSize(0))
+            return nullptr;
+        const int sampleCount = qFromLittleEndian<quint16>(frame + 6);
+        if (std::memcmp(frame, magicBytes, 4) == 0 && quint8(frame[4]) == version
+            && sampleCount <= maxSamplesPerFrame && end - frame >= frameSize(sampleCount)) {
+            const qsizetype crcOffset = headerSize + sampleCount * sampleSize;
+            if (crc32(frame, crcOffset) == qFromLittleEndian<quint32>(frame + crcOffset))
+                return frame;
+        }
+        ++frame;
+    }
+    return nullptr;
+}
+
+void encodeFrame(quint32 sequence, const SensorSample* samples, int count, QByteArray& out)
+{
+    count = qBound(0, count, maxSamplesPerFrame);
+    const qsizetype start = out.size();
+    out.resize(start + frameSize(count));
+    char* frame = out.data() + start;
+
+    for (int i = 0; i < 4; ++i)
+        frame[i] = char(magicBytes[i]);
+    frame[4] = char(version);
+    frame[5] = 0; // flags
+    qToLittleEndian<quint16>(quint16(count), frame + 6);
+    qToLittleEndian<quint32>(sequence, frame + 8);
+
+    char* record = frame + headerSize;
+    for (int i = 0; i < count; ++i, record += sampleSize) {
+        const SensorSample& s = samples[i];
+        const quint32 ir = quint32(qBound(0.0, s.irValue, double(sensorValueMask)));
+        const quint32 red = quint32(qBound(0.0, s.redValue, double(sensorValueMask)));
+        const qint16 temp = qint16(qBound(-32768.0, std::round(s.tempValue * 100.0), 32767.0));
+        qToLittleEndian<quint32>(quint32(s.timestamp), record);
+        qToLittleEndian<quint32>(ir, record + 4);
+        qToLittleEndian<quint32>(red, record + 8);
+        qToLittleEndian<qint16>(temp, record + 12);
+    }
+
+    const qsizetype crcOffset = headerSize + count * sampleSize;
+    qToLittleEndian<quint32>(crc32(frame, crcOffset), frame + crcOffset);
+}
+
+} // namespace BinaryProtocol
+
+BinaryFrameDecoder::BinaryFrameDecoder()
+{
+    pending.reserve(BinaryProtocol::frameSize(BinaryProtocol::maxSamplesPerFrame));
+}
+
+int BinaryFrameDecoder::feed(const char* data, qsizetype size, QVector<SensorSample>& out)
+{
+    return feed(data, size, [&out](const SensorSample& sample) { out.append(sample); });
+}
+
+void BinaryFrameDecoder::reset()
+{
+    pending.resize(0);
+    hasSequence = false;
+    hasTimestamp = false;
+    timestampEpoch = 0;
+}
+
+BinaryFrameDecoder::FrameStatus BinaryFrameDecoder::checkFrame(const char* frame, qsizetype available, int& sampleCount)
+{
+    if (available < BinaryProtocol::headerSize)
+        return FrameStatus::NeedMoreData;
+
+    sampleCount = qFromLittleEndian<quint16>(frame + 6);
+    if (quint8(frame[4]) != BinaryProtocol::version || sampleCount > BinaryProtocol::maxSamplesPerFrame) {
+        ++stats.headerErrors;
+        return FrameStatus::Invalid;
+    }
+
+    const int size = BinaryProtocol::frameSize(sampleCount);
+    if (available < size)
+        return FrameStatus::NeedMoreData;
+
+    const qsizetype crcOffset = size - BinaryProtocol::crcSize;
+    if (BinaryProtocol::crc32(frame, crcOffset) != qFromLittleEndian<quint32>(frame + crcOffset)) {
+        ++stats.crcErrors;
+        return FrameStatus::Invalid;
+    }
+    return FrameStatus::Complete;
+}
+
+qint64 BinaryFrameDecoder::unwrapTimestamp(quint32 raw)
+{
+    // millis() на ESP32 переполняется примерно раз в 49 дней
+    if (hasTimestamp && raw < lastRawTimestamp && lastRawTimestamp - raw > 0x80000000u)
+        timestampEpoch += qint64(1) << 32;
+    hasTimestamp = true;
+    lastRawTimestamp = raw;
+    return timestampEpoch + raw;
+}
@@ -0,0 +1,140 @@
+#ifndef BINARYPROTOCOL_H
+#define BINARYPROTOCOL_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QtEndian>
+#include "sensorSample.h"
+
+// Двоичный кадровый протокол ESP32 (альтернатива текстовому CSV).
+//
+// Кадр (все поля little-endian, без выравнивания):
+//   заголовок, 12 байт: magic u32 | version u8 | flags u8 | sampleCount u16 | sequence u32
+//   отсчёты, 14 байт:  timestamp u32 (мс) | IR u32 (18 бит) | Red u32 (18 бит) | temp i16 (сотые °C)
+//   CRC-32 (IEEE 802.3) по заголовку и отсчётам, u32
+namespace BinaryProtocol {
+
+constexpr quint8 magicBytes[4] = { 0xA5, 'S', 'P', 'O' };
+constexpr quint8 version = 1;
+constexpr int headerSize = 12;
+constexpr int sampleSize = 14;
+constexpr int crcSize = 4;
+constexpr int maxSamplesPerFrame = 512;
+constexpr quint32 sensorValueMask = 0x3FFFF; // АЦП MAX30102 — 18 бит
+constexpr quint32 maxSequenceGap = 1 << 16;   // больший скачок номера — перезапуск прошивки, а не потеря
+
+constexpr int frameSize(int sampleCount) { return headerSize + sampleCount * sampleSize + crcSize; }
+
+quint32 crc32(const char* data, qsizetype size);
+
+// Первый целый кадр в data с верными magic, заголовком и CRC; nullptr — такого нет
+const char* findFrame(const char* data, qsizetype size);
+
+// Эталонный кодер: добавляет кадр с count отсчётами в конец out
+void encodeFrame(quint32 sequence, const SensorSample* samples, int count, QByteArray& out);
+
+} // namespace BinaryProtocol
+
+// Декодер потока кадров: ищет magic, проверяет версию и CRC, разворачивает 32-битные метки времени
+class BinaryFrameDecoder
+{
+public:
+    struct Counters {
+        quint64 framesDecoded = 0;
+        quint64 samplesDecoded = 0;
+        quint64 crcErrors = 0;
+        quint64 headerErrors = 0;    // неизвестная версия или недопустимое число отсчётов
+        quint64 sequenceGaps = 0;    // потерянные кадры по номеру последовательности
+        quint64 sequenceResets = 0;  // номер пошёл назад или прыгнул дальше maxSequenceGap — ресинхронизация
+        quint64 skippedBytes = 0;    // байты, пропущенные при поиске начала кадра
+    };
+
+    BinaryFrameDecoder();
+
+    // Для каждого отсчёта из целых кадров вызывает sink(const SensorSample&); хвост кадра сохраняется
+    template<typename Sink>
+    int feed(const char* data, qsizetype size, Sink&& sink);
+
+    int feed(const char* data, qsizetype size, QVector<SensorSample>& out);
+
+    const Counters& counters() const { return stats; }
+    quint64 errorCount() const { return stats.crcErrors + stats.headerErrors; }
+    void resetCounters() { stats = Counters(); }
+    void reset();
+
+private:
+    enum class FrameStatus { Complete, NeedMoreData, Invalid };
+
+    FrameStatus checkFrame(const char* frame, qsizetype available, int& sampleCount);
+    qint64 unwrapTimestamp(quint32 raw);
+
+    QByteArray pending;
+    Counters stats;
+    bool hasSequence = false;
+    quint32 expectedSequence = 0;
+    bool hasTimestamp = false;
+    quint32 lastRawTimestamp = 0;
+    qint64 timestampEpoch = 0; // накопленные переполнения millis() на ESP32
+};
+
+template<typename Sink>
+int BinaryFrameDecoder::feed(const char* data, qsizetype size, Sink&& sink)
+{
+    pending.append(data, size);
+
+    int produced = 0;
+    qsizetype offset = 0;
+    const char* const base = pending.constData();
+    const qsizetype total = pending.size();
+
+    while (total - offset >= 4) {
+        const char* frame = base + offset;
+        if (quint8(frame[0]) != BinaryProtocol::magicBytes[0] || quint8(frame[1]) != BinaryProtocol::magicBytes[1]
+            || quint8(frame[2]) != BinaryProtocol::magicBytes[2] || quint8(frame[3]) != BinaryProtocol::magicBytes[3]) {
+            ++stats.skippedBytes;
+            ++offset;
+            continue;
+        }
+
+        int sampleCount = 0;
+        const FrameStatus status = checkFrame(frame, total - offset, sampleCount);
+        if (status == FrameStatus::NeedMoreData)
+            break;
+        if (status == FrameStatus::Invalid) {
+            // Ложное совпадение magic или повреждённый кадр — ищем следующий
+            ++offset;
+            continue;
+        }
+
+        const quint32 sequence = qFromLittleEndian<quint32>(frame + 8);
+        if (hasSequence && sequence != expectedSequence) {
+            // Разность беззнаковая: номер назад дал бы ~4·10⁹ «потерянных» кадров
+            const quint32 gap = sequence - expectedSequence;
+            if (gap < BinaryProtocol::maxSequenceGap)
+                stats.sequenceGaps += gap;
+            else
+                ++stats.sequenceResets;
+        }
+        hasSequence = true;
+        expectedSequence = sequence + 1;
+
+        const char* record = frame + BinaryProtocol::headerSize;
+        SensorSample sample;
+        for (int i = 0; i < sampleCount; ++i, record += BinaryProtocol::sampleSize) {
+            sample.timestamp = unwrapTimestamp(qFromLittleEndian<quint32>(record));
+            sample.irValue = qFromLittleEndian<quint32>(record + 4) & BinaryProtocol::sensorValueMask;
+            sample.redValue = qFromLittleEndian<quint32>(record + 8) & BinaryProtocol::sensorValueMask;
+            sample.tempValue = qFromLittleEndian<qint16>(record + 12) / 100.0;
+            sink(static_cast<const SensorSample&>(sample));
+        }
+        produced += sampleCount;
+        ++stats.framesDecoded;
+        stats.samplesDecoded += sampleCount;
+        offset += BinaryProtocol::frameSize(sampleCount);
+    }
+
+    pending.remove(0, offset);
+    return produced;
+}
+
+#endif // BINARYPROTOCOL_H
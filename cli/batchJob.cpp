@@ -0,0 +1,190 @@
+#include "batchJob.h"
+#include "exportdatatofiles.h"
+#include "minuteStatistics.h"
+#include "sampleStreamDecoder.h"
+#include "sessionHistory.h"
+#include "sessionJournal.h"
+#include "signalProcessor.h"
+#include "streamRecording.h"
+#include "traceSpans.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <cstring>
+
+namespace {
+
+constexpr qint64 rawChunkSize = 64 * 1024;
+
+// События — для SessionHistory; BPM сразу идёт и в статистику по окнам
+class BatchObserver : public PipelineEventCollector
+{
+public:
+    BatchObserver(QVector<PipelineEvent>& events, BpmStatistics& minutes, qint64 startEpochMs)
+        : PipelineEventCollector(events), minutes(minutes), startEpochMs(startEpochMs) {}
+
+    // Время начала привязано к первому отсчёту сессии и задаётся до первого BPM —
+    // по нему выравниваются минуты
+    void sessionSample(qint64 timestamp)
+    {
+        if (minutes.getStartEpochMs() < 0)
+            minutes.setStartEpochMs(startEpochMs, timestamp);
+    }
+
+    void onSample(qint64 timestamp, double timeSec, double ir, double red, double temp) override
+    {
+        PipelineEventCollector::onSample(timestamp, timeSec, ir, red, temp);
+        sessionSample(timestamp);
+    }
+    void onBpm(qint64 timestamp, double timeSec, double bpm, double averageBpm) override
+    {
+        PipelineEventCollector::onBpm(timestamp, timeSec, bpm, averageBpm);
+        minutes.addBpm(timestamp, bpm);
+    }
+
+private:
+    BpmStatistics& minutes;
+    qint64 startEpochMs;
+};
+
+// Состояние обработки одного файла
+struct Pipeline {
+    explicit Pipeline(qint64 startEpochMs)
+        : observer(events, minutes, startEpochMs)
+    {
+        processor.setObserver(&observer);
+    }
+
+    void feed(const char* data, qsizetype size)
+    {
+        samples.resize(0);
+        decoder.feed(data, size, samples);
+        if (samples.isEmpty())
+            return;
+        events.resize(0);
+        processor.processBatch(samples.constData(), samples.size());
+        history.apply(events.constData(), events.size());
+    }
+
+    SampleStreamDecoder decoder;
+    SignalProcessor processor;
+    SessionHistory history;
+    BpmStatistics minutes;
+    QVector<SensorSample> samples;
+    QVector<PipelineEvent> events;
+    BatchObserver observer;
+};
+
+bool hasMagic(const QString& path, const char* expected)
+{
+    QFile file(path);
+    char magic[4];
+    return file.open(QIODevice::ReadOnly) && file.read(magic, 4) == 4
+           && memcmp(magic, expected, 4) == 0;
+}
+
+} // namespace
+
+BatchResult processRecording(const QString& path, const BatchOptions& options)
+{
+    TRACE_SPAN("processRecording");
+    BatchResult result;
+    result.input = path;
+    QElapsedTimer timer;
+    timer.start();
+
+    // Для сырых файлов время начала неизвестно — минуты подписываются от 00:00.
+    // Иначе — из заголовка: время начала записи или сессии, а не часы хоста во время обработки
+    qint64 startEpochMs = QDateTime(QDate(2000, 1, 1), QTime(0, 0)).toMSecsSinceEpoch();
+    StreamRecordingReader reader;
+    SessionJournalReader journal;
+    const bool recording = hasMagic(path, StreamRecording::magic);
+    // Сегмент журнала (например, после аварии) уже содержит результаты — обработка не нужна
+    const bool journaled = !recording && hasMagic(path, SessionJournalFormat::magic);
+    if (journaled) {
+        if (!journal.open(path)) {
+            result.error = journal.errorString();
+            return result;
+        }
+        startEpochMs = journal.startEpochMs();
+    }
+    if (recording) {
+        if (!reader.open(path)) {
+            result.error = reader.errorString();
+            return result;
+        }
+        startEpochMs = reader.startEpochMs();
+    }
+
+    Pipeline pipeline(startEpochMs);
+    pipeline.history.setKeepSamples(options.includeSamples);
+    pipeline.processor.setSpo2WindowMs(options.spo2WindowMs);
+    pipeline.processor.setPeakFilter(options.peakFilter);
+
+    if (journaled) {
+        PipelineEvent event;
+        while (journal.readNext(event)) {
+            if (event.type == PipelineEvent::Sample) {
+                ++result.samples;
+                pipeline.observer.sessionSample(event.timestamp);
+            } else if (event.type == PipelineEvent::Bpm) {
+                pipeline.minutes.addBpm(event.timestamp, event.value);
+            }
+            pipeline.history.apply(event);
+        }
+        if (journal.hasError()) {
+            result.error = journal.errorString();
+            return result;
+        }
+    } else if (recording) {
+        StreamRecording::Chunk chunk;
+        while (reader.readNext(chunk)) {
+            if (chunk.type == StreamRecording::Chunk::StreamReset)
+                pipeline.decoder.reset();
+            else
+                pipeline.feed(chunk.data.constData(), chunk.data.size());
+        }
+        if (reader.hasError()) {
+            result.error = reader.errorString();
+            return result;
+        }
+    } else {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            result.error = file.errorString();
+            return result;
+        }
+        QByteArray buffer(rawChunkSize, Qt::Uninitialized);
+        qint64 n;
+        while ((n = file.read(buffer.data(), rawChunkSize)) > 0)
+            pipeline.feed(buffer.constData(), n);
+    }
+
+    pipeline.history.setStartEpochMs(startEpochMs);
+
+    if (!journaled)
+        result.samples = pipeline.decoder.samplesDecoded();
+    result.decodeErrors = pipeline.decoder.errorCount();
+    result.beats = pipeline.history.getAllBpmData().size();
+    result.dataSeconds = pipeline.history.getElapsedTime();
+    const SessionHistory::MemoryReport memory = pipeline.history.memoryReport();
+    result.historyBytes = memory.totalBytes();
+    result.bytesPerSample = memory.bytesPerSample();
+
+    const QString baseFilename = QFileInfo(path).completeBaseName();
+    bool exported = true;
+    if (options.text)
+        exported &= ExportDataToFiles::exportAllDataToText(pipeline.history, pipeline.minutes.minuteRecords(), baseFilename,
+                                                           options.outputDirectory, options.includeSamples);
+    if (options.binary)
+        exported &= ExportDataToFiles::exportAllDataToBinary(pipeline.history, baseFilename,
+                                                             options.outputDirectory, options.includeSamples);
+    if (!exported)
+        result.error = "cannot write results to " + options.outputDirectory;
+
+    result.ok = exported;
+    result.elapsedNs = timer.nsecsElapsed();
+    return result;
+}
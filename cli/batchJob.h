@@ -0,0 +1,35 @@
+#ifndef BATCHJOB_H
+#define BATCHJOB_H
+
+#include <QString>
+#include "bandPassFilter.h"
+
+// Обработка одной записи без GUI: декодирование, SignalProcessor, экспорт результатов.
+// Каждый вызов независим (своё состояние декодера и обработки) — безопасно вызывать из разных потоков.
+struct BatchOptions {
+    QString outputDirectory = "Result";
+    bool text = true;
+    bool binary = false;
+    bool includeSamples = false; // IR/Red/Temp по каждому отсчёту — объём как у самой записи
+    int spo2WindowMs = 4000;     // окно DC для SpO₂ (AC/DC)
+    BandPassFilter::Settings peakFilter; // фильтр перед детекцией пиков
+};
+
+struct BatchResult {
+    QString input;
+    bool ok = false;
+    QString error;
+    quint64 samples = 0;
+    quint64 decodeErrors = 0;
+    quint64 beats = 0;           // интервалы, давшие значение BPM
+    double dataSeconds = 0.0;    // длительность записи по времени датчика
+    qint64 elapsedNs = 0;        // время обработки файла
+    quint64 historyBytes = 0;    // память истории сессии (с --samples — вместе с отсчётами)
+    double bytesPerSample = 0.0; // память на один сохранённый отсчёт
+};
+
+// Вход — запись .esprec (StreamRecorder), сегмент журнала .espj (SessionJournal)
+// или сырой поток ESP32 (CSV/двоичные кадры), сохранённый в файл
+BatchResult processRecording(const QString& path, const BatchOptions& options);
+
+#endif // BATCHJOB_H
@@ -0,0 +1,15 @@
+QT = core
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = esp32_batch
+
+include(../ingest.pri)
+include(../processing.pri)
+
+SOURCES += \
+    batchJob.cpp \
+    main.cpp
+
+HEADERS += \
+    batchJob.h
@@ -0,0 +1,127 @@
+#include "asyncLogger.h"
+#include "batchJob.h"
+#include "traceSpans.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QVector>
+
+// Пакетная обработка записей без GUI: esp32_batch [-j N] [-o DIR] [--binary] файлы_или_каталоги...
+// Файлы обрабатываются параллельно на всех ядрах, каждый — независимо и детерминированно.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("esp32_batch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Reprocesses recorded ESP32 sessions offline and exports BPM, SpO2 "
+                                     "(AC/DC and peak-cycle) and per-minute statistics.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "Recordings (.esprec), journal segments (.espj) or raw stream dumps; "
+                                           "directories are scanned for *.esprec and *.espj.", "inputs...");
+    const QCommandLineOption outputOption({ "o", "output" }, "Output directory.", "dir", "Result");
+    const QCommandLineOption jobsOption({ "j", "jobs" }, "Parallel jobs (default: number of cores).", "count");
+    const QCommandLineOption binaryOption("binary", "Also write the binary export.");
+    const QCommandLineOption noTextOption("no-text", "Do not write the text export.");
+    const QCommandLineOption samplesOption("samples", "Also export per-sample IR, Red and temperature.");
+    const QCommandLineOption spo2WindowOption("spo2-window", "DC window for AC/DC SpO2, ms.", "ms", "4000");
+    const QCommandLineOption bandPassOption("band-pass", "Band-pass filter IR before peak detection.");
+    const QCommandLineOption bandPassRangeOption("band-pass-range", "Pass band for --band-pass, Hz.", "low:high", "0.5:5");
+    const QCommandLineOption logRulesOption("log-rules", "Logging rules, e.g. \"esp32.beat.debug=true\" "
+                                                         "(';' separates rules).", "rules");
+    const QCommandLineOption traceOption("trace", "Write hot-path trace spans (Chrome Trace Event JSON, "
+                                                  "opens in Perfetto) to this file.", "file");
+    parser.addOptions({ outputOption, jobsOption, binaryOption, noTextOption, samplesOption, spo2WindowOption,
+                        bandPassOption, bandPassRangeOption, logRulesOption, traceOption });
+    parser.process(app);
+
+    // Сообщения из параллельных задач выводит отдельный поток
+    AsyncLogger::install();
+    AsyncLogger::setFilterRules(parser.value(logRulesOption).replace(';', '\n'));
+    Trace::setEnabled(parser.isSet(traceOption));
+
+    QStringList inputs;
+    for (const QString& argument : parser.positionalArguments()) {
+        const QFileInfo info(argument);
+        if (info.isDir()) {
+            const QDir dir(argument);
+            for (const QString& name : dir.entryList({ "*.esprec", "*.espj" }, QDir::Files, QDir::Name))
+                inputs.append(dir.filePath(name));
+        } else {
+            inputs.append(argument);
+        }
+    }
+    QTextStream out(stdout);
+    if (inputs.isEmpty()) {
+        out << "No input files.\n";
+        parser.showHelp(1);
+    }
+
+    BatchOptions options;
+    options.outputDirectory = parser.value(outputOption);
+    options.text = !parser.isSet(noTextOption);
+    options.binary = parser.isSet(binaryOption);
+    options.includeSamples = parser.isSet(samplesOption);
+    options.spo2WindowMs = parser.value(spo2WindowOption).toInt();
+    options.peakFilter.enabled = parser.isSet(bandPassOption);
+    const QStringList band = parser.value(bandPassRangeOption).split(':');
+    if (band.size() == 2) {
+        options.peakFilter.lowHz = band[0].toDouble();
+        options.peakFilter.highHz = band[1].toDouble();
+    }
+
+    QThreadPool pool;
+    if (parser.isSet(jobsOption))
+        pool.setMaxThreadCount(qMax(1, parser.value(jobsOption).toInt()));
+    out << "Processing " << inputs.size() << " file(s) with " << pool.maxThreadCount() << " job(s)\n";
+    out.flush();
+
+    // Каждая задача пишет только в свой элемент — синхронизация не нужна
+    QVector<BatchResult> results(inputs.size());
+    QElapsedTimer wallClock;
+    wallClock.start();
+    for (int i = 0; i < inputs.size(); ++i) {
+        pool.start([&results, &inputs, &options, i]() {
+            results[i] = processRecording(inputs[i], options);
+        });
+    }
+    pool.waitForDone();
+    const qint64 wallNs = qMax<qint64>(wallClock.nsecsElapsed(), 1);
+
+    quint64 totalSamples = 0;
+    double totalDataSeconds = 0.0;
+    int failed = 0;
+    for (const BatchResult& r : std::as_const(results)) {
+        if (!r.ok) {
+            ++failed;
+            out << "FAILED " << r.input << ": " << r.error << "\n";
+            continue;
+        }
+        totalSamples += r.samples;
+        totalDataSeconds += r.dataSeconds;
+        out << r.input << ": " << r.samples << " samples (" << QString::number(r.dataSeconds / 3600.0, 'f', 2)
+            << " h), " << r.beats << " beats, " << r.decodeErrors << " decode errors, "
+            << QString::number(r.samples * 1e9 / qMax<qint64>(r.elapsedNs, 1), 'f', 0) << " samples/s, history "
+            << QString::number(r.historyBytes / 1048576.0, 'f', 1) << " MiB";
+        if (options.includeSamples)
+            out << " (" << QString::number(r.bytesPerSample, 'f', 1) << " bytes/sample)";
+        out << "\n";
+    }
+
+    out << "Total: " << totalSamples << " samples, " << QString::number(totalDataSeconds / 3600.0, 'f', 2)
+        << " h of data in " << QString::number(wallNs / 1e9, 'f', 2) << " s — "
+        << QString::number(totalSamples * 1e9 / wallNs, 'f', 0) << " samples/s, x"
+        << QString::number(totalDataSeconds * 1e9 / wallNs, 'f', 0) << " real time\n";
+    if (failed > 0)
+        out << failed << " file(s) failed\n";
+    // Кольца ограничены: в длинном прогоне остаются последние интервалы каждого потока
+    if (parser.isSet(traceOption) && Trace::writeChromeTrace(parser.value(traceOption)))
+        out << "Trace written to " << parser.value(traceOption) << "\n";
+    AsyncLogger::shutdown();
+    return failed > 0 ? 1 : 0;
+}
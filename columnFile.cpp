@@ -0,0 +1,374 @@
+#include "columnFile.h"
+
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+template<typename T>
+char* put(char* out, T value)
+{
+    qToLittleEndian(value, out);
+    return out + sizeof(T);
+}
+
+template<typename T>
+T get(const uchar* in)
+{
+    return qFromLittleEndian<T>(in);
+}
+
+qint64 alignUp(qint64 value, int alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Размер столбца из rows значений с выравниванием до 8 байт
+qint64 columnBytes(int rows, int valueSize)
+{
+    return alignUp(qint64(rows) * valueSize, 8);
+}
+
+void encodeValue(char* out, ColumnFileFormat::ValueType type, double value, double scale)
+{
+    switch (type) {
+    case ColumnFileFormat::Int16:
+        put<qint16>(out, qint16(qRound(value / scale)));
+        break;
+    case ColumnFileFormat::Int32:
+        put<qint32>(out, qint32(qRound64(value / scale)));
+        break;
+    case ColumnFileFormat::UInt32:
+        put<quint32>(out, quint32(qRound64(value / scale)));
+        break;
+    case ColumnFileFormat::Float32:
+        put<float>(out, float(value / scale));
+        break;
+    case ColumnFileFormat::Float64:
+        put<double>(out, value / scale);
+        break;
+    }
+}
+
+} // namespace
+
+int ColumnFileFormat::valueSize(ValueType type)
+{
+    switch (type) {
+    case Int16: return 2;
+    case Int32: return 4;
+    case UInt32: return 4;
+    case Float32: return 4;
+    case Float64: return 8;
+    }
+    return 0;
+}
+
+// --------------------- Запись ---------------------
+
+ColumnFileWriter::~ColumnFileWriter()
+{
+    if (file.isOpen())
+        close();
+}
+
+bool ColumnFileWriter::open(const QString& path, const QVector<ColumnChannel>& channels, qint64 originTimestamp,
+                            qint64 startEpochMs, ColumnFileFormat::TimeBase timeBase, int rowsPerChunk)
+{
+    error.clear();
+    channelList = channels;
+    chunkRows = qMax(1, rowsPerChunk);
+    chunkFill = 0;
+    chunkCount = 0;
+    segment = 0;
+    lastTimestamp = 0;
+    rows = 0;
+    index.clear();
+    timestamps.resize(qsizetype(chunkRows) * 8);
+    columns.resize(channels.size());
+    for (int c = 0; c < channels.size(); ++c)
+        columns[c].resize(qsizetype(chunkRows) * ColumnFileFormat::valueSize(channels[c].type));
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = file.errorString();
+        return false;
+    }
+
+    char header[ColumnFileFormat::fileHeaderSize] = {};
+    char* out = header;
+    memcpy(out, ColumnFileFormat::magic, 4);
+    out = put<quint16>(out + 4, ColumnFileFormat::version);
+    out = put<quint16>(out, quint16(channels.size()));
+    out = put<quint32>(out, quint32(chunkRows));
+    out = put<quint32>(out, timeBase);
+    out = put<qint64>(out, originTimestamp);
+    put<qint64>(out, startEpochMs);
+    if (!writeBytes(header, sizeof(header)))
+        return false;
+
+    for (const ColumnChannel& channel : channels) {
+        char descriptor[ColumnFileFormat::channelDescriptorSize] = {};
+        const QByteArray name = channel.name.toUtf8().left(ColumnFileFormat::channelNameSize);
+        memcpy(descriptor, name.constData(), size_t(name.size()));
+        descriptor[ColumnFileFormat::channelNameSize] = char(channel.type);
+        put<double>(descriptor + 24, channel.scale);
+        if (!writeBytes(descriptor, sizeof(descriptor)))
+            return false;
+    }
+    return true;
+}
+
+void ColumnFileWriter::append(qint64 timestamp, const double* values)
+{
+    // Перезапуск ESP32: метки внутри участка не убывают, иначе индекс не годится для двоичного поиска
+    if (rows > 0 && timestamp < lastTimestamp) {
+        writeChunk();
+        ++segment;
+    }
+    lastTimestamp = timestamp;
+    put<qint64>(timestamps.data() + qsizetype(chunkFill) * 8, timestamp);
+    for (int c = 0; c < channelList.size(); ++c) {
+        const ColumnChannel& channel = channelList[c];
+        char* out = columns[c].data() + qsizetype(chunkFill) * ColumnFileFormat::valueSize(channel.type);
+        encodeValue(out, channel.type, values[c], channel.scale);
+    }
+    ++rows;
+    if (++chunkFill == chunkRows)
+        writeChunk();
+}
+
+bool ColumnFileWriter::close()
+{
+    if (!file.isOpen())
+        return false;
+    bool ok = error.isEmpty() && writeChunk() && writePadding(8);
+    const qint64 indexOffset = file.pos();
+    ok = ok && writeBytes(index.constData(), index.size());
+
+    char trailer[ColumnFileFormat::trailerSize] = {};
+    char* out = trailer;
+    out = put<qint64>(out, indexOffset);
+    out = put<quint32>(out, quint32(chunkCount));
+    out = put<quint32>(out, 0);
+    out = put<qint64>(out, rows);
+    out = put<quint32>(out, 0);
+    memcpy(out, ColumnFileFormat::magic, 4);
+    ok = ok && writeBytes(trailer, sizeof(trailer));
+
+    file.close();
+    return ok;
+}
+
+bool ColumnFileWriter::writeChunk()
+{
+    if (chunkFill == 0)
+        return true;
+    if (!writePadding(ColumnFileFormat::chunkAlignment))
+        return false;
+
+    char entry[ColumnFileFormat::indexEntrySize] = {};
+    char* out = entry;
+    out = put<qint64>(out, qFromLittleEndian<qint64>(timestamps.constData()));
+    out = put<qint64>(out, qFromLittleEndian<qint64>(timestamps.constData() + qsizetype(chunkFill - 1) * 8));
+    out = put<qint64>(out, file.pos());
+    out = put<quint32>(out, quint32(chunkFill));
+    put<quint32>(out, quint32(segment));
+    index.append(entry, sizeof(entry));
+
+    // Столбцы неполного последнего блока пишутся той же длины, что и в индексе, — по chunkFill строк
+    bool ok = writeBytes(timestamps.constData(), qint64(chunkFill) * 8);
+    for (int c = 0; ok && c < channelList.size(); ++c) {
+        const int size = ColumnFileFormat::valueSize(channelList[c].type);
+        ok = writeBytes(columns[c].constData(), qint64(chunkFill) * size) && writePadding(8);
+    }
+    ++chunkCount;
+    chunkFill = 0;
+    return ok;
+}
+
+bool ColumnFileWriter::writePadding(int alignment)
+{
+    static const char zeros[ColumnFileFormat::chunkAlignment] = {};
+    const qint64 pos = file.pos();
+    const qint64 padding = alignUp(pos, alignment) - pos;
+    return padding == 0 || writeBytes(zeros, padding);
+}
+
+bool ColumnFileWriter::writeBytes(const char* data, qint64 size)
+{
+    if (!error.isEmpty())
+        return false;
+    if (file.write(data, size) != size) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// --------------------- Чтение ---------------------
+
+ColumnFileReader::~ColumnFileReader()
+{
+    close();
+}
+
+void ColumnFileReader::close()
+{
+    if (mapped)
+        file.unmap(const_cast<uchar*>(mapped));
+    mapped = nullptr;
+    mappedSize = 0;
+    file.close();
+    channelList.clear();
+    chunks.clear();
+    segmentStarts.clear();
+    startMs = -1;
+    base = ColumnFileFormat::DeviceTime;
+    rows = 0;
+}
+
+bool ColumnFileReader::fail(const QString& message)
+{
+    error = message;
+    close();
+    return false;
+}
+
+bool ColumnFileReader::open(const QString& path)
+{
+    close();
+    error.clear();
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    // Столбцы отдаются без копирования — порядок байтов файла должен совпадать с порядком хоста
+    return fail("memory-mapped reading requires a little-endian host");
+#endif
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return fail(file.errorString());
+    mappedSize = file.size();
+    if (mappedSize < ColumnFileFormat::fileHeaderSize + ColumnFileFormat::trailerSize)
+        return fail("not a column file");
+    mapped = file.map(0, mappedSize);
+    if (!mapped)
+        return fail("cannot map file: " + file.errorString());
+
+    if (memcmp(mapped, ColumnFileFormat::magic, 4) != 0)
+        return fail("not a column file");
+    const quint16 version = get<quint16>(mapped + 4);
+    if (version != ColumnFileFormat::version)
+        return fail(QString("unsupported column file version %1").arg(version));
+    const int channelCount = get<quint16>(mapped + 6);
+    const quint32 timeBase = get<quint32>(mapped + 12);
+    if (timeBase > ColumnFileFormat::SessionTime)
+        return fail(QString("unknown time base %1").arg(timeBase));
+    base = ColumnFileFormat::TimeBase(timeBase);
+    origin = get<qint64>(mapped + 16);
+    startMs = get<qint64>(mapped + 24);
+
+    // Концовки нет — файл не дописан (экспорт прерван)
+    const uchar* trailer = mapped + mappedSize - ColumnFileFormat::trailerSize;
+    if (memcmp(trailer + 28, ColumnFileFormat::magic, 4) != 0)
+        return fail("column file is incomplete (no index)");
+    const qint64 indexOffset = get<qint64>(trailer);
+    const qint64 chunkCount = get<quint32>(trailer + 8);
+    rows = get<qint64>(trailer + 16);
+
+    const qint64 dataStart = ColumnFileFormat::fileHeaderSize
+                             + qint64(channelCount) * ColumnFileFormat::channelDescriptorSize;
+    const qint64 indexEnd = indexOffset + chunkCount * ColumnFileFormat::indexEntrySize;
+    if (indexOffset < dataStart || indexEnd > mappedSize - ColumnFileFormat::trailerSize)
+        return fail("corrupted column file index");
+
+    for (int c = 0; c < channelCount; ++c) {
+        const uchar* descriptor = mapped + ColumnFileFormat::fileHeaderSize
+                                  + c * ColumnFileFormat::channelDescriptorSize;
+        ColumnChannel channel;
+        const char* name = reinterpret_cast<const char*>(descriptor);
+        channel.name = QString::fromUtf8(name, int(strnlen(name, ColumnFileFormat::channelNameSize)));
+        channel.type = ColumnFileFormat::ValueType(descriptor[ColumnFileFormat::channelNameSize]);
+        channel.scale = get<double>(descriptor + 24);
+        if (ColumnFileFormat::valueSize(channel.type) == 0)
+            return fail(QString("unknown value type %1 of channel %2").arg(int(channel.type)).arg(channel.name));
+        channelList.append(channel);
+    }
+
+    // Индекс проверяется целиком: дальше указатели на столбцы берутся без проверок.
+    // Участки идут подряд с нуля, внутри участка метки блоков не убывают
+    chunks.reserve(int(chunkCount));
+    qint64 indexedRows = 0;
+    for (qint64 i = 0; i < chunkCount; ++i) {
+        const uchar* entry = mapped + indexOffset + i * ColumnFileFormat::indexEntrySize;
+        Chunk chunk { get<qint64>(entry), get<qint64>(entry + 8), get<qint64>(entry + 16),
+                      int(get<quint32>(entry + 24)), int(get<quint32>(entry + 28)) };
+        const bool newSegment = chunks.isEmpty() || chunk.segment != chunks.last().segment;
+        const int expectedSegment = chunks.isEmpty() ? 0 : chunks.last().segment + 1;
+        if (chunk.offset < dataStart || chunk.offset % ColumnFileFormat::chunkAlignment != 0 || chunk.rows <= 0
+            || chunk.offset + chunkBytes(chunk.rows) > indexOffset || chunk.firstTimestamp > chunk.lastTimestamp
+            || (newSegment && chunk.segment != expectedSegment)
+            || (!newSegment && chunk.firstTimestamp < chunks.last().lastTimestamp))
+            return fail(QString("corrupted column file index entry %1").arg(i));
+        if (newSegment)
+            segmentStarts.append(chunks.size());
+        indexedRows += chunk.rows;
+        chunks.append(chunk);
+    }
+    if (indexedRows != rows)
+        return fail("column file row count does not match its index");
+    return true;
+}
+
+int ColumnFileReader::channelIndex(const QString& name) const
+{
+    for (int c = 0; c < channelList.size(); ++c) {
+        if (channelList[c].name == name)
+            return c;
+    }
+    return -1;
+}
+
+qint64 ColumnFileReader::chunkBytes(int chunkRows) const
+{
+    qint64 bytes = columnBytes(chunkRows, 8);
+    for (const ColumnChannel& channel : channelList)
+        bytes += columnBytes(chunkRows, ColumnFileFormat::valueSize(channel.type));
+    return bytes;
+}
+
+ColumnFileReader::Slice ColumnFileReader::sliceOf(const Chunk& chunk, int begin, int end) const
+{
+    Slice slice;
+    const uchar* data = mapped + chunk.offset;
+    slice.timestamps = ColumnSpan<qint64>(reinterpret_cast<const qint64*>(data) + begin, end - begin);
+    data += columnBytes(chunk.rows, 8);
+    slice.columns.reserve(channelList.size());
+    for (const ColumnChannel& channel : channelList) {
+        const int size = ColumnFileFormat::valueSize(channel.type);
+        slice.columns.append(data + qint64(begin) * size);
+        data += columnBytes(chunk.rows, size);
+    }
+    return slice;
+}
+
+QVector<ColumnFileReader::Slice> ColumnFileReader::slices(qint64 from, qint64 to) const
+{
+    QVector<Slice> result;
+    if (!mapped || from > to)
+        return result;
+    // Метки упорядочены только внутри участка — поиск идёт по каждому участку отдельно
+    for (int s = 0; s < segmentStarts.size(); ++s) {
+        const auto segmentEnd = s + 1 < segmentStarts.size() ? chunks.begin() + segmentStarts[s + 1] : chunks.end();
+        // Первый блок участка, который заканчивается не раньше from
+        auto it = std::lower_bound(chunks.begin() + segmentStarts[s], segmentEnd, from,
+                                   [](const Chunk& chunk, qint64 t) { return chunk.lastTimestamp < t; });
+        for (; it != segmentEnd && it->firstTimestamp <= to; ++it) {
+            const qint64* timestamps = reinterpret_cast<const qint64*>(mapped + it->offset);
+            const int begin = int(std::lower_bound(timestamps, timestamps + it->rows, from) - timestamps);
+            const int end = int(std::upper_bound(timestamps + begin, timestamps + it->rows, to) - timestamps);
+            if (end > begin)
+                result.append(sliceOf(*it, begin, end));
+        }
+    }
+    return result;
+}
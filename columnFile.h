@@ -0,0 +1,193 @@
+#ifndef COLUMNFILE_H
+#define COLUMNFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+// Двоичный экспорт (.espc): самоописываемый столбцовый файл, который читается без разбора —
+// файл отображается в память (mmap), и столбцы отдаются как есть, без копирования.
+// Метка времени — целые миллисекунды, дата и миллисекунды не теряются. Какое это время,
+// записано в заголовке (timeBase): исходное время ESP32 или монотонное время сессии.
+// Время ESP32 сбрасывается при перезапуске платы; строки после сброса уходят в новый блок
+// с номером участка (segment) на единицу больше. Внутри участка метки не убывают.
+//
+// Формат (little-endian, столбцы выровнены для прямого доступа после mmap):
+//   заголовок, 32 байта: magic "ESPC" | version u16 | channelCount u16 | chunkRows u32 | timeBase u32 |
+//                        originTimestamp i64 (метка начала сессии) |
+//                        startEpochMs i64 (настенное время в момент originTimestamp)
+//   описания каналов, по 32 байта: name char[20] (UTF-8, дополнено нулями) | type u8 | reserved u8[3] |
+//                        scale f64 (значение = сырое · scale)
+//   блоки, каждый с границы 64 байт: timestamp i64[rows] | столбец канала 0 | столбец канала 1 | ...
+//                        (каждый столбец дополнен до границы 8 байт)
+//   индекс, по 32 байта на блок: firstTimestamp i64 | lastTimestamp i64 | offset i64 | rows u32 | segment u32
+//   концовка, 32 байта: indexOffset i64 | chunkCount u32 | reserved u32 | rowCount i64 | reserved u32 | magic "ESPC"
+namespace ColumnFileFormat {
+
+constexpr char magic[4] = { 'E', 'S', 'P', 'C' };
+constexpr quint16 version = 1;
+constexpr int fileHeaderSize = 32;
+constexpr int channelDescriptorSize = 32;
+constexpr int channelNameSize = 20;
+constexpr int indexEntrySize = 32;
+constexpr int trailerSize = 32;
+constexpr int chunkAlignment = 64;
+constexpr int defaultChunkRows = 65536;
+constexpr const char* suffix = ".espc";
+
+enum ValueType : quint8 { Int16 = 1, Int32 = 2, UInt32 = 3, Float32 = 4, Float64 = 5 };
+
+// DeviceTime — время ESP32 как есть, после перезапуска платы начинается новый участок.
+// SessionTime — время сессии (SampleStore::Row::time): после перезапуска продолжает расти,
+// поэтому участок всегда один, а метки всех файлов одной сессии сопоставимы
+enum TimeBase : quint32 { DeviceTime = 0, SessionTime = 1 };
+
+int valueSize(ValueType type); // 0 — неизвестный тип
+
+} // namespace ColumnFileFormat
+
+// Непрерывный участок столбца внутри отображённого файла (аналог std::span для C++17)
+template<typename T>
+class ColumnSpan
+{
+public:
+    ColumnSpan() = default;
+    ColumnSpan(const T* data, qsizetype size) : ptr(data), count(size) {}
+
+    const T* data() const { return ptr; }
+    qsizetype size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    const T& operator[](qsizetype i) const { return ptr[i]; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+
+private:
+    const T* ptr = nullptr;
+    qsizetype count = 0;
+};
+
+struct ColumnChannel {
+    QString name;
+    ColumnFileFormat::ValueType type = ColumnFileFormat::Float64;
+    double scale = 1.0;
+};
+
+// Запись по строкам; строки копятся в блоке и уходят на диск целыми столбцами
+class ColumnFileWriter
+{
+public:
+    ColumnFileWriter() = default;
+    ~ColumnFileWriter();
+
+    ColumnFileWriter(const ColumnFileWriter&) = delete;
+    ColumnFileWriter& operator=(const ColumnFileWriter&) = delete;
+
+    // startEpochMs — настенное время начала сессии (SessionHistory::getStartEpochMs()), -1 — неизвестно;
+    // timeBase только записывается в заголовок — метки писатель принимает как есть
+    bool open(const QString& path, const QVector<ColumnChannel>& channels, qint64 originTimestamp,
+              qint64 startEpochMs, ColumnFileFormat::TimeBase timeBase = ColumnFileFormat::DeviceTime,
+              int chunkRows = ColumnFileFormat::defaultChunkRows);
+    // values — по одному на канал, в единицах канала (целые типы хранят round(value / scale)).
+    // Метка меньше предыдущей (перезапуск ESP32) закрывает блок и начинает новый участок
+    void append(qint64 timestamp, const double* values);
+    // Дописывает последний блок, индекс и концовку; false — была ошибка записи
+    bool close();
+
+    qint64 rowCount() const { return rows; }
+    int segmentCount() const { return rows > 0 ? segment + 1 : 0; }
+    QString errorString() const { return error; }
+
+private:
+    bool writeChunk();
+    bool writePadding(int alignment);
+    bool writeBytes(const char* data, qint64 size);
+
+    QFile file;
+    QVector<ColumnChannel> channelList;
+    int chunkRows = 0;
+    int chunkFill = 0;
+    QByteArray timestamps;      // столбец времени текущего блока, уже little-endian
+    QVector<QByteArray> columns; // столбцы каналов текущего блока
+    QByteArray index;
+    int chunkCount = 0;
+    int segment = 0;
+    qint64 lastTimestamp = 0;
+    qint64 rows = 0;
+    QString error;
+};
+
+// Чтение через mmap: open() читает только заголовок, описания каналов и индекс,
+// поэтому файл любого размера открывается сразу; данные подгружает ОС по мере обращения
+class ColumnFileReader
+{
+public:
+    // Строки одного блока в пределах запрошенного интервала
+    struct Slice {
+        ColumnSpan<qint64> timestamps;
+        QVector<const void*> columns;
+
+        // T должен соответствовать ColumnChannel::type (qint16, qint32, quint32, float, double)
+        template<typename T>
+        ColumnSpan<T> column(int channel) const
+        {
+            return ColumnSpan<T>(static_cast<const T*>(columns[channel]), timestamps.size());
+        }
+    };
+
+    ColumnFileReader() = default;
+    ~ColumnFileReader();
+
+    ColumnFileReader(const ColumnFileReader&) = delete;
+    ColumnFileReader& operator=(const ColumnFileReader&) = delete;
+
+    bool open(const QString& path);
+    void close();
+
+    const QVector<ColumnChannel>& channels() const { return channelList; }
+    int channelIndex(const QString& name) const; // -1 — нет такого канала
+    qint64 originTimestamp() const { return origin; }
+    qint64 startEpochMs() const { return startMs; } // -1 — неизвестно
+    ColumnFileFormat::TimeBase timeBase() const { return base; }
+    qint64 rowCount() const { return rows; }
+    int chunkCount() const { return chunks.size(); }
+    // Участки между перезапусками ESP32; метки первой и последней строки файла
+    int segmentCount() const { return chunks.isEmpty() ? 0 : chunks.last().segment + 1; }
+    qint64 firstTimestamp() const { return chunks.isEmpty() ? 0 : chunks.first().firstTimestamp; }
+    qint64 lastTimestamp() const { return chunks.isEmpty() ? 0 : chunks.last().lastTimestamp; }
+
+    // Строки с from <= timestamp <= to, по Slice на каждый затронутый блок, в порядке файла;
+    // указатели действительны до close(). Если после перезапуска ESP32 метки повторяются,
+    // в результат попадают строки всех участков. Внутри участка блоки выбираются
+    // двоичным поиском по индексу, строки блока — двоичным поиском по меткам
+    QVector<Slice> slices(qint64 from, qint64 to) const;
+
+    QString errorString() const { return error; }
+
+private:
+    struct Chunk {
+        qint64 firstTimestamp;
+        qint64 lastTimestamp;
+        qint64 offset;
+        int rows;
+        int segment;
+    };
+
+    bool fail(const QString& message);
+    qint64 chunkBytes(int chunkRows) const; // timestamp и все столбцы блока с выравниванием
+    Slice sliceOf(const Chunk& chunk, int begin, int end) const;
+
+    QFile file;
+    const uchar* mapped = nullptr;
+    qint64 mappedSize = 0;
+    QVector<ColumnChannel> channelList;
+    QVector<Chunk> chunks;
+    QVector<int> segmentStarts; // индекс первого блока каждого участка
+    qint64 origin = 0;
+    qint64 startMs = -1;
+    ColumnFileFormat::TimeBase base = ColumnFileFormat::DeviceTime;
+    qint64 rows = 0;
+    QString error;
+};
+
+#endif // COLUMNFILE_H
@@ -0,0 +1,205 @@
+#include "connectionManager.h"
+
+#include <QLoggingCategory>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <cmath>
+
+Q_LOGGING_CATEGORY(lcNet, "esp32.net")
+
+ConnectionManager::ConnectionManager(QObject* parent)
+    : QObject(parent)
+{
+    // Таймеры — дочерние объекты, поэтому переезжают в поток вместе с менеджером
+    connectTimer = new QTimer(this);
+    connectTimer->setSingleShot(true);
+    connect(connectTimer, &QTimer::timeout, this, &ConnectionManager::onConnectTimeout);
+
+    backoffTimer = new QTimer(this);
+    backoffTimer->setSingleShot(true);
+    connect(backoffTimer, &QTimer::timeout, this, &ConnectionManager::onBackoffElapsed);
+
+    stallTimer = new QTimer(this);
+    connect(stallTimer, &QTimer::timeout, this, &ConnectionManager::checkStall);
+
+    setSettings(settings);
+}
+
+void ConnectionManager::setSettings(const Settings& newSettings)
+{
+    settings = newSettings;
+    settings.jitter = qBound(0.0, settings.jitter, 1.0);
+    // Проверяем простой несколько раз за период таймаута
+    stallTimer->setInterval(qBound(100, settings.stallTimeoutMs / 4, 1000));
+}
+
+void ConnectionManager::setSocket(QTcpSocket* newSocket)
+{
+    socket = newSocket;
+    connect(socket, &QTcpSocket::connected, this, &ConnectionManager::onConnected);
+    connect(socket, &QTcpSocket::disconnected, this, &ConnectionManager::onDisconnected);
+    connect(socket, &QTcpSocket::errorOccurred, this, &ConnectionManager::onSocketError);
+}
+
+void ConnectionManager::setEndpoint(const QString& newHost, quint16 newPort)
+{
+    host = newHost;
+    port = newPort;
+}
+
+const char* ConnectionManager::stateName(State state)
+{
+    switch (state) {
+    case State::Idle:
+        return "idle";
+    case State::Connecting:
+        return "connecting";
+    case State::Connected:
+        return "connected";
+    case State::Backoff:
+        return "backoff";
+    }
+    return "unknown";
+}
+
+void ConnectionManager::start()
+{
+    if (state() != State::Idle)
+        return;
+    if (!stallTimer->isActive())
+        stallTimer->start();
+    attemptConnect();
+}
+
+void ConnectionManager::restart()
+{
+    // Новый адрес: сбрасываем паузу и подключаемся сразу
+    stop();
+    consecutiveFailures = 0;
+    start();
+}
+
+void ConnectionManager::stop()
+{
+    connectTimer->stop();
+    backoffTimer->stop();
+    stallTimer->stop();
+    setState(State::Idle); // до abort(), чтобы сигнал disconnected не вызвал повтор
+    lossPending = false;
+    if (socket)
+        socket->abort();
+}
+
+void ConnectionManager::notifyDataReceived()
+{
+    lastDataClock.start();
+}
+
+void ConnectionManager::attemptConnect()
+{
+    qCDebug(lcNet) << "Attempting to connect to" << host << "on port" << port << "...";
+    socket->abort(); // ещё в Idle/Backoff — возможный disconnected будет проигнорирован
+    setState(State::Connecting);
+    attempts.fetch_add(1, std::memory_order_relaxed);
+    attemptClock.start();
+    connectTimer->start(settings.connectTimeoutMs);
+    socket->connectToHost(host, port);
+}
+
+void ConnectionManager::onConnected()
+{
+    if (state() != State::Connecting)
+        return;
+    connectTimer->stop();
+    consecutiveFailures = 0;
+    lastDataClock.start();
+
+    const qint64 latency = attemptClock.elapsed();
+    lastConnectMs.store(latency, std::memory_order_relaxed);
+    if (latency > maxConnectMs.load(std::memory_order_relaxed))
+        maxConnectMs.store(latency, std::memory_order_relaxed);
+
+    if (lossPending) {
+        const qint64 downtime = lossClock.elapsed();
+        lastReconnectMs.store(downtime, std::memory_order_relaxed);
+        if (downtime > maxReconnectMs.load(std::memory_order_relaxed))
+            maxReconnectMs.store(downtime, std::memory_order_relaxed);
+        reconnects.fetch_add(1, std::memory_order_relaxed);
+        lossPending = false;
+    }
+
+    qCInfo(lcNet) << "Successfully connected to" << host << "in" << latency << "ms";
+    setState(State::Connected);
+    emit connectionEstablished();
+}
+
+void ConnectionManager::onDisconnected()
+{
+    handleFailure("socket disconnected");
+}
+
+void ConnectionManager::onSocketError(QAbstractSocket::SocketError socketError)
+{
+    Q_UNUSED(socketError);
+    handleFailure("socket error: " + socket->errorString());
+}
+
+void ConnectionManager::onConnectTimeout()
+{
+    handleFailure(QString("no connection within %1 ms").arg(settings.connectTimeoutMs));
+}
+
+void ConnectionManager::checkStall()
+{
+    if (state() == State::Connected && lastDataClock.elapsed() > settings.stallTimeoutMs) {
+        stalls.fetch_add(1, std::memory_order_relaxed);
+        handleFailure(QString("no data for %1 ms").arg(lastDataClock.elapsed()));
+    }
+}
+
+void ConnectionManager::handleFailure(const QString& reason)
+{
+    // Из Idle/Backoff повтор уже запланирован или не нужен — второй попытки не создаём
+    const State previous = state();
+    if (previous != State::Connecting && previous != State::Connected)
+        return;
+
+    if (previous == State::Connected) {
+        lossPending = true;
+        lossClock.start();
+        emit connectionLost();
+    }
+    failures.fetch_add(1, std::memory_order_relaxed);
+    connectTimer->stop();
+
+    const int delay = nextBackoffMs();
+    qCWarning(lcNet) << "Connection to" << host << "failed (" << reason << "). Retry in" << delay << "ms";
+    setState(State::Backoff); // до abort(), чтобы повторный disconnected был проигнорирован
+    socket->abort();
+    backoffTimer->start(delay);
+}
+
+void ConnectionManager::onBackoffElapsed()
+{
+    if (state() == State::Backoff)
+        attemptConnect();
+}
+
+int ConnectionManager::nextBackoffMs()
+{
+    const double base = settings.initialBackoffMs * std::pow(settings.backoffFactor, consecutiveFailures);
+    const double capped = qMin(base, double(settings.maxBackoffMs));
+    if (consecutiveFailures < 30)
+        ++consecutiveFailures;
+    // Часть паузы случайна, чтобы устройства после общего сбоя сети не переподключались одновременно
+    const double randomPart = capped * settings.jitter * QRandomGenerator::global()->generateDouble();
+    return qMax(1, int(capped * (1.0 - settings.jitter) + randomPart));
+}
+
+void ConnectionManager::setState(State newState)
+{
+    const State previous = static_cast<State>(currentState.exchange(static_cast<int>(newState),
+                                                                    std::memory_order_relaxed));
+    if (previous != newState)
+        emit stateChanged(newState);
+}
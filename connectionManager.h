@@ -0,0 +1,100 @@
+#ifndef CONNECTIONMANAGER_H
+#define CONNECTIONMANAGER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTcpSocket>
+#include <atomic>
+
+class QTimer;
+
+// Асинхронное подключение к ESP32: Idle → Connecting → Connected, при ошибке, обрыве,
+// таймауте подключения или отсутствии данных — Backoff с экспоненциальной задержкой и случайным разбросом.
+// Одновременно существует не больше одной попытки подключения; повторные сигналы об ошибке игнорируются.
+class ConnectionManager : public QObject
+{
+    Q_OBJECT
+public:
+    enum class State { Idle, Connecting, Connected, Backoff };
+    Q_ENUM(State)
+
+    struct Settings {
+        int connectTimeoutMs = 5000;   // ожидание установления соединения
+        int initialBackoffMs = 500;    // первая пауза перед повтором
+        int maxBackoffMs = 30000;      // верхняя граница паузы
+        double backoffFactor = 2.0;
+        double jitter = 0.5;           // доля паузы, выбираемая случайно (0..1)
+        int stallTimeoutMs = 10000;    // нет данных дольше — переподключение
+    };
+
+    explicit ConnectionManager(QObject* parent = nullptr);
+
+    void setSettings(const Settings& newSettings);
+    const Settings& connectionSettings() const { return settings; }
+
+    // Вызываются в потоке, которому принадлежит сокет
+    void setSocket(QTcpSocket* newSocket);
+    void setEndpoint(const QString& newHost, quint16 newPort);
+    void start();
+    void restart();
+    void stop();
+    void notifyDataReceived();
+
+    // Состояние и счётчики читаются из любого потока
+    State state() const { return static_cast<State>(currentState.load(std::memory_order_relaxed)); }
+    static const char* stateName(State state);
+    quint64 connectAttempts() const { return attempts.load(std::memory_order_relaxed); }
+    quint64 connectFailures() const { return failures.load(std::memory_order_relaxed); }
+    quint64 reconnectCount() const { return reconnects.load(std::memory_order_relaxed); }
+    quint64 stallCount() const { return stalls.load(std::memory_order_relaxed); }
+    qint64 lastConnectLatencyMs() const { return lastConnectMs.load(std::memory_order_relaxed); }
+    qint64 maxConnectLatencyMs() const { return maxConnectMs.load(std::memory_order_relaxed); }
+    qint64 lastReconnectLatencyMs() const { return lastReconnectMs.load(std::memory_order_relaxed); }
+    qint64 maxReconnectLatencyMs() const { return maxReconnectMs.load(std::memory_order_relaxed); }
+
+signals:
+    void stateChanged(ConnectionManager::State state);
+    void connectionEstablished();
+    void connectionLost();
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onSocketError(QAbstractSocket::SocketError socketError);
+    void onConnectTimeout();
+    void onBackoffElapsed();
+    void checkStall();
+
+private:
+    void attemptConnect();
+    void handleFailure(const QString& reason);
+    void setState(State newState);
+    int nextBackoffMs();
+
+    QTcpSocket* socket = nullptr;
+    QString host;
+    quint16 port = 80;
+    Settings settings;
+
+    QTimer* connectTimer;
+    QTimer* backoffTimer;
+    QTimer* stallTimer;
+
+    QElapsedTimer attemptClock;   // от connectToHost до connected
+    QElapsedTimer lossClock;      // от обрыва до восстановления
+    QElapsedTimer lastDataClock;  // от последнего блока данных
+    bool lossPending = false;
+    int consecutiveFailures = 0;
+
+    std::atomic<int> currentState { static_cast<int>(State::Idle) };
+    std::atomic<quint64> attempts { 0 };
+    std::atomic<quint64> failures { 0 };
+    std::atomic<quint64> reconnects { 0 };
+    std::atomic<quint64> stalls { 0 };
+    std::atomic<qint64> lastConnectMs { -1 };
+    std::atomic<qint64> maxConnectMs { 0 };
+    std::atomic<qint64> lastReconnectMs { -1 };
+    std::atomic<qint64> maxReconnectMs { 0 };
+};
+
+#endif // CONNECTIONMANAGER_H
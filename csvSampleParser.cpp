@@ -0,0 +1,106 @@
+#include "csvSampleParser.h"
+
+#include <charconv>
+#include <system_error>
+
+namespace {
+
+// Те же символы, что отбрасывает QString::trimmed()
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+inline void trim(const char*& begin, const char*& end)
+{
+    while (begin < end && isSpace(*begin))
+        ++begin;
+    while (end > begin && isSpace(*(end - 1)))
+        --end;
+}
+
+// QString::toLongLong()/toDouble() допускают ведущий '+', std::from_chars — нет
+inline void skipPlus(const char*& begin, const char* end)
+{
+    if (begin < end && *begin == '+' && begin + 1 < end && *(begin + 1) != '-')
+        ++begin;
+}
+
+template<typename T>
+bool parseField(const char* begin, const char* end, T& value)
+{
+    trim(begin, end);
+    skipPlus(begin, end);
+    if (begin == end)
+        return false;
+    const std::from_chars_result res = std::from_chars(begin, end, value);
+    return res.ec == std::errc() && res.ptr == end;
+}
+
+} // namespace
+
+CsvSampleParser::CsvSampleParser()
+{
+    pending.reserve(maxLineLength);
+}
+
+int CsvSampleParser::feed(const char* data, qsizetype size, QVector<SensorSample>& out)
+{
+    return feed(data, size, [&out](const SensorSample& sample) { out.append(sample); });
+}
+
+void CsvSampleParser::reset()
+{
+    pending.resize(0);
+    discardingLine = false;
+}
+
+CsvSampleParser::LineStatus CsvSampleParser::parseLine(const char* begin, const char* end, SensorSample& out)
+{
+    // Ожидается 4 параметра: timestamp, IR, Red, Temperature
+    const char* fieldBegin[4];
+    const char* fieldEnd[4];
+    int fieldCount = 0;
+    fieldBegin[0] = begin;
+    for (const char* p = begin; p < end; ++p) {
+        if (*p == ',') {
+            if (fieldCount == 3)
+                return LineStatus::FieldCountError;
+            fieldEnd[fieldCount++] = p;
+            fieldBegin[fieldCount] = p + 1;
+        }
+    }
+    fieldEnd[fieldCount++] = end;
+    if (fieldCount != 4)
+        return LineStatus::FieldCountError;
+
+    long long timestamp = 0;
+    if (!parseField(fieldBegin[0], fieldEnd[0], timestamp)
+        || !parseField(fieldBegin[1], fieldEnd[1], out.irValue)
+        || !parseField(fieldBegin[2], fieldEnd[2], out.redValue)
+        || !parseField(fieldBegin[3], fieldEnd[3], out.tempValue))
+        return LineStatus::ConversionError;
+
+    out.timestamp = static_cast<qint64>(timestamp);
+    return LineStatus::Ok;
+}
+
+bool CsvSampleParser::consumeLine(const char* begin, const char* end, SensorSample& out)
+{
+    if (end - begin > maxLineLength) {
+        ++stats.oversizedLines;
+        return false;
+    }
+    switch (parseLine(begin, end, out)) {
+    case LineStatus::Ok:
+        ++stats.linesParsed;
+        return true;
+    case LineStatus::FieldCountError:
+        ++stats.fieldCountErrors;
+        return false;
+    case LineStatus::ConversionError:
+        ++stats.conversionErrors;
+        return false;
+    }
+    return false;
+}
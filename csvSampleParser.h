@@ -0,0 +1,97 @@
+#ifndef CSVSAMPLEPARSER_H
+#define CSVSAMPLEPARSER_H
+
+#include <QByteArray>
+#include <QVector>
+#include <cstring>
+#include "sensorSample.h"
+
+// Разбор потока "timestamp,IR,Red,Temp\n" прямо по байтам, без QString/QStringList.
+// Незавершённая строка хранится во внутреннем буфере до следующего вызова feed().
+class CsvSampleParser
+{
+public:
+    enum class LineStatus { Ok, FieldCountError, ConversionError };
+
+    struct Counters {
+        quint64 linesParsed = 0;      // успешно разобранные строки
+        quint64 fieldCountErrors = 0; // число полей != 4
+        quint64 conversionErrors = 0; // поле не является числом
+        quint64 oversizedLines = 0;   // строка длиннее maxLineLength, отброшена
+    };
+
+    static constexpr qsizetype maxLineLength = 256;
+
+    CsvSampleParser();
+
+    // Разбирает очередную порцию байтов; для каждой корректной строки вызывает sink(const SensorSample&).
+    // Возвращает число разобранных отсчётов.
+    template<typename Sink>
+    int feed(const char* data, qsizetype size, Sink&& sink);
+
+    // Вариант для пакетной обработки: отсчёты добавляются в конец out
+    int feed(const char* data, qsizetype size, QVector<SensorSample>& out);
+
+    // Разбор одной строки без символа '\n'
+    static LineStatus parseLine(const char* begin, const char* end, SensorSample& out);
+
+    const Counters& counters() const { return stats; }
+    quint64 errorCount() const { return stats.fieldCountErrors + stats.conversionErrors + stats.oversizedLines; }
+    void resetCounters() { stats = Counters(); }
+
+    // Сбрасывает незавершённую строку (например, при переподключении)
+    void reset();
+    qsizetype pendingBytes() const { return pending.size(); }
+
+private:
+    bool consumeLine(const char* begin, const char* end, SensorSample& out);
+
+    QByteArray pending;
+    bool discardingLine = false; // пропускаем хвост слишком длинной строки до '\n'
+    Counters stats;
+};
+
+template<typename Sink>
+int CsvSampleParser::feed(const char* data, qsizetype size, Sink&& sink)
+{
+    int produced = 0;
+    const char* cursor = data;
+    const char* const end = data + size;
+    SensorSample sample;
+
+    while (cursor < end) {
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (!newline) {
+            // Хвост без '\n' — дожидаемся следующей порции
+            if (!discardingLine) {
+                if (pending.size() + (end - cursor) > maxLineLength) {
+                    ++stats.oversizedLines;
+                    pending.resize(0);
+                    discardingLine = true;
+                } else {
+                    pending.append(cursor, end - cursor);
+                }
+            }
+            break;
+        }
+
+        if (discardingLine) {
+            discardingLine = false;
+        } else if (!pending.isEmpty()) {
+            // Строка начата в предыдущей порции
+            pending.append(cursor, newline - cursor);
+            if (consumeLine(pending.constData(), pending.constData() + pending.size(), sample)) {
+                sink(static_cast<const SensorSample&>(sample));
+                ++produced;
+            }
+            pending.resize(0); // resize(0) сохраняет выделенную память
+        } else if (consumeLine(cursor, newline, sample)) {
+            sink(static_cast<const SensorSample&>(sample));
+            ++produced;
+        }
+        cursor = newline + 1;
+    }
+    return produced;
+}
+
+#endif // CSVSAMPLEPARSER_H
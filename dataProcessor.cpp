@@ -1,5 +1,5 @@
 #include "dataProcessor.h"
-#include <QDebug>
+#include "traceSpans.h"
 #include <QDateTime>
 #include <cmath>
 #include <QPointF>
@@ -8,88 +8,6 @@
 #include <QPen>
 #include <QBrush>
 
-// ================= MinuteAverageCalculator =================
-MinuteAverageCalculator::MinuteAverageCalculator(QLabel* avgLabel, QObject* parent)
-    : QObject(parent), avgMinuteBpmLabel(avgLabel)
-{}
-
-void MinuteAverageCalculator::addBpmValue(double bpm) {
-    bpmValues.append(bpm);
-    bpmTimeStamps.append(QDateTime::currentSecsSinceEpoch());
-    qDebug() << "Added BPM:" << bpm << "Total:" << bpmValues.size();
-}
-
-double MinuteAverageCalculator::calculateAverage(const QVector<double>& values) {
-    if (values.isEmpty())
-        return 0.0;
-    double sum = 0.0;
-    for (double v : values)
-        sum += v;
-    return sum / values.size();
-}
-
-double MinuteAverageCalculator::calculateMedian(QVector<double> values) {
-    if (values.isEmpty())
-        return 0.0;
-    std::sort(values.begin(), values.end());
-    int n = values.size();
-    if (n % 2 == 0)
-        return (values[n / 2 - 1] + values[n / 2]) / 2.0;
-    else
-        return values[n / 2];
-}
-
-void MinuteAverageCalculator::updateAverage() {
-    qDebug() << "Updating average at:" << QDateTime::currentDateTime().toString("hh:mm:ss");
-    qint64 currentTime = QDateTime::currentSecsSinceEpoch();
-
-    // Удаляем значения старше 1 минуты
-    while (!bpmTimeStamps.isEmpty() && currentTime - bpmTimeStamps.first() > 60) {
-        bpmTimeStamps.pop_front();
-        bpmValues.pop_front();
-    }
-
-    if (bpmValues.isEmpty()) {
-        avgMinuteBpmLabel->setText("Avg BPM (1 min): --");
-        return;
-    }
-
-    QVector<double> filtered = bpmValues;
-    double median = calculateMedian(filtered);
-    double lowerBound = median * 0.8;
-    double upperBound = (median > 120) ? median * 1.3 : median * 1.2;
-
-    filtered.erase(std::remove_if(filtered.begin(), filtered.end(),
-                                  [lowerBound, upperBound](double bpm) {
-                                      return bpm < lowerBound || bpm > upperBound;
-                                  }),
-                   filtered.end());
-
-    if (!filtered.isEmpty()) {
-        double avgBpm = calculateAverage(filtered);
-        double minBpm = *std::min_element(filtered.begin(), filtered.end());
-        double maxBpm = *std::max_element(filtered.begin(), filtered.end());
-        lastAverageBPM = avgBpm;
-        qDebug() << "Minute stats: average =" << avgBpm << "min =" << minBpm << "max =" << maxBpm;
-
-        QDateTime currentDt = QDateTime::currentDateTime();
-        QTime t = currentDt.time();
-        t = QTime(t.hour(), t.minute(), 0);
-        currentDt.setTime(t);
-
-        MinuteBPMData record;
-        record.minuteTimestamp = currentDt;
-        record.averageBPM = avgBpm;
-        record.minBPM = minBpm;
-        record.maxBPM = maxBpm;
-        minuteBPMRecords.append(record);
-
-        avgMinuteBpmLabel->setText("Avg BPM (1 min): " + QString::number(avgBpm, 'f', 2));
-    } else {
-        avgMinuteBpmLabel->setText("Avg BPM (1 min): --");
-    }
-}
-
 // ================= DataProcessor =================
 DataProcessor::DataProcessor(QLineSeries* bpmSeries,
                              QLineSeries* avgBpmSeries,
@@ -110,26 +28,17 @@ DataProcessor::DataProcessor(QLineSeries* bpmSeries,
     tempSeries(tempSeries),
     spo2Series(spo2Series),
     spo2PeakSeries(spo2PeakSeries),
+    redSeries(new QLineSeries()),
+    spectralBpmSeries(new QLineSeries()),
     irAxisX(irAxisX),
     bpmAxisX(bpmAxisX),
     avgBpmAxisX(avgBpmAxisX),
     tempAxisX(tempAxisX),
     redAxisX(redAxisX),
     spo2AxisX(spo2AxisX),
-    minuteCalculator(avgLabel, nullptr),
-    timeStart(0),
-    lastReceivedTimestamp(0),
-    lastPeakTime(0),
-    redSeries(new QLineSeries()),
-    peakState(WAITING),
-    previousValue(0.0),
-    candidatePeak(0.0),
-    candidateTime(0),
-    dropThreshold(0.001), // Порог падения 0.1%
-    windowSize(5),  // Размер окна для детекции пика
-    spo2WindowMs(4000)
+    statisticsLabel(avgLabel)
 {
-    qDebug() << "DataProcessor constructor completed";
+    signalProcessor.setObserver(&pendingCollector);
 
     // Создаем серию для пиков и настраиваем её внешний вид:
     peakSeries = new QScatterSeries();
@@ -149,6 +58,7 @@ DataProcessor::~DataProcessor() {
 
     maybeDelete(peakSeries);
     maybeDelete(redSeries);
+    maybeDelete(spectralBpmSeries);
     maybeDelete(bpmSeries);
     maybeDelete(avgBpmSeries);
     maybeDelete(irSeries);
@@ -164,188 +74,133 @@ DataProcessor::~DataProcessor() {
     maybeDelete(spo2AxisX);
 }
 
-double DataProcessor::calculateAverage(const QVector<double>& values) {
-    if (values.isEmpty())
-        return 0;
-    double sum = 0;
-    for (double v : values)
-        sum += v;
-    return sum / values.size();
+void DataProcessor::processBatch(const SensorSample* samples, int count) {
+    pendingEvents.resize(0);
+    signalProcessor.processBatch(samples, count);
+    applyEvents(pendingEvents.constData(), pendingEvents.size());
 }
 
-double DataProcessor::calculateAverage(const QQueue<std::pair<qint64, double>>& values) {
-    if (values.isEmpty())
-        return 0.0;
-    double sum = 0.0;
-    for (const auto &p : values)
-        sum += p.second;
-    return sum / values.size();
-}
-
-double DataProcessor::detectSpO2(double irValue, double redValue) {
-    // Логика расчёта SpO₂ может быть реализована здесь
-    return 0.0;
+void DataProcessor::processValues(qint64 timestamp, double infraredValue, double redValue, double temperatureValue) {
+    const SensorSample sample = {timestamp, infraredValue, redValue, temperatureValue};
+    processBatch(&sample, 1);
 }
 
-// Сохраняем старую функцию, если понадобится (но новый алгоритм в processValues используется для пиков)
-bool DataProcessor::detectPeakImproved(double irValue, qint64 timestamp) {
-    bool peakDetected = false;
-    if (peakState == WAITING) {
-        if (irValue > previousValue) {
-            peakState = RISING;
-            candidatePeak = irValue;
-            candidateTime = timestamp;
+void DataProcessor::applyEvents(const PipelineEvent* events, int count, double* sessionTimes) {
+    // Графики здесь не трогаем: их перестраивает render() с частотой кадров
+    TRACE_SPAN("DataProcessor::applyEvents");
+    bool bpmAdded = false;
+    for (int i = 0; i < count; ++i) {
+        const PipelineEvent& event = events[i];
+        sessionHistory.apply(event);
+        if (event.type == PipelineEvent::Sample && bpmStatistics.getStartEpochMs() < 0) {
+            // Минуты в экспорте подписываются временем начала сессии: при воспроизведении оно задано
+            // из записи, при живом подключении — часы хоста при первом отсчёте
+            if (sessionHistory.getStartEpochMs() < 0)
+                sessionHistory.setStartEpochMs(QDateTime::currentMSecsSinceEpoch());
+            bpmStatistics.setStartEpochMs(sessionHistory.getStartEpochMs(), sessionHistory.getStartTime());
         }
-    } else if (peakState == RISING) {
-        if (irValue > candidatePeak) {
-            candidatePeak = irValue;
-            candidateTime = timestamp;
-        } else if (irValue < candidatePeak * (1 - dropThreshold)) {
-            peakDetected = true;
-            peakState = WAITING;
+        if (sessionTimes)
+            sessionTimes[i] = sessionHistory.sessionTimeSec(event);
+        if (event.type == PipelineEvent::Peak) {
+            // На той же оси времени сессии, что и история
+            peakPoints.append(QPointF(sessionHistory.sessionTimeSec(event), event.value));
+        } else if (event.type == PipelineEvent::Bpm) {
+            TRACE_SPAN("BpmStatistics::addBpm");
+            bpmAdded |= bpmStatistics.addBpm(event.timestamp, event.value);
         }
     }
-    previousValue = irValue;
-    return peakDetected;
+    if (bpmAdded)
+        updateStatisticsLabel();
+    // Показанный интервал истории от новых данных не меняется
+    if (count > 0 && followLive)
+        dirty = true;
 }
 
-void DataProcessor::processValues(qint64 timestamp, double infraredValue, double redValue, double temperatureValue) {
-    // Если timeStart еще не установлен, сохраняем первую временную метку
-    if (timeStart == 0)
-        timeStart = timestamp;
-    // Вычисляем время относительно первого значения (начало = 0)
-    double currentTimeSec = static_cast<double>(timestamp - timeStart) / 1000.0;
-    lastReceivedTimestamp = timestamp;
-    qDebug() << "Processing IR=" << infraredValue
-             << ", Red=" << redValue
-             << ", Temp=" << temperatureValue
-             << ", currentTimeSec=" << currentTimeSec;
-
-    // Обновляем буферы с учётом времени для метода AC/DC
-    irBuffer.push_back({timestamp, infraredValue});
-    redBuffer.push_back({timestamp, redValue});
-    while (!irBuffer.isEmpty() && timestamp - irBuffer.front().first > spo2WindowMs)
-        irBuffer.pop_front();
-    while (!redBuffer.isEmpty() && timestamp - redBuffer.front().first > spo2WindowMs)
-        redBuffer.pop_front();
-
-    double infraredDC = calculateAverage(irBuffer);
-    double redDC = calculateAverage(redBuffer);
-    double infraredAC = infraredValue - infraredDC;
-    double redAC = redValue - redDC;
-
-    // Расчёт SpO₂, если данные валидны
-    if (infraredDC != 0 && redDC != 0 && infraredAC > 0 && redAC > 0) {
-        double ratioR = (redAC / redDC) / (infraredAC / infraredDC);
-        int spo2 = static_cast<int>(110 - 25.0 * ratioR);
-        spo2 = qBound(80, spo2, 100);
-        qDebug() << "Calculated SpO₂=" << spo2;
-        spo2Series->append(currentTimeSec, spo2);
-        allSpo2Data.append(QPointF(currentTimeSec, spo2));
-    }
-
-    // Сохраняем данные для экспорта и добавляем их в графики
-    allIRData.append(QPointF(currentTimeSec, infraredValue));
-    allRedData.append(QPointF(currentTimeSec, redValue));
-    allTempData.append(QPointF(currentTimeSec, temperatureValue));
-
-    irSeries->append(currentTimeSec, infraredValue);
-    redSeries->append(currentTimeSec, redValue);
-    tempSeries->append(currentTimeSec, temperatureValue);
-
-    // Обновляем диапазон оси X для отображения последних 20 секунд
-    if (currentTimeSec >= 20.0) {
-        irAxisX->setRange(currentTimeSec - 20.0, currentTimeSec);
-        bpmAxisX->setRange(currentTimeSec - 20.0, currentTimeSec);
-        avgBpmAxisX->setRange(currentTimeSec - 20.0, currentTimeSec);
-        tempAxisX->setRange(currentTimeSec - 20.0, currentTimeSec);
-        redAxisX->setRange(currentTimeSec - 20.0, currentTimeSec);
-        spo2AxisX->setRange(currentTimeSec - 20.0, currentTimeSec);
-    } else {
-        irAxisX->setRange(0.0, 20.0);
-        bpmAxisX->setRange(0.0, 20.0);
-        avgBpmAxisX->setRange(0.0, 20.0);
-        tempAxisX->setRange(0.0, 20.0);
-        redAxisX->setRange(0.0, 20.0);
-        spo2AxisX->setRange(0.0, 20.0);
-    }
+void DataProcessor::updateStatisticsLabel() {
+    // Скользящие окна по времени датчика: среднее, а для минуты — ещё медиана и размах
+    const RollingStatistics& stats = bpmStatistics.statistics();
+    const WindowStats minute = stats.sliding(BpmStatistics::OneMinute);
+    QString text = QString("BPM 10 s: %1 | 1 min: %2 (median %3, %4–%5) | 5 min: %6 | 1 h: %7")
+                       .arg(stats.sliding(BpmStatistics::TenSeconds).mean, 0, 'f', 1)
+                       .arg(minute.mean, 0, 'f', 1)
+                       .arg(minute.median, 0, 'f', 1)
+                       .arg(minute.minimum, 0, 'f', 0)
+                       .arg(minute.maximum, 0, 'f', 0)
+                       .arg(stats.sliding(BpmStatistics::FiveMinutes).mean, 0, 'f', 1)
+                       .arg(stats.sliding(BpmStatistics::OneHour).mean, 0, 'f', 1);
+    statisticsLabel->setText(text);
+}
 
-    // --- Алгоритм детекции пиков с использованием окна ---
-    // Добавляем текущую точку в окно
-    peakWindowValues.push_back(infraredValue);
-    peakWindowTimestamps.push_back(timestamp);
+void DataProcessor::setFollowLive(bool follow) {
+    if (follow == followLive)
+        return;
+    followLive = follow;
+    dirty = true;
+}
 
-    // Копим данные между пиками для метода 2
-    intervalIrValues.push_back(infraredValue);
-    intervalRedValues.push_back(redValue);
+void DataProcessor::setHistoryRange(double fromSec, double toSec) {
+    if (toSec <= fromSec)
+        return;
+    historyFromSec = fromSec;
+    historyToSec = toSec;
+    if (!followLive)
+        dirty = true;
+}
 
-    // Если окно превышает размер, удаляем самую старую точку
-    if (peakWindowValues.size() > windowSize) {
-        peakWindowValues.pop_front();
-        peakWindowTimestamps.pop_front();
+bool DataProcessor::render(int columns) {
+    if (!dirty || columns <= 0)
+        return false;
+    dirty = false;
+    TRACE_SPAN("DataProcessor::render");
+
+    double fromSec = historyFromSec;
+    double toSec = historyToSec;
+    if (followLive) {
+        // Последние 20 секунд; в начале сессии — первые 20
+        toSec = qMax(liveWindowSec, sessionHistory.getElapsedTime());
+        fromSec = toSec - liveWindowSec;
     }
+    setTimeRange(fromSec, toSec);
+
+    // replace() — одна перестройка серии вместо тысяч append(); не больше двух точек на столбец
+    const SampleStore& samples = sessionHistory.samples();
+    const MinMaxPyramid& pyramid = sessionHistory.pyramid();
+    const qint64 origin = sessionHistory.getStartTime();
+    const qint64 fromMs = origin + qint64(fromSec * 1000.0);
+    const qint64 toMs = origin + qint64(toSec * 1000.0);
+    pyramid.envelope(samples, MinMaxPyramid::Ir, fromMs, toMs, columns, origin, framePoints);
+    irSeries->replace(framePoints);
+    pyramid.envelope(samples, MinMaxPyramid::Red, fromMs, toMs, columns, origin, framePoints);
+    redSeries->replace(framePoints);
+    pyramid.envelope(samples, MinMaxPyramid::Temp, fromMs, toMs, columns, origin, framePoints);
+    tempSeries->replace(framePoints);
+
+    decimatePoints(sessionHistory.getAllBpmData(), fromSec, toSec, columns, framePoints);
+    bpmSeries->replace(framePoints);
+    decimatePoints(sessionHistory.getAllSpectralBpmData(), fromSec, toSec, columns, framePoints);
+    spectralBpmSeries->replace(framePoints);
+    decimatePoints(sessionHistory.getAllAvgBpmData(), fromSec, toSec, columns, framePoints);
+    avgBpmSeries->replace(framePoints);
+    decimatePoints(sessionHistory.getAllSpo2Data(), fromSec, toSec, columns, framePoints);
+    spo2Series->replace(framePoints);
+    decimatePoints(sessionHistory.getAllSpo2PeakData(), fromSec, toSec, columns, framePoints);
+    spo2PeakSeries->replace(framePoints);
+    decimatePoints(peakPoints, fromSec, toSec, columns, framePoints);
+    peakSeries->replace(framePoints);
+    return true;
+}
 
-    // Если в окне ровно windowSize точек, проверяем центральную точку
-    if (peakWindowValues.size() == windowSize) {
-        int mid = windowSize / 2; // для windowSize=5, mid=2
-        bool isPeak = true;
-        for (int i = 0; i < windowSize; i++) {
-            if (i == mid)
-                continue;
-            if (peakWindowValues[mid] <= peakWindowValues[i]) {
-                isPeak = false;
-                break;
-            }
-        }
-        if (isPeak) {
-            qint64 detectedPeakTime = peakWindowTimestamps[mid];
-            // Вводим рефрактерный период: если предыдущий пик отсутствует или разница > 300 мс
-            if (lastPeakTime == 0 || (detectedPeakTime - lastPeakTime) > 300) {
-                double peakTimeSec = static_cast<double>(detectedPeakTime - timeStart) / 1000.0;
-                // Добавляем красную точку в серию пиков
-                peakSeries->append(peakTimeSec, peakWindowValues[mid]);
-                // Если имеется предыдущий пик, можно вычислить интервал для BPM
-                if (lastPeakTime != 0) {
-                    int deltaMs = static_cast<int>(detectedPeakTime - lastPeakTime);
-                    qDebug() << "Peak interval (ms):" << deltaMs;
-                    if (deltaMs > 500 && deltaMs < 1333) {
-                        double bpm = 60000.0 / deltaMs;
-                        qDebug() << "Calculated BPM:" << bpm;
-                        bpmValues.push_back(bpm);
-                        if (bpmValues.size() > 3)
-                            bpmValues.pop_front();
-                        double avgBpmLocal = calculateAverage(bpmValues);
-                        bpmSeries->append(peakTimeSec, bpm);
-                        avgBpmSeries->append(peakTimeSec, avgBpmLocal);
-                        allBpmData.append(QPointF(peakTimeSec, bpm));
-                        allAvgBpmData.append(QPointF(peakTimeSec, avgBpmLocal));
-                        minuteCalculator.addBpmValue(bpm);
-                    }
-                }
-                if (lastPeakTime != 0 && !intervalIrValues.isEmpty() && !intervalRedValues.isEmpty()) {
-                    double irMax = *std::max_element(intervalIrValues.begin(), intervalIrValues.end());
-                    double irMin = *std::min_element(intervalIrValues.begin(), intervalIrValues.end());
-                    double redMax = *std::max_element(intervalRedValues.begin(), intervalRedValues.end());
-                    double redMin = *std::min_element(intervalRedValues.begin(), intervalRedValues.end());
-                    double irAC = irMax - irMin;
-                    double redAC = redMax - redMin;
-                    double irDC = (irMax + irMin) / 2.0;
-                    double redDC = (redMax + redMin) / 2.0;
-                    if (irAC > 0 && redAC > 0 && irDC > 0 && redDC > 0) {
-                        double R = (redAC / redDC) / (irAC / irDC);
-                        int spo2p = static_cast<int>(110 - 25.0 * R);
-                        spo2p = qBound(80, spo2p, 100);
-                        spo2PeakSeries->append(peakTimeSec, spo2p);
-                        allSpo2PeakData.append(QPointF(peakTimeSec, spo2p));
-                    }
-                }
-                intervalIrValues.clear();
-                intervalRedValues.clear();
-                intervalIrValues.push_back(infraredValue);
-                intervalRedValues.push_back(redValue);
-                lastPeakTime = detectedPeakTime;
-            }
-        }
-    }
-    // --- Конец алгоритма детекции пиков ---
+void DataProcessor::setTimeRange(double fromSec, double toSec) {
+    // Оси X всех графиков общие; без изменения диапазона не трогаем их вовсе
+    if (fromSec == shownFromSec && toSec == shownToSec)
+        return;
+    TRACE_SPAN("DataProcessor::setTimeRange");
+    shownFromSec = fromSec;
+    shownToSec = toSec;
+    irAxisX->setRange(fromSec, toSec);
+    bpmAxisX->setRange(fromSec, toSec);
+    avgBpmAxisX->setRange(fromSec, toSec);
+    tempAxisX->setRange(fromSec, toSec);
+    redAxisX->setRange(fromSec, toSec);
+    spo2AxisX->setRange(fromSec, toSec);
 }
@@ -5,7 +5,6 @@
 #include <QValueAxis>
 #include <QVector>
 #include <QQueue>
-#include <QDeque>
 #include <utility>
 #include <QLabel>
 #include <QDateTime>
@@ -14,36 +13,13 @@
 #include <QPointF>
 #include <QList>
 #include <QScatterSeries>  // Для отображения пиков
+#include "minuteStatistics.h"
+#include "pipelineEvent.h"
+#include "sessionHistory.h"
+#include "signalProcessor.h"
 
-// Структура для хранения данных по BPM за 1 минуту
-struct MinuteBPMData {
-    QDateTime minuteTimestamp; // Время (начало минуты, локальное)
-    double averageBPM;
-    double minBPM;
-    double maxBPM;
-};
-
-class MinuteAverageCalculator : public QObject
-{
-    Q_OBJECT
-public:
-    explicit MinuteAverageCalculator(QLabel* avgLabel, QObject* parent = nullptr);
-    void addBpmValue(double bpm);
-    void updateAverage();
-    double getLastAverage() const { return lastAverageBPM; }
-    const QVector<MinuteBPMData>& getMinuteBPMRecords() const { return minuteBPMRecords; }
-
-private:
-    double calculateAverage(const QVector<double>& values);
-    double calculateAverage(const QQueue<std::pair<qint64, double>>& values);
-    double calculateMedian(QVector<double> values);
-    QVector<double> bpmValues;
-    QVector<qint64> bpmTimeStamps;
-    double lastAverageBPM = 0.0;
-    QLabel* avgMinuteBpmLabel;
-    QVector<MinuteBPMData> minuteBPMRecords;
-};
-
+// Отображение результатов обработки: серии графиков, оси, накопленные данные для экспорта.
+// Сама обработка сигнала выполняется SignalProcessor (в том числе в отдельном потоке, см. IngestWorker).
 class DataProcessor
 {
 public:
@@ -63,14 +39,38 @@ public:
 
     ~DataProcessor();
 
+    // Синхронный путь: обработка блока отсчётов; графики обновит следующий render()
+    void processBatch(const SensorSample* samples, int count);
+    // Один отсчёт — частный случай processBatch()
     void processValues(qint64 timestamp, double irValue, double redValue, double tempValue);
-    bool detectPeakImproved(double irValue, qint64 timestamp);
-    double calculateAverage(const QVector<double>& values);
-    double calculateAverage(const QDeque<std::pair<qint64, double>>& values);
-    double detectSpO2(double irValue, double redValue);
 
-    qint64 getStartTime() const { return timeStart; }
-    double getElapsedTime() const { return (static_cast<double>(lastReceivedTimestamp - timeStart)) / 1000.0; }
+    // Применение готовых результатов обработки (поток GUI): только накопление, без графиков.
+    // sessionTimes (count значений) — время каждого события на оси сессии в момент применения:
+    // перезапуск ESP32 посреди блока сдвигает только события после него
+    void applyEvents(const PipelineEvent* events, int count, double* sessionTimes = nullptr);
+
+    // Живой режим: графики показывают последние 20 с. Вне его новые отсчёты только накапливаются
+    // в истории, а графики показывают интервал setHistoryRange()
+    void setFollowLive(bool follow);
+    bool followsLive() const { return followLive; }
+    void setHistoryRange(double fromSec, double toSec);
+
+    // Один кадр: если с прошлого кадра что-то изменилось, каждая серия заменяется одним replace()
+    // прореженным видом показанного интервала (IR/Red/Temp — огибающая из пирамиды, не больше
+    // двух точек на столбец графика шириной columns), оси X выставляются один раз.
+    // Стоимость кадра зависит от ширины графика, а не от частоты отсчётов и длины сессии.
+    // Возвращает false, если перерисовывать было нечего.
+    bool render(int columns);
+
+    qint64 getStartTime() const { return sessionHistory.getStartTime(); }
+    // Настенное время начала сессии из метаданных (запись при воспроизведении); задаётся до данных
+    void setStartEpochMs(qint64 epochMs) { sessionHistory.setStartEpochMs(epochMs); }
+    double getElapsedTime() const { return sessionHistory.getElapsedTime(); }
+
+    // Накопленные данные для экспорта
+    const SessionHistory& history() const { return sessionHistory; }
+    // Пики IR, (время, значение)
+    const QVector<QPointF>& peaks() const { return peakPoints; }
 
     QLineSeries* getIRSeries() const { return irSeries; }
     QLineSeries* getRedSeries() const { return redSeries; }
@@ -79,18 +79,17 @@ public:
     QLineSeries* getTempSeries() const { return tempSeries; }
     QLineSeries* getSpo2Series() const { return spo2Series; }
     QLineSeries* getSpo2PeakSeries() const { return spo2PeakSeries; }
+    QLineSeries* getSpectralBpmSeries() const { return spectralBpmSeries; }
     // Геттер для серии пиков (QScatterSeries)
     QScatterSeries* getPeakSeries() const { return peakSeries; }
 
-    const QVector<QPointF>& getAllIRData() const { return allIRData; }
-    const QVector<QPointF>& getAllRedData() const { return allRedData; }
-    const QVector<QPointF>& getAllTempData() const { return allTempData; }
-    const QVector<QPointF>& getAllBpmData() const { return allBpmData; }
-    const QVector<QPointF>& getAllAvgBpmData() const { return allAvgBpmData; }
-    const QVector<QPointF>& getAllSpo2Data() const { return allSpo2Data; }
-    const QVector<QPointF>& getAllSpo2PeakData() const { return allSpo2PeakData; }
+    const QVector<QPointF>& getAllBpmData() const { return sessionHistory.getAllBpmData(); }
+    const QVector<QPointF>& getAllAvgBpmData() const { return sessionHistory.getAllAvgBpmData(); }
+    const SeriesStore& getAllSpo2Data() const { return sessionHistory.getAllSpo2Data(); }
+    const QVector<QPointF>& getAllSpo2PeakData() const { return sessionHistory.getAllSpo2PeakData(); }
 
-    const MinuteAverageCalculator* getMinuteCalculator() const { return &minuteCalculator; }
+    // Статистика BPM по времени датчика (10 с, 1 мин, 5 мин, 1 ч) и поминутные записи для экспорта
+    const BpmStatistics& getBpmStatistics() const { return bpmStatistics; }
 
     QValueAxis* getIrAxisX() const { return irAxisX; }
     QValueAxis* getBpmAxisX() const { return bpmAxisX; }
@@ -99,10 +98,12 @@ public:
     QValueAxis* getRedAxisX() const { return redAxisX; }
     QValueAxis* getSpo2AxisX() const { return spo2AxisX; }
 
-public:
-    enum PeakState { WAITING, RISING };
-
 private:
+    void setTimeRange(double fromSec, double toSec);
+    void updateStatisticsLabel();
+
+    static constexpr double liveWindowSec = 20.0;
+
     QLineSeries* bpmSeries;
     QLineSeries* avgBpmSeries;
     QLineSeries* irSeries;
@@ -110,14 +111,9 @@ private:
     QLineSeries* spo2Series;
     QLineSeries* spo2PeakSeries;
     QLineSeries* redSeries;  // Серия для Red
+    QLineSeries* spectralBpmSeries; // BPM по спектру — на графике BPM рядом с BPM по пикам
 
-    QVector<QPointF> allIRData;
-    QVector<QPointF> allRedData;
-    QVector<QPointF> allTempData;
-    QVector<QPointF> allBpmData;
-    QVector<QPointF> allAvgBpmData;
-    QVector<QPointF> allSpo2Data;
-    QVector<QPointF> allSpo2PeakData;
+    SessionHistory sessionHistory;
 
     QValueAxis* irAxisX;
     QValueAxis* bpmAxisX;
@@ -126,28 +122,21 @@ private:
     QValueAxis* redAxisX;
     QValueAxis* spo2AxisX;
 
-    QVector<double> bpmValues;
-    qint64 timeStart;
-    qint64 lastReceivedTimestamp;
-    qint64 lastPeakTime;
-
-    MinuteAverageCalculator minuteCalculator;
-    QQueue<std::pair<qint64, double>> redBuffer;
-    QQueue<std::pair<qint64, double>> irBuffer;
-    QVector<double> intervalIrValues;
-    QVector<double> intervalRedValues;
-    const int spo2WindowMs;
-
-    // Для детекции пиков по окну:
-    QVector<double> peakWindowValues;
-    QVector<qint64> peakWindowTimestamps;
-    const int windowSize;  // размер окна (например, 5)
-
-    PeakState peakState;
-    double previousValue;
-    double candidatePeak;
-    qint64 candidateTime;
-    const double dropThreshold;
+    BpmStatistics bpmStatistics;
+    QLabel* statisticsLabel;
+    bool followLive = true;
+    bool dirty = false;
+    double historyFromSec = 0.0;
+    double historyToSec = liveWindowSec;
+    double shownFromSec = -1.0; // диапазон осей X на экране
+    double shownToSec = -1.0;
+    QVector<QPointF> peakPoints;  // пики для графика IR (в истории сессии их нет)
+    QVector<QPointF> framePoints; // буфер кадра, память переиспользуется
+
+    // Обработка для синхронного пути processValues()
+    SignalProcessor signalProcessor;
+    QVector<PipelineEvent> pendingEvents;
+    PipelineEventCollector pendingCollector { pendingEvents };
 
     // Серия для отображения пиков (красные точки)
     QScatterSeries* peakSeries;
@@ -1,31 +1,69 @@
 #include "dataReceiver.h"
-#include <QDebug>
+#include "streamRecording.h"
+#include "traceSpans.h"
+#include <QMetaMethod>
 
 DataReceiver::DataReceiver(QTcpSocket* socket, QObject* parent)
-    : QObject(parent), socket(socket) {}
+    : QObject(parent), socket(socket)
+{
+    // Обрывок строки от предыдущего соединения не должен склеиваться с новыми данными
+    if (socket)
+        connect(socket, &QTcpSocket::connected, this, &DataReceiver::resetStream);
+}
+
+void DataReceiver::resetStream() {
+    streamDecoder.reset();
+    if (streamRecorder)
+        streamRecorder->recordStreamReset();
+}
+
+void DataReceiver::feedChunk(const QByteArray& data) {
+    feed(data.constData(), data.size(), monotonicNs());
+}
 
 void DataReceiver::readData() {
-    while (socket->canReadLine()) {  // Читаем данные по строкам
-        QString line = socket->readLine().trimmed();
-        qDebug() << "Received:" << line;
-
-        // Разбиваем строку по запятой
-        QStringList parts = line.split(",");
-        if (parts.size() == 4) { // Ожидается 4 параметра: timestamp, IR, Red, Temperature
-            bool okTimestamp, ok1, ok2, ok3;
-            // Первый параметр — временная метка в миллисекундах
-            qint64 timestamp = parts[0].trimmed().toLongLong(&okTimestamp);
-            double irValue = parts[1].trimmed().toDouble(&ok1);
-            double redValue = parts[2].trimmed().toDouble(&ok2);
-            double tempValue = parts[3].trimmed().toDouble(&ok3);
-
-            if (okTimestamp && ok1 && ok2 && ok3) {
-                emit dataReady(timestamp, irValue, redValue, tempValue);
-            } else {
-                qDebug() << "Invalid data format: Conversion error.";
-            }
-        } else {
-            qDebug() << "Data format error: Expected 4 parameters, got" << parts.size();
+    if (!socket)
+        return;
+    const qint64 available = qMin(socket->bytesAvailable(), maxBytesPerRead);
+    if (available <= 0)
+        return;
+    const qint64 startNs = monotonicNs();
+    TRACE_SPAN("DataReceiver::readData");
+
+    // Буфер растёт только при необходимости, повторного выделения памяти на каждом вызове нет
+    if (receiveBuffer.size() < available)
+        receiveBuffer.resize(available);
+    const qint64 bytesRead = socket->read(receiveBuffer.data(), available);
+    if (bytesRead <= 0)
+        return;
+
+    // Остаток данных — отдельным событием, после сокетов других устройств этого потока
+    if (socket->bytesAvailable() > 0)
+        QMetaObject::invokeMethod(this, &DataReceiver::readData, Qt::QueuedConnection);
+
+    if (streamRecorder)
+        streamRecorder->recordData(receiveBuffer.constData(), bytesRead);
+    feed(receiveBuffer.constData(), bytesRead, startNs);
+}
+
+void DataReceiver::feed(const char* data, qsizetype size, qint64 startNs) {
+    // Данные разбираются прямо в буфере; незавершённая строка/кадр остаётся в декодере до следующего блока
+    batch.resize(0);
+    {
+        TRACE_SPAN("SampleStreamDecoder::feed");
+        streamDecoder.feed(data, size, batch);
+    }
+    if (decodeLatency)
+        decodeLatency->record(monotonicNs() - startNs);
+    if (!batch.isEmpty()) {
+        chunkStartNs = startNs;
+        emit dataBatchReady(batch);
+
+        static const QMetaMethod dataReadySignal = QMetaMethod::fromSignal(&DataReceiver::dataReady);
+        if (isSignalConnected(dataReadySignal)) {
+            for (const SensorSample& sample : std::as_const(batch))
+                emit dataReady(sample.timestamp, sample.irValue, sample.redValue, sample.tempValue);
         }
     }
+    emit decodeStatsChanged();
 }
@@ -3,19 +3,63 @@
 
 #include <QTcpSocket>
 #include <QObject>
+#include <QByteArray>
+#include <QVector>
+#include "pipelineStats.h"
+#include "sampleStreamDecoder.h"
+
+class StreamRecorder;
 
 class DataReceiver : public QObject {
     Q_OBJECT
 public:
+    // За один вызов readData() читается не больше этого объёма; остаток дочитывается
+    // следующим событием, чтобы один поток данных не занимал поток обработки целиком
+    static constexpr qint64 maxBytesPerRead = 64 * 1024;
+
+    // socket может быть nullptr — тогда данные подаются через feedChunk() (воспроизведение записи)
     explicit DataReceiver(QTcpSocket* socket, QObject* parent = nullptr);
     void readData();
 
+    // Сырые байты каждого readData() дополнительно пишутся в recorder (nullptr — не писать)
+    void setRecorder(StreamRecorder* recorder) { streamRecorder = recorder; }
+
+    // Счётчики разбора (успешные отсчёты и ошибки формата) вместо qDebug на каждую строку
+    const SampleStreamDecoder& decoder() const { return streamDecoder; }
+
+    // Время от начала чтения блока до разобранных отсчётов (nullptr — не измерять)
+    void setDecodeLatency(LatencyHistogram* histogram) { decodeLatency = histogram; }
+    // monotonicNs() начала чтения текущего блока — для обработчиков dataBatchReady
+    qint64 chunkReceivedNs() const { return chunkStartNs; }
+
+public slots:
+    // Блок байтов из другого источника — разбирается так же, как данные сокета
+    void feedChunk(const QByteArray& data);
+    //! Начало нового потока (новое соединение)
+    void resetStream();
+
 signals:
-    // Сигнал передает временную метку (в мс) и три значения с датчика
+    // Все отсчёты, разобранные за один readyRead, одним непрерывным блоком
+    void dataBatchReady(const QVector<SensorSample>& samples);
+
+    // После каждого разобранного блока, даже без единого отсчёта (сплошь испорченные строки/кадры) —
+    // чтобы счётчики decoder() обновлялись и при потоке мусора
+    void decodeStatsChanged();
+
+    // Сигнал передает временную метку (в мс) и три значения с датчика.
+    // Испускается только при наличии подписчиков (совместимость с прежним API)
     void dataReady(qint64 timestamp, double irValue, double redValue, double tempValue);
 
 private:
+    void feed(const char* data, qsizetype size, qint64 startNs);
+
     QTcpSocket* socket;
+    StreamRecorder* streamRecorder = nullptr;
+    QByteArray receiveBuffer; // переиспользуется между вызовами readData()
+    QVector<SensorSample> batch; // то же для разобранных отсчётов
+    SampleStreamDecoder streamDecoder; // CSV или двоичные кадры, определяется автоматически
+    LatencyHistogram* decodeLatency = nullptr;
+    qint64 chunkStartNs = 0;
 };
 
 #endif // DATARECEIVER_H
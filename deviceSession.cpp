@@ -0,0 +1,176 @@
+#include "deviceSession.h"
+#include "sessionView.h"
+#include "streamRecording.h"
+#include "traceSpans.h"
+
+DeviceSession::DeviceSession(const Config& config, QObject* parent)
+    : QObject(parent)
+    , sessionConfig(config)
+{
+    // Метка статистики BPM по окнам 10 с … 1 ч
+    averageMinuteBpmLabel = new QLabel("BPM: --");
+
+    // Серия для SpO₂
+    QLineSeries *bloodOxygenSaturationSeries = new QLineSeries();
+    bloodOxygenSaturationSeries->setName("SpO₂ AC/DC");
+    QLineSeries *bloodOxygenSaturationPeakSeries = new QLineSeries();
+    bloodOxygenSaturationPeakSeries->setName("SpO₂ Peaks");
+
+    // Создаем оси для графиков (отображение в секундах)
+    QValueAxis *axisIrX   = new QValueAxis();
+    QValueAxis *axisBpmX  = new QValueAxis();
+    QValueAxis *axisAvgX  = new QValueAxis();
+    QValueAxis *axisTempX = new QValueAxis();
+    QValueAxis *axisRedX  = new QValueAxis();
+    QValueAxis *axisSpo2X = new QValueAxis();
+
+    // Инициализация DataProcessor – внутри он работает с миллисекундами,
+    // а для графиков конвертирует время в секунды
+    dataProcessor = new DataProcessor(
+        new QLineSeries(), // BPM series
+        new QLineSeries(), // Avg BPM series
+        new QLineSeries(), // IR series
+        new QLineSeries(), // Temperature series
+        bloodOxygenSaturationSeries, // SpO₂ series
+        bloodOxygenSaturationPeakSeries, // SpO₂ by peaks
+        axisIrX, axisBpmX, axisAvgX, axisTempX, axisRedX, axisSpo2X,
+        averageMinuteBpmLabel
+        );
+
+    // Виджет графиков; владельцем становится окно, в которое его поместят
+    sessionView = new SessionView(dataProcessor, averageMinuteBpmLabel);
+
+    // Без родителя: объект перемещается в поток пула и удаляется при его завершении
+    ingestWorker = new IngestWorker(config.host, config.port, config.connection);
+    ingestWorker->setRecordFile(config.recordFile);
+    ingestWorker->setSpo2WindowMs(config.spo2WindowMs);
+    ingestWorker->setPeakFilter(config.peakFilter);
+    ingestWorker->setSpectralHeartRate(config.spectralHeartRate);
+    SessionJournal::Settings journalSettings = config.journal;
+    if (!config.replayFile.isEmpty()) {
+        ingestWorker->setReplay(config.replayFile, config.replaySpeed);
+        // Время сессии — из заголовка записи, а не часы хоста во время воспроизведения
+        StreamRecordingReader recording;
+        if (recording.open(config.replayFile)) {
+            dataProcessor->setStartEpochMs(recording.startEpochMs());
+            journalSettings.startEpochMs = recording.startEpochMs();
+        }
+    }
+    if (!journalSettings.directory.isEmpty()) {
+        sessionJournal = new SessionJournal(journalSettings);
+        sessionJournal->start();
+        ingestWorker->setJournal(sessionJournal);
+    }
+
+    drainBuffer.resize(4096);
+    drainTimes.resize(drainBuffer.size());
+}
+
+DeviceSession::~DeviceSession()
+{
+    // Графики ещё живы (принадлежат SessionView), поэтому серии и оси DataProcessor не удаляет
+    delete dataProcessor;
+    // Потоки обработки к этому времени остановлены менеджером — журнал больше никто не пополняет
+    delete sessionJournal;
+}
+
+void DeviceSession::setHost(const QString& host)
+{
+    sessionConfig.host = host;
+    QMetaObject::invokeMethod(ingestWorker, [worker = ingestWorker, host]() {
+        worker->setHost(host);
+    }, Qt::QueuedConnection);
+}
+
+void DeviceSession::setSpo2WindowMs(int windowMs)
+{
+    sessionConfig.spo2WindowMs = windowMs;
+    QMetaObject::invokeMethod(ingestWorker, [worker = ingestWorker, windowMs]() {
+        worker->setSpo2WindowMs(windowMs);
+    }, Qt::QueuedConnection);
+}
+
+void DeviceSession::drain()
+{
+    TRACE_SPAN("DeviceSession::drain");
+    SpscRingBuffer<PipelineEvent>& ring = ingestWorker->events();
+    int count;
+    bool drained = false;
+    while ((count = ring.tryPop(drainBuffer.data(), drainBuffer.size())) > 0) {
+        drained = true;
+        dataProcessor->applyEvents(drainBuffer.constData(), count, drainTimes.data());
+        sessionView->appendLive(drainBuffer.constData(), drainTimes.constData(), count);
+
+        for (int i = 0; i < count; ++i) {
+            const PipelineEvent& event = drainBuffer[i];
+            switch (event.type) {
+            case PipelineEvent::Bpm:
+                lastValues.lastBpm = event.value;
+                lastValues.lastAvgBpm = event.value2;
+                break;
+            case PipelineEvent::Spo2:
+                lastValues.lastSpo2 = event.value;
+                break;
+            case PipelineEvent::Spo2Peak:
+                lastValues.lastSpo2Peak = event.value;
+                break;
+            case PipelineEvent::SpectralBpm:
+                lastValues.lastSpectralBpm = event.value;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    if (!drained)
+        return;
+    const qint64 pendingNs = ingestWorker->takeOldestPendingNs();
+    if (pendingNs > 0) {
+        ingestWorker->stats()[PipelineStats::Queue].record(monotonicNs() - pendingNs);
+        if (undrawnSinceNs == 0)
+            undrawnSinceNs = pendingNs;
+    }
+}
+
+void DeviceSession::render()
+{
+    // Скрытые сессии не рисуются; накопленное покажет первый кадр после переключения
+    if (!sessionView->isVisible()) {
+        undrawnSinceNs = 0;
+        return;
+    }
+    PipelineStats& stats = ingestWorker->stats();
+    const qint64 startNs = monotonicNs();
+    {
+        TRACE_SPAN("SessionView::render");
+        sessionView->render();
+    }
+    const qint64 endNs = monotonicNs();
+    stats[PipelineStats::Render].record(endNs - startNs);
+    // Самописцы дорисовывают в ближайшем paintEvent — это уже после кадра, но в том же цикле событий
+    if (undrawnSinceNs > 0) {
+        stats[PipelineStats::EndToEnd].record(endNs - undrawnSinceNs);
+        undrawnSinceNs = 0;
+    }
+}
+
+DeviceSession::Summary DeviceSession::summary() const
+{
+    Summary s = lastValues;
+    const ConnectionManager* connection = ingestWorker->connection();
+    s.connectionState = connection->state();
+    s.connected = s.connectionState == ConnectionManager::State::Connected;
+    s.reconnects = connection->reconnectCount();
+    s.lastReconnectMs = connection->lastReconnectLatencyMs();
+    s.elapsedSec = dataProcessor->getElapsedTime();
+    s.samplesDecoded = ingestWorker->samplesDecoded();
+    s.decodeErrors = ingestWorker->decodeErrors();
+    s.droppedEvents = ingestWorker->droppedEvents();
+    s.historyBytes = dataProcessor->history().memoryReport().totalBytes();
+    if (sessionJournal) {
+        s.journalBytes = sessionJournal->bytesWritten();
+        s.journalDropped = sessionJournal->droppedEvents();
+    }
+    return s;
+}
@@ -0,0 +1,90 @@
+#ifndef DEVICESESSION_H
+#define DEVICESESSION_H
+
+#include <QObject>
+#include <QLabel>
+#include <QString>
+#include <QVector>
+#include "dataProcessor.h"
+#include "ingestWorker.h"
+#include "sessionJournal.h"
+
+class SessionView;
+
+// Один датчик ESP32: соединение и обработка (IngestWorker в потоке пула),
+// отображение и накопленная история (DataProcessor, SessionView в потоке GUI).
+class DeviceSession : public QObject
+{
+    Q_OBJECT
+public:
+    struct Config {
+        QString name;
+        QString host;
+        quint16 port = 80;
+        ConnectionManager::Settings connection;
+        QString recordFile;        // запись сырого потока (.esprec), пусто — не записывать
+        QString replayFile;        // воспроизведение записи вместо подключения к устройству
+        double replaySpeed = 1.0;  // 1 — реальное время, 0 — максимально быстро
+        int spo2WindowMs = 4000;   // окно DC для SpO₂ (AC/DC)
+        BandPassFilter::Settings peakFilter; // фильтр перед детекцией пиков, по умолчанию выключен
+        SpectralHeartRate::Settings spectralHeartRate; // BPM по спектру IR
+        SessionJournal::Settings journal; // непрерывная запись результатов, пустой каталог — выключена
+    };
+
+    // Краткая сводка для панели устройств
+    struct Summary {
+        bool connected = false;
+        ConnectionManager::State connectionState = ConnectionManager::State::Idle;
+        quint64 reconnects = 0;
+        qint64 lastReconnectMs = -1;
+        double lastBpm = 0.0;
+        double lastAvgBpm = 0.0;
+        double lastSpectralBpm = 0.0;
+        double lastSpo2 = 0.0;
+        double lastSpo2Peak = 0.0;
+        double elapsedSec = 0.0;
+        quint64 samplesDecoded = 0;
+        quint64 decodeErrors = 0;
+        quint64 droppedEvents = 0;
+        quint64 historyBytes = 0; // память истории сессии (отсчёты, пирамида, ряды BPM/SpO₂)
+        quint64 journalBytes = 0;   // записано журналом на диск
+        quint64 journalDropped = 0; // событий, не попавших в журнал (очередь полна или ошибка диска)
+    };
+
+    explicit DeviceSession(const Config& config, QObject* parent = nullptr);
+    ~DeviceSession();
+
+    const Config& config() const { return sessionConfig; }
+    void setHost(const QString& host);
+    void setSpo2WindowMs(int windowMs);
+
+    // Рабочий объект передаётся в поток пула менеджером сессий
+    IngestWorker* worker() const { return ingestWorker; }
+    DataProcessor* processor() const { return dataProcessor; }
+    SessionView* view() const { return sessionView; }
+    // nullptr, если непрерывная запись выключена
+    SessionJournal* journal() const { return sessionJournal; }
+
+    //! Забор результатов обработки (таймер GUI)
+    void drain();
+    //! Кадр графиков (таймер кадров), независимо от частоты отсчётов
+    void render();
+
+    Summary summary() const;
+    // Задержки по стадиям конвейера (приём, обработка, очередь, кадр)
+    PipelineStats& stats() const { return ingestWorker->stats(); }
+
+private:
+    Config sessionConfig;
+    IngestWorker* ingestWorker;
+    DataProcessor* dataProcessor;
+    SessionView* sessionView;
+    SessionJournal* sessionJournal = nullptr;
+    QLabel* averageMinuteBpmLabel;
+    QVector<PipelineEvent> drainBuffer;
+    QVector<double> drainTimes; // время сессии событий drainBuffer
+    Summary lastValues;
+    qint64 undrawnSinceNs = 0; // чтение самого старого блока, ещё не показанного на графиках
+};
+
+#endif // DEVICESESSION_H
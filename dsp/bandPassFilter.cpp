@@ -0,0 +1,236 @@
+#include "bandPassFilter.h"
+
+#include <QtMath>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BANDPASS_SSE2
+#include <emmintrin.h>
+#endif
+
+static_assert(offsetof(SensorSample, redValue) == offsetof(SensorSample, irValue) + sizeof(double),
+              "IR и Red должны лежать подряд: обе дорожки загружаются одной инструкцией");
+
+namespace {
+
+// Биквад по формулам RBJ (билинейное преобразование), a0 нормирован к 1
+void designSection(bool highPass, double cutoffHz, double q, double sampleRateHz,
+                   double& b0, double& b1, double& b2, double& a1, double& a2)
+{
+    const double w0 = 2.0 * M_PI * cutoffHz / sampleRateHz;
+    const double cosW = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double a0 = 1.0 + alpha;
+    if (highPass) {
+        b0 = (1.0 + cosW) / 2.0 / a0;
+        b1 = -(1.0 + cosW) / a0;
+    } else {
+        b0 = (1.0 - cosW) / 2.0 / a0;
+        b1 = (1.0 - cosW) / a0;
+    }
+    b2 = b0;
+    a1 = -2.0 * cosW / a0;
+    a2 = (1.0 - alpha) / a0;
+}
+
+} // namespace
+
+BandPassFilter::BandPassFilter()
+{
+    std::memset(z1, 0, sizeof(z1));
+    std::memset(z2, 0, sizeof(z2));
+    averageSum[0] = averageSum[1] = 0.0;
+    previous[0] = previous[1] = 0.0;
+}
+
+void BandPassFilter::design(const Settings& settings, double sampleRateHz)
+{
+    sections = 0;
+    sampleRate = sampleRateHz;
+    if (sampleRateHz <= 0.0)
+        return;
+
+    // Срезы держим ниже частоты Найквиста, иначе биквад неустойчив
+    const double nyquistLimit = 0.45 * sampleRateHz;
+    const double highHz = qMin(settings.highHz, nyquistLimit);
+    const double lowHz = qBound(0.01, settings.lowHz, highHz * 0.5);
+    const int sectionsPerSide = qBound(1, settings.order / 2, maxSections / 2);
+
+    // Баттерворт порядка N = 2·sectionsPerSide: добротности секций 1 / (2·sin((2k+1)π / 2N))
+    const int n = 2 * sectionsPerSide;
+    for (int side = 0; side < 2; ++side) {
+        for (int k = 0; k < sectionsPerSide; ++k) {
+            const double q = 1.0 / (2.0 * std::sin((2 * k + 1) * M_PI / (2.0 * n)));
+            Coefficients& c = coefficients[sections++];
+            designSection(side == 0, side == 0 ? lowHz : highHz, q, sampleRateHz, c.b0, c.b1, c.b2, c.a1, c.a2);
+        }
+    }
+
+    averageLength = qMax(0, settings.movingAverage);
+    averageRing.fill(0.0, 2 * averageLength);
+    derivative = settings.derivative;
+    prime(0.0, 0.0);
+}
+
+void BandPassFilter::prime(double ir, double red)
+{
+    double y[2] = { ir, red };
+    for (int s = 0; s < sections; ++s) {
+        // Для постоянного входа x выход y = g·x, где g — усиление секции на нулевой частоте
+        const Coefficients& c = coefficients[s];
+        const double gain = (c.b0 + c.b1 + c.b2) / (1.0 + c.a1 + c.a2);
+        for (int lane = 0; lane < 2; ++lane) {
+            const double x = y[lane];
+            const double out = gain * x;
+            z2[s][lane] = c.b2 * x - c.a2 * out;
+            z1[s][lane] = c.b1 * x - c.a1 * out + z2[s][lane];
+            y[lane] = out;
+        }
+    }
+
+    averageHead = 0;
+    averageSum[0] = averageSum[1] = 0.0;
+    for (int i = 0; i < averageLength; ++i) {
+        averageRing[2 * i] = y[0];
+        averageRing[2 * i + 1] = y[1];
+        averageSum[0] += y[0];
+        averageSum[1] += y[1];
+    }
+    previous[0] = averageLength > 0 ? averageSum[0] / averageLength : y[0];
+    previous[1] = averageLength > 0 ? averageSum[1] / averageLength : y[1];
+}
+
+void BandPassFilter::process(const SensorSample* samples, int count, double* out)
+{
+#ifdef BANDPASS_SSE2
+    processSse2(samples, count, out);
+#else
+    processScalar(samples, count, out);
+#endif
+}
+
+void BandPassFilter::processScalar(const SensorSample* samples, int count, double* out)
+{
+    double* ring = averageRing.data();
+    for (int i = 0; i < count; ++i) {
+        double y[2] = { samples[i].irValue, samples[i].redValue };
+        for (int s = 0; s < sections; ++s) {
+            const Coefficients& c = coefficients[s];
+            for (int lane = 0; lane < 2; ++lane) {
+                const double x = y[lane];
+                const double v = c.b0 * x + z1[s][lane];
+                z1[s][lane] = c.b1 * x - c.a1 * v + z2[s][lane];
+                z2[s][lane] = c.b2 * x - c.a2 * v;
+                y[lane] = v;
+            }
+        }
+        if (averageLength > 0) {
+            double* slot = ring + 2 * averageHead;
+            for (int lane = 0; lane < 2; ++lane) {
+                averageSum[lane] += y[lane] - slot[lane];
+                slot[lane] = y[lane];
+            }
+            if (++averageHead == averageLength) {
+                // Полный оборот кольца — пересчёт сумм, чтобы не копилась ошибка округления
+                averageHead = 0;
+                averageSum[0] = averageSum[1] = 0.0;
+                for (int k = 0; k < averageLength; ++k) {
+                    averageSum[0] += ring[2 * k];
+                    averageSum[1] += ring[2 * k + 1];
+                }
+            }
+            y[0] = averageSum[0] / averageLength;
+            y[1] = averageSum[1] / averageLength;
+        }
+        if (derivative) {
+            const double d[2] = { y[0] - previous[0], y[1] - previous[1] };
+            previous[0] = y[0];
+            previous[1] = y[1];
+            y[0] = d[0];
+            y[1] = d[1];
+        }
+        out[2 * i] = y[0];
+        out[2 * i + 1] = y[1];
+    }
+}
+
+#ifdef BANDPASS_SSE2
+
+// Число секций — параметр шаблона: циклы по секциям разворачиваются, и состояние
+// всех биквадов остаётся в регистрах, а не в памяти
+template<int Sections>
+void BandPassFilter::processSections(const SensorSample* samples, int count, double* out)
+{
+    __m128d b0[Sections], b1[Sections], b2[Sections], a1[Sections], a2[Sections];
+    __m128d s1[Sections], s2[Sections];
+    for (int s = 0; s < Sections; ++s) {
+        b0[s] = _mm_set1_pd(coefficients[s].b0);
+        b1[s] = _mm_set1_pd(coefficients[s].b1);
+        b2[s] = _mm_set1_pd(coefficients[s].b2);
+        a1[s] = _mm_set1_pd(coefficients[s].a1);
+        a2[s] = _mm_set1_pd(coefficients[s].a2);
+        s1[s] = _mm_load_pd(z1[s]);
+        s2[s] = _mm_load_pd(z2[s]);
+    }
+    double* ring = averageRing.data();
+    __m128d sum = _mm_load_pd(averageSum);
+    __m128d prev = _mm_load_pd(previous);
+    const __m128d length = _mm_set1_pd(double(averageLength));
+
+    for (int i = 0; i < count; ++i) {
+        // irValue и redValue лежат в SensorSample подряд — одна загрузка на обе дорожки
+        __m128d y = _mm_loadu_pd(&samples[i].irValue);
+        for (int s = 0; s < Sections; ++s) {
+            const __m128d x = y;
+            y = _mm_add_pd(_mm_mul_pd(b0[s], x), s1[s]);
+            s1[s] = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1[s], x), _mm_mul_pd(a1[s], y)), s2[s]);
+            s2[s] = _mm_sub_pd(_mm_mul_pd(b2[s], x), _mm_mul_pd(a2[s], y));
+        }
+        if (averageLength > 0) {
+            double* slot = ring + 2 * averageHead;
+            sum = _mm_add_pd(sum, _mm_sub_pd(y, _mm_loadu_pd(slot)));
+            _mm_storeu_pd(slot, y);
+            if (++averageHead == averageLength) {
+                averageHead = 0;
+                sum = _mm_setzero_pd();
+                for (int k = 0; k < averageLength; ++k)
+                    sum = _mm_add_pd(sum, _mm_loadu_pd(ring + 2 * k));
+            }
+            y = _mm_div_pd(sum, length);
+        }
+        if (derivative) {
+            const __m128d d = _mm_sub_pd(y, prev);
+            prev = y;
+            y = d;
+        }
+        _mm_storeu_pd(out + 2 * i, y);
+    }
+
+    for (int s = 0; s < Sections; ++s) {
+        _mm_store_pd(z1[s], s1[s]);
+        _mm_store_pd(z2[s], s2[s]);
+    }
+    _mm_store_pd(averageSum, sum);
+    _mm_store_pd(previous, prev);
+}
+
+void BandPassFilter::processSse2(const SensorSample* samples, int count, double* out)
+{
+    switch (sections) {
+    case 2: processSections<2>(samples, count, out); break;
+    case 4: processSections<4>(samples, count, out); break;
+    case 6: processSections<6>(samples, count, out); break;
+    case 8: processSections<8>(samples, count, out); break;
+    default: processScalar(samples, count, out); break;
+    }
+}
+
+#else
+
+void BandPassFilter::processSse2(const SensorSample* samples, int count, double* out)
+{
+    processScalar(samples, count, out);
+}
+
+#endif
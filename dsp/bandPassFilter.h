@@ -0,0 +1,68 @@
+#ifndef BANDPASSFILTER_H
+#define BANDPASSFILTER_H
+
+#include <QVector>
+#include "sensorSample.h"
+
+// Полосовой фильтр перед детекцией пиков: каскад биквадов Баттерворта (ФВЧ lowHz + ФНЧ highHz),
+// затем необязательные скользящее среднее и первая разность.
+// IR и Red фильтруются вместе — как две дорожки одного вектора SSE2 (__m128d); без SSE2 работает
+// скалярный вариант с тем же порядком операций, поэтому результаты совпадают побитно.
+// Отсчёты обрабатываются блоками, состояние переносится между блоками.
+class BandPassFilter
+{
+public:
+    struct Settings {
+        bool enabled = false;
+        double lowHz = 0.5;        // срез ФВЧ — убирает дрейф базовой линии
+        double highHz = 5.0;       // срез ФНЧ — убирает высокочастотный шум
+        int order = 2;             // порядок ФВЧ и ФНЧ по отдельности: 2, 4, 6 или 8
+        int movingAverage = 0;     // длина сглаживания после фильтра, отсчётов (0 — нет)
+        bool derivative = false;   // на выходе первая разность (крутизна фронта)
+        double sampleRateHz = 0.0; // 0 — частота оценивается по меткам времени
+    };
+
+    static constexpr int maxSections = 8; // по 4 биквада на ФВЧ и ФНЧ
+
+    BandPassFilter();
+
+    // Рассчитывает коэффициенты для частоты дискретизации; состояние сбрасывается
+    void design(const Settings& settings, double sampleRateHz);
+    bool isDesigned() const { return sections > 0; }
+    double designedSampleRateHz() const { return sampleRate; }
+
+    // Установившееся состояние для постоянного входа (ir, red): без переходного процесса
+    // от постоянной составляющей ~100000 на первых секундах
+    void prime(double ir, double red);
+
+    // out — пары (IR, Red) подряд, 2·count значений
+    void process(const SensorSample* samples, int count, double* out);
+    // Скалярный вариант — для платформ без SSE2 и для сверки в бенчмарке
+    void processScalar(const SensorSample* samples, int count, double* out);
+
+private:
+    struct Coefficients {
+        double b0, b1, b2, a1, a2;
+    };
+
+    void processSse2(const SensorSample* samples, int count, double* out);
+    template<int Sections>
+    void processSections(const SensorSample* samples, int count, double* out);
+
+    Coefficients coefficients[maxSections];
+    alignas(16) double z1[maxSections][2]; // состояние транспонированной прямой формы II, [секция][дорожка]
+    alignas(16) double z2[maxSections][2];
+    int sections = 0;
+    double sampleRate = 0.0;
+
+    // Скользящее среднее: кольцо пар (IR, Red) и текущие суммы
+    QVector<double> averageRing;
+    int averageLength = 0;
+    int averageHead = 0;
+    alignas(16) double averageSum[2];
+
+    bool derivative = false;
+    alignas(16) double previous[2]; // предыдущий выход для первой разности
+};
+
+#endif // BANDPASSFILTER_H
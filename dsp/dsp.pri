@@ -0,0 +1,7 @@
+# Подключение статической библиотеки esp32_dsp (см. dsp.pro); цель должна зависеть от dsp в esp32_v5.pro
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+LIBS += -L$$ESP32_BUILD_ROOT/lib -lesp32_dsp
+win32-msvc*: PRE_TARGETDEPS += $$ESP32_BUILD_ROOT/lib/esp32_dsp.lib
+else: PRE_TARGETDEPS += $$ESP32_BUILD_ROOT/lib/libesp32_dsp.a
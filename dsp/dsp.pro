@@ -0,0 +1,35 @@
+# Ядро обработки сигнала: окна DC, детекция пиков, BPM, оба метода SpO₂, статистика BPM по окнам,
+# интервалы трассировки горячих путей (traceSpans).
+# Только QtCore, без виджетов — используется приложением, пакетной обработкой и бенчмарками.
+TEMPLATE = lib
+CONFIG += staticlib c++17
+QT = core
+
+TARGET = esp32_dsp
+DESTDIR = $$ESP32_BUILD_ROOT/lib
+
+# Трассировка по отсчётам (категория esp32.sample) выключена по умолчанию и включается на ходу;
+# CONFIG+=esp32_no_trace убирает её из сборки совсем
+esp32_no_trace: DEFINES += ESP32_NO_SAMPLE_TRACE
+
+SOURCES += \
+    bandPassFilter.cpp \
+    minuteStatistics.cpp \
+    rollingStatistics.cpp \
+    signalProcessor.cpp \
+    slidingWindowMean.cpp \
+    spectralHeartRate.cpp \
+    traceSpans.cpp
+
+HEADERS += \
+    bandPassFilter.h \
+    minuteStatistics.h \
+    pipelineEvent.h \
+    rollingStatistics.h \
+    sensorSample.h \
+    signalObserver.h \
+    signalProcessor.h \
+    slidingWindowMean.h \
+    spectralHeartRate.h \
+    traceSpans.h \
+    windowExtremes.h
@@ -0,0 +1,68 @@
+#include "minuteStatistics.h"
+
+namespace {
+// Пока значений меньше, медиана ненадёжна и отсев не применяется
+const int minimumReferenceCount = 5;
+}
+
+namespace MinuteStatistics {
+
+bool isPlausible(double bpm, double median)
+{
+    const double lowerBound = median * 0.8;
+    const double upperBound = (median > 120) ? median * 1.3 : median * 1.2;
+    return bpm >= lowerBound && bpm <= upperBound;
+}
+
+} // namespace MinuteStatistics
+
+BpmStatistics::BpmStatistics(qint64 startEpochMs)
+    : startEpochMs(startEpochMs)
+{
+}
+
+bool BpmStatistics::addBpm(qint64 timestamp, double bpm)
+{
+    // Перезапуск ESP32: время продолжается с последнего значения. Иначе окно медианы
+    // не вытесняло бы значения до перезапуска, и старая медиана отсекала бы верные BPM
+    qint64 t = timestamp + timelineShift;
+    if (lastTimestamp >= 0 && t < lastTimestamp) {
+        timelineShift += lastTimestamp - t;
+        t = lastTimestamp;
+    }
+    if (lastTimestamp < 0 && startEpochMs >= 0)
+        rolling.alignWindows(epochTimestamp >= 0 ? epochTimestamp : t, startEpochMs);
+    lastTimestamp = t;
+
+    // Медиана считается по всем значениям, иначе неудачное начало отсекало бы верные BPM
+    reference.add(t, bpm);
+    if (reference.size() >= minimumReferenceCount && !MinuteStatistics::isPlausible(bpm, reference.median())) {
+        ++rejected;
+        return false;
+    }
+    rolling.add(t, bpm);
+    return true;
+}
+
+QVector<MinuteBPMData> BpmStatistics::minuteRecords() const
+{
+    QVector<WindowStats> minutes = rolling.closed(OneMinute);
+    const WindowStats open = rolling.current(OneMinute);
+    if (open.count > 0)
+        minutes.append(open);
+
+    QVector<MinuteBPMData> records;
+    records.reserve(minutes.size());
+    const qint64 epoch = qMax<qint64>(0, startEpochMs);
+    const qint64 anchor = epochTimestamp >= 0 ? epochTimestamp : rolling.firstTimestamp();
+    for (const WindowStats& w : std::as_const(minutes)) {
+        MinuteBPMData record;
+        record.minuteTimestamp = QDateTime::fromMSecsSinceEpoch(epoch + w.startTimestamp - anchor);
+        record.averageBPM = w.mean;
+        record.minBPM = w.minimum;
+        record.maxBPM = w.maximum;
+        record.medianBPM = w.median;
+        records.append(record);
+    }
+    return records;
+}
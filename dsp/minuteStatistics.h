@@ -0,0 +1,70 @@
+#ifndef MINUTESTATISTICS_H
+#define MINUTESTATISTICS_H
+
+#include <QDateTime>
+#include <QVector>
+#include "rollingStatistics.h"
+
+// Структура для хранения данных по BPM за 1 минуту
+struct MinuteBPMData {
+    QDateTime minuteTimestamp; // Время (начало минуты, локальное)
+    double averageBPM;
+    double minBPM;
+    double maxBPM;
+    double medianBPM;
+};
+
+namespace MinuteStatistics {
+
+// Допустимый разброс BPM относительно медианы: −20 %, +20 % (при медиане выше 120 — +30 %)
+bool isPlausible(double bpm, double median);
+
+} // namespace MinuteStatistics
+
+// Статистика BPM по времени датчика (а не по часам хоста) — одна и та же для приложения
+// и пакетной обработки записей: скользящие и фиксированные окна 10 с, 1 мин, 5 мин, 1 ч.
+// Выбросы (вне MinuteStatistics::isPlausible относительно медианы всех BPM за последнюю
+// минуту) в статистику не попадают. Метки времени, пошедшие назад (перезапуск ESP32),
+// сдвигаются одинаково для медианы отсева и для окон — как в RollingStatistics.
+// Если начало сессии известно до первого BPM, фиксированные окна выровнены по настенному
+// времени: минуты экспорта начинаются с hh:mm:00.
+class BpmStatistics
+{
+public:
+    enum Resolution { TenSeconds, OneMinute, FiveMinutes, OneHour };
+
+    // startEpochMs — настенное время начала сессии, по нему подписываются минуты;
+    // -1 — задать позже (setStartEpochMs)
+    explicit BpmStatistics(qint64 startEpochMs = -1);
+
+    // epochMs — настенное время в момент sensorTimestamp по времени датчика (обычно первый отсчёт
+    // сессии). Берётся из записи или журнала, а не с часов хоста во время обработки — иначе при
+    // воспроизведении минуты подписывались бы временем воспроизведения.
+    // sensorTimestamp = -1 — момент первого BPM. Окна выравниваются, только если вызвано до первого BPM
+    void setStartEpochMs(qint64 epochMs, qint64 sensorTimestamp = -1)
+    {
+        startEpochMs = epochMs;
+        epochTimestamp = sensorTimestamp;
+    }
+    qint64 getStartEpochMs() const { return startEpochMs; }
+
+    // false — значение отброшено как выброс
+    bool addBpm(qint64 timestamp, double bpm);
+
+    const RollingStatistics& statistics() const { return rolling; }
+    int rejectedCount() const { return rejected; }
+
+    // Поминутные записи для экспорта, включая текущую незакрытую минуту
+    QVector<MinuteBPMData> minuteRecords() const;
+
+private:
+    RollingStatistics rolling;
+    SlidingStatistics reference { 60000 }; // все BPM за минуту, для отсева выбросов
+    qint64 startEpochMs;
+    qint64 epochTimestamp = -1;
+    qint64 lastTimestamp = -1; // последняя метка на непрерывной оси
+    qint64 timelineShift = 0;  // непрерывная ось − время ESP32, мс
+    int rejected = 0;
+};
+
+#endif // MINUTESTATISTICS_H
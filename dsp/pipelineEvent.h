@@ -0,0 +1,25 @@
+#ifndef PIPELINEEVENT_H
+#define PIPELINEEVENT_H
+
+#include <QtGlobal>
+
+// Результат обработки, передаваемый из потока обработки в GUI.
+// Значения полей зависят от типа события:
+//   Sample   — value = IR, value2 = Red, value3 = Temp
+//   Spo2     — value = SpO₂ (метод AC/DC)
+//   Peak     — value = IR в точке пика
+//   Bpm      — value = BPM, value2 = среднее по последним ударам
+//   Spo2Peak — value = SpO₂ (метод по циклу между пиками)
+//   SpectralBpm — value = BPM по спектру IR, value2 = уверенность оценки (0…1)
+struct PipelineEvent {
+    enum Type : quint8 { Sample, Spo2, Peak, Bpm, Spo2Peak, SpectralBpm };
+
+    Type type;
+    qint64 timestamp; // время ESP32, мс
+    double timeSec;   // время от начала сессии, с
+    double value;
+    double value2;
+    double value3;
+};
+
+#endif // PIPELINEEVENT_H
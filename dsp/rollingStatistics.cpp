@@ -0,0 +1,326 @@
+#include "rollingStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// ================= P2Quantile =================
+P2Quantile::P2Quantile(double quantile)
+    : q(quantile)
+{
+}
+
+void P2Quantile::add(double value)
+{
+    if (n < 5) {
+        heights[n++] = value;
+        if (n == 5) {
+            std::sort(heights, heights + 5);
+            for (int i = 0; i < 5; ++i)
+                positions[i] = i + 1;
+            desired[0] = 1.0;
+            desired[1] = 1.0 + 2.0 * q;
+            desired[2] = 1.0 + 4.0 * q;
+            desired[3] = 3.0 + 2.0 * q;
+            desired[4] = 5.0;
+            increments[0] = 0.0;
+            increments[1] = q / 2.0;
+            increments[2] = q;
+            increments[3] = (1.0 + q) / 2.0;
+            increments[4] = 1.0;
+        }
+        return;
+    }
+
+    // Ячейка, в которую попало значение; крайние маркеры — минимум и максимум
+    int k;
+    if (value < heights[0]) {
+        heights[0] = value;
+        k = 0;
+    } else if (value >= heights[4]) {
+        heights[4] = value;
+        k = 3;
+    } else {
+        k = 0;
+        while (value >= heights[k + 1])
+            ++k;
+    }
+    for (int i = k + 1; i < 5; ++i)
+        positions[i] += 1.0;
+    for (int i = 0; i < 5; ++i)
+        desired[i] += increments[i];
+    ++n;
+
+    // Средние маркеры сдвигаются к желаемым позициям по параболе (или линейно, если
+    // парабола нарушает порядок высот)
+    for (int i = 1; i <= 3; ++i) {
+        const double d = desired[i] - positions[i];
+        if ((d >= 1.0 && positions[i + 1] - positions[i] > 1.0)
+            || (d <= -1.0 && positions[i - 1] - positions[i] < -1.0)) {
+            const int step = d > 0 ? 1 : -1;
+            const double candidate = parabolic(i, step);
+            if (heights[i - 1] < candidate && candidate < heights[i + 1])
+                heights[i] = candidate;
+            else
+                heights[i] = linear(i, step);
+            positions[i] += step;
+        }
+    }
+}
+
+double P2Quantile::parabolic(int i, double d) const
+{
+    return heights[i] + d / (positions[i + 1] - positions[i - 1])
+           * ((positions[i] - positions[i - 1] + d) * (heights[i + 1] - heights[i]) / (positions[i + 1] - positions[i])
+              + (positions[i + 1] - positions[i] - d) * (heights[i] - heights[i - 1]) / (positions[i] - positions[i - 1]));
+}
+
+double P2Quantile::linear(int i, int d) const
+{
+    return heights[i] + d * (heights[i + d] - heights[i]) / (positions[i + d] - positions[i]);
+}
+
+double P2Quantile::value() const
+{
+    if (n == 0)
+        return 0.0;
+    if (n >= 5)
+        return heights[2];
+    // Пока маркеры не заполнены — точный квантиль по имеющимся значениям
+    double sorted[5];
+    std::copy(heights, heights + n, sorted);
+    std::sort(sorted, sorted + n);
+    return sorted[int(std::floor(q * (n - 1)))];
+}
+
+// ================= QuantileSplit =================
+void QuantileSplit::insert(double value)
+{
+    if (lower.empty() || value <= *lower.rbegin())
+        lower.insert(value);
+    else
+        upper.insert(value);
+    rebalance();
+}
+
+void QuantileSplit::erase(double value)
+{
+    if (!lower.empty() && value <= *lower.rbegin()) {
+        const auto it = lower.find(value);
+        if (it != lower.end())
+            lower.erase(it);
+    } else {
+        const auto it = upper.find(value);
+        if (it != upper.end())
+            upper.erase(it);
+    }
+    rebalance();
+}
+
+void QuantileSplit::clear()
+{
+    lower.clear();
+    upper.clear();
+}
+
+void QuantileSplit::rebalance()
+{
+    const int n = size();
+    const int target = n > 0 ? int(std::floor(q * (n - 1))) + 1 : 0;
+    while (int(lower.size()) > target) {
+        const auto it = std::prev(lower.end());
+        upper.insert(*it);
+        lower.erase(it);
+    }
+    while (int(lower.size()) < target && !upper.empty()) {
+        lower.insert(*upper.begin());
+        upper.erase(upper.begin());
+    }
+}
+
+// ================= SlidingStatistics =================
+SlidingStatistics::SlidingStatistics(qint64 windowMs, double percentile)
+    : window(windowMs)
+    , percentileSplit(percentile)
+{
+}
+
+void SlidingStatistics::add(qint64 timestamp, double value)
+{
+    entries.append({ timestamp, value });
+    sum += value;
+    medianSplit.insert(value);
+    percentileSplit.insert(value);
+
+    while (timestamp - entries[head].timestamp >= window) {
+        const double old = entries[head++].value;
+        sum -= old;
+        medianSplit.erase(old);
+        percentileSplit.erase(old);
+        ++evictedSinceRecompute;
+    }
+    // Удалённые из начала значения сдвигаются пачкой — амортизированно O(1)
+    if (head > 64 && head * 2 > entries.size()) {
+        entries.remove(0, head);
+        head = 0;
+    }
+    // Ошибка округления текущей суммы не копится: окно обновилось — сумма заново
+    const int count = entries.size() - head;
+    if (evictedSinceRecompute >= count) {
+        sum = 0.0;
+        for (int i = head; i < entries.size(); ++i)
+            sum += entries[i].value;
+        evictedSinceRecompute = 0;
+    }
+}
+
+void SlidingStatistics::clear()
+{
+    entries.resize(0);
+    head = 0;
+    sum = 0.0;
+    evictedSinceRecompute = 0;
+    medianSplit.clear();
+    percentileSplit.clear();
+}
+
+WindowStats SlidingStatistics::stats() const
+{
+    WindowStats s;
+    s.count = entries.size() - head;
+    if (s.count == 0)
+        return s;
+    s.endTimestamp = entries.last().timestamp;
+    s.startTimestamp = s.endTimestamp - window;
+    s.mean = sum / s.count;
+    s.minimum = medianSplit.minimum();
+    s.maximum = medianSplit.maximum();
+    s.median = medianSplit.quantile();
+    s.percentile = percentileSplit.quantile();
+    return s;
+}
+
+// ================= TumblingStatistics =================
+TumblingStatistics::TumblingStatistics(qint64 windowMs, double percentile)
+    : window(windowMs)
+    , percentileEstimate(percentile)
+{
+}
+
+void TumblingStatistics::setOrigin(qint64 timestamp)
+{
+    origin = timestamp;
+    hasOrigin = true;
+}
+
+void TumblingStatistics::add(qint64 timestamp, double value)
+{
+    if (!hasOrigin)
+        setOrigin(timestamp);
+    // Деление с округлением вниз: заданная граница может оказаться позже значения
+    qint64 index = (timestamp - origin) / window;
+    if (timestamp < origin + index * window)
+        --index;
+    const qint64 start = origin + index * window;
+    if (start != windowStart) {
+        close();
+        windowStart = start;
+    }
+    if (count == 0) {
+        minimum = value;
+        maximum = value;
+    } else {
+        minimum = qMin(minimum, value);
+        maximum = qMax(maximum, value);
+    }
+    ++count;
+    sum += value;
+    medianEstimate.add(value);
+    percentileEstimate.add(value);
+}
+
+void TumblingStatistics::close()
+{
+    if (count > 0)
+        closedWindows.append(current());
+    count = 0;
+    sum = 0.0;
+    medianEstimate.clear();
+    percentileEstimate.clear();
+}
+
+void TumblingStatistics::clear()
+{
+    close();
+    closedWindows.clear();
+    origin = 0;
+    hasOrigin = false;
+    windowStart = -1;
+}
+
+WindowStats TumblingStatistics::current() const
+{
+    WindowStats s;
+    s.count = count;
+    if (count == 0)
+        return s;
+    s.startTimestamp = windowStart;
+    s.endTimestamp = windowStart + window;
+    s.mean = sum / count;
+    s.minimum = minimum;
+    s.maximum = maximum;
+    s.median = medianEstimate.value();
+    s.percentile = percentileEstimate.value();
+    return s;
+}
+
+// ================= RollingStatistics =================
+RollingStatistics::RollingStatistics()
+    : RollingStatistics(Settings())
+{
+}
+
+RollingStatistics::RollingStatistics(const Settings& newSettings)
+    : settings(newSettings)
+{
+    for (const qint64 resolution : std::as_const(settings.resolutionsMs))
+        levels.append({ SlidingStatistics(resolution, settings.percentile),
+                        TumblingStatistics(resolution, settings.percentile) });
+}
+
+void RollingStatistics::alignWindows(qint64 timestamp, qint64 epochMs)
+{
+    for (int i = 0; i < levels.size(); ++i) {
+        const qint64 resolution = settings.resolutionsMs[i];
+        const qint64 sinceBoundary = ((epochMs % resolution) + resolution) % resolution;
+        levels[i].tumbling.setOrigin(timestamp - sinceBoundary);
+    }
+}
+
+void RollingStatistics::add(qint64 timestamp, double value)
+{
+    qint64 t = timestamp + offset;
+    if (last >= 0 && t < last) {
+        // Перезапуск устройства: время датчика продолжается с последнего значения
+        offset += last - t;
+        t = last;
+    }
+    if (first < 0)
+        first = t;
+    last = t;
+    for (Level& level : levels) {
+        level.sliding.add(t, value);
+        level.tumbling.add(t, value);
+    }
+}
+
+void RollingStatistics::clear()
+{
+    for (Level& level : levels) {
+        level.sliding.clear();
+        level.tumbling.clear();
+    }
+    first = -1;
+    last = -1;
+    offset = 0;
+}
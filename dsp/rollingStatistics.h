@@ -0,0 +1,175 @@
+#ifndef ROLLINGSTATISTICS_H
+#define ROLLINGSTATISTICS_H
+
+#include <QVector>
+#include <set>
+
+// Потоковая статистика по времени датчика: окна задаются метками времени значений,
+// поэтому при воспроизведении записи быстрее реального времени итоги те же, что вживую.
+
+// Сводка одного окна. Для скользящего окна медиана и перцентиль точные, для
+// фиксированного (tumbling) — оценка P².
+struct WindowStats {
+    qint64 startTimestamp = 0; // границы окна во времени датчика, мс
+    qint64 endTimestamp = 0;
+    int count = 0;
+    double mean = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    double median = 0.0;
+    double percentile = 0.0;   // перцентиль RollingStatistics::Settings::percentile
+};
+
+// Оценка квантиля P² (Jain, Chlamtac): пять маркеров, O(1) на значение и по памяти
+class P2Quantile
+{
+public:
+    explicit P2Quantile(double quantile = 0.5);
+
+    void add(double value);
+    double value() const;
+    int count() const { return n; }
+    void clear() { n = 0; }
+
+private:
+    double parabolic(int i, double d) const;
+    double linear(int i, int d) const;
+
+    double q;
+    int n = 0;
+    double heights[5] = {};
+    double positions[5] = {};
+    double desired[5] = {};
+    double increments[5] = {};
+};
+
+// Точный квантиль множества с удалением: два упорядоченных множества, в нижнем —
+// floor(q·(n−1)) + 1 наименьших значений. Вставка и удаление — O(log n).
+class QuantileSplit
+{
+public:
+    explicit QuantileSplit(double quantile = 0.5) : q(quantile) {}
+
+    void insert(double value);
+    void erase(double value);
+    void clear();
+
+    int size() const { return int(lower.size() + upper.size()); }
+    double quantile() const { return lower.empty() ? 0.0 : *lower.rbegin(); }
+    double minimum() const { return lower.empty() ? 0.0 : *lower.begin(); }
+    double maximum() const { return upper.empty() ? quantile() : *upper.rbegin(); }
+
+private:
+    void rebalance();
+
+    double q;
+    std::multiset<double> lower;
+    std::multiset<double> upper;
+};
+
+// Скользящее окно (последнее значение − windowMs, последнее значение]
+class SlidingStatistics
+{
+public:
+    explicit SlidingStatistics(qint64 windowMs = 60000, double percentile = 0.9);
+
+    void add(qint64 timestamp, double value);
+    void clear();
+
+    WindowStats stats() const;
+    int size() const { return medianSplit.size(); }
+    double median() const { return medianSplit.quantile(); }
+
+private:
+    struct Entry {
+        qint64 timestamp;
+        double value;
+    };
+
+    qint64 window;
+    QVector<Entry> entries;  // значения окна; удалённые из начала сдвигаются пачкой
+    int head = 0;
+    double sum = 0.0;
+    int evictedSinceRecompute = 0;
+    QuantileSplit medianSplit { 0.5 };
+    QuantileSplit percentileSplit;
+};
+
+// Фиксированные окна [origin + k·windowMs, origin + (k+1)·windowMs), по умолчанию origin —
+// первое значение; пустые окна не записываются
+class TumblingStatistics
+{
+public:
+    explicit TumblingStatistics(qint64 windowMs = 60000, double percentile = 0.9);
+
+    // Граница окон вместо первого значения; только до первого add()
+    void setOrigin(qint64 timestamp);
+    void add(qint64 timestamp, double value);
+    void clear();
+
+    // Текущее (незакрытое) окно; count == 0 — значений ещё не было
+    WindowStats current() const;
+    const QVector<WindowStats>& closed() const { return closedWindows; }
+
+private:
+    void close();
+
+    qint64 window;
+    qint64 origin = 0;
+    bool hasOrigin = false;
+    qint64 windowStart = -1;
+    int count = 0;
+    double sum = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    P2Quantile medianEstimate { 0.5 };
+    P2Quantile percentileEstimate;
+    QVector<WindowStats> closedWindows;
+};
+
+// Набор разрешений (по умолчанию 10 с, 1 мин, 5 мин, 1 ч): на каждом — скользящее окно
+// и фиксированные окна. Метки времени, пошедшие назад (перезапуск ESP32), сдвигаются так,
+// чтобы время продолжалось с последнего значения.
+class RollingStatistics
+{
+public:
+    struct Settings {
+        QVector<qint64> resolutionsMs { 10000, 60000, 300000, 3600000 };
+        double percentile = 0.9;
+    };
+
+    RollingStatistics();
+    explicit RollingStatistics(const Settings& settings);
+
+    // Метка timestamp соответствует настенному времени epochMs: фиксированные окна каждого
+    // разрешения начинаются на кратных ему границах настенного времени (минуты — с hh:mm:00).
+    // Только до первого add(); без вызова окна отсчитываются от первого значения
+    void alignWindows(qint64 timestamp, qint64 epochMs);
+    void add(qint64 timestamp, double value);
+    void clear();
+
+    int resolutionCount() const { return levels.size(); }
+    qint64 resolutionMs(int index) const { return settings.resolutionsMs[index]; }
+    double percentile() const { return settings.percentile; }
+
+    WindowStats sliding(int index) const { return levels[index].sliding.stats(); }
+    WindowStats current(int index) const { return levels[index].tumbling.current(); }
+    const QVector<WindowStats>& closed(int index) const { return levels[index].tumbling.closed(); }
+
+    // Время первого значения; -1 — значений не было
+    qint64 firstTimestamp() const { return first; }
+
+private:
+    struct Level {
+        SlidingStatistics sliding;
+        TumblingStatistics tumbling;
+    };
+
+    Settings settings;
+    QVector<Level> levels;
+    qint64 first = -1;
+    qint64 last = -1;
+    qint64 offset = 0;
+};
+
+#endif // ROLLINGSTATISTICS_H
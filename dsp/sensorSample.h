@@ -0,0 +1,14 @@
+#ifndef SENSORSAMPLE_H
+#define SENSORSAMPLE_H
+
+#include <QtGlobal>
+
+// Один отсчёт датчика MAX30102: временная метка ESP32 (в мс) и три значения
+struct SensorSample {
+    qint64 timestamp;
+    double irValue;
+    double redValue;
+    double tempValue;
+};
+
+#endif // SENSORSAMPLE_H
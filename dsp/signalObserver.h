@@ -0,0 +1,65 @@
+#ifndef SIGNALOBSERVER_H
+#define SIGNALOBSERVER_H
+
+#include <QVector>
+#include "pipelineEvent.h"
+
+// Получатель результатов SignalProcessor. Методы вызываются синхронно в потоке обработки,
+// в том порядке, в каком появляются результаты; по умолчанию ничего не делают, поэтому
+// подписчик переопределяет только нужное (например, пакетной обработке достаточно onBpm).
+// Во всех методах timestamp — время ESP32 в мс, timeSec — секунды от начала сессии.
+class SignalObserver
+{
+public:
+    virtual ~SignalObserver() = default;
+
+    // Исходный отсчёт: IR, Red, температура
+    virtual void onSample(qint64 /*timestamp*/, double /*timeSec*/, double /*ir*/, double /*red*/, double /*temp*/) {}
+    // SpO₂ методом AC/DC по скользящему окну
+    virtual void onSpo2(qint64 /*timestamp*/, double /*timeSec*/, int /*spo2*/) {}
+    // Пик пульсовой волны (значение IR в точке пика)
+    virtual void onPeak(qint64 /*timestamp*/, double /*timeSec*/, double /*ir*/) {}
+    // BPM по интервалу между пиками и среднее по последним ударам
+    virtual void onBpm(qint64 /*timestamp*/, double /*timeSec*/, double /*bpm*/, double /*averageBpm*/) {}
+    // SpO₂ по размаху сигналов за цикл между пиками
+    virtual void onSpo2Peak(qint64 /*timestamp*/, double /*timeSec*/, int /*spo2*/) {}
+    // BPM по спектру IR и уверенность оценки (0…1)
+    virtual void onSpectralBpm(qint64 /*timestamp*/, double /*timeSec*/, double /*bpm*/, double /*confidence*/) {}
+};
+
+// Складывает результаты в вектор PipelineEvent — для передачи между потоками и в SessionHistory
+class PipelineEventCollector : public SignalObserver
+{
+public:
+    explicit PipelineEventCollector(QVector<PipelineEvent>& events) : events(events) {}
+
+    void onSample(qint64 timestamp, double timeSec, double ir, double red, double temp) override
+    {
+        events.append({PipelineEvent::Sample, timestamp, timeSec, ir, red, temp});
+    }
+    void onSpo2(qint64 timestamp, double timeSec, int spo2) override
+    {
+        events.append({PipelineEvent::Spo2, timestamp, timeSec, double(spo2), 0.0, 0.0});
+    }
+    void onPeak(qint64 timestamp, double timeSec, double ir) override
+    {
+        events.append({PipelineEvent::Peak, timestamp, timeSec, ir, 0.0, 0.0});
+    }
+    void onBpm(qint64 timestamp, double timeSec, double bpm, double averageBpm) override
+    {
+        events.append({PipelineEvent::Bpm, timestamp, timeSec, bpm, averageBpm, 0.0});
+    }
+    void onSpo2Peak(qint64 timestamp, double timeSec, int spo2) override
+    {
+        events.append({PipelineEvent::Spo2Peak, timestamp, timeSec, double(spo2), 0.0, 0.0});
+    }
+    void onSpectralBpm(qint64 timestamp, double timeSec, double bpm, double confidence) override
+    {
+        events.append({PipelineEvent::SpectralBpm, timestamp, timeSec, bpm, confidence, 0.0});
+    }
+
+private:
+    QVector<PipelineEvent>& events;
+};
+
+#endif // SIGNALOBSERVER_H
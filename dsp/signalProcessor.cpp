@@ -0,0 +1,249 @@
+#include "signalProcessor.h"
+#include "traceSpans.h"
+#include <QLoggingCategory>
+
+// Горячий путь: отладка этих категорий выключена по умолчанию и включается правилами
+// (esp32.sample.debug=true, см. AsyncLogger) — в выключенном состоянии вывод не форматируется.
+// При ESP32_NO_SAMPLE_TRACE трассировка по отсчётам не компилируется вовсе.
+Q_LOGGING_CATEGORY(lcSample, "esp32.sample", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcBeat, "esp32.beat", QtInfoMsg)
+
+#ifdef ESP32_NO_SAMPLE_TRACE
+#define SAMPLE_TRACE() QT_NO_QDEBUG_MACRO()
+#else
+#define SAMPLE_TRACE() qCDebug(lcSample)
+#endif
+
+namespace {
+
+// Подписчик по умолчанию: избавляет от проверок на nullptr в горячем цикле
+SignalObserver& discardingObserver()
+{
+    static SignalObserver observer;
+    return observer;
+}
+
+} // namespace
+
+SignalProcessor::SignalProcessor()
+    : observer(&discardingObserver()),
+    timeStart(0),
+    lastReceivedTimestamp(0),
+    lastPeakTime(0),
+    redDcWindow(4000),
+    irDcWindow(4000),
+    spo2WindowMs(4000),
+    windowSize(5),  // Размер окна для детекции пика
+    peakWindow(windowSize),
+    peakState(WAITING),
+    previousValue(0.0),
+    candidatePeak(0.0),
+    candidateTime(0),
+    dropThreshold(0.001) // Порог падения 0.1%
+{
+}
+
+double SignalProcessor::calculateAverage(const QVector<double>& values) {
+    if (values.isEmpty())
+        return 0;
+    double sum = 0;
+    for (double v : values)
+        sum += v;
+    return sum / values.size();
+}
+
+void SignalProcessor::setObserver(SignalObserver* newObserver) {
+    observer = newObserver ? newObserver : &discardingObserver();
+}
+
+void SignalProcessor::setSpo2WindowMs(int windowMs) {
+    spo2WindowMs = qMax(1, windowMs);
+    irDcWindow.setWindowMs(spo2WindowMs);
+    redDcWindow.setWindowMs(spo2WindowMs);
+}
+
+double SignalProcessor::detectSpO2(double irValue, double redValue) {
+    // Логика расчёта SpO₂ может быть реализована здесь
+    return 0.0;
+}
+
+// Сохраняем старую функцию, если понадобится (но новый алгоритм в process используется для пиков)
+bool SignalProcessor::detectPeakImproved(double irValue, qint64 timestamp) {
+    bool peakDetected = false;
+    if (peakState == WAITING) {
+        if (irValue > previousValue) {
+            peakState = RISING;
+            candidatePeak = irValue;
+            candidateTime = timestamp;
+        }
+    } else if (peakState == RISING) {
+        if (irValue > candidatePeak) {
+            candidatePeak = irValue;
+            candidateTime = timestamp;
+        } else if (irValue < candidatePeak * (1 - dropThreshold)) {
+            peakDetected = true;
+            peakState = WAITING;
+        }
+    }
+    previousValue = irValue;
+    return peakDetected;
+}
+
+void SignalProcessor::setPeakFilter(const BandPassFilter::Settings& settings) {
+    filterSettings = settings;
+    filterReady = false;
+    const double rateHz = settings.sampleRateHz > 0 ? settings.sampleRateHz : estimatedRateHz;
+    peakFilter.design(settings, rateHz);
+}
+
+void SignalProcessor::setSpectralHeartRate(const SpectralHeartRate::Settings& settings) {
+    spectralEstimator.configure(settings);
+}
+
+void SignalProcessor::preparePeakFilter(const SensorSample& sample) {
+    if (!peakFilter.isDesigned()) {
+        // Частота по меткам времени за первую секунду: при метках в мс погрешность < 0.1 %
+        if (rateFirstTimestamp < 0)
+            rateFirstTimestamp = sample.timestamp;
+        ++rateSampleCount;
+        const qint64 spanMs = sample.timestamp - rateFirstTimestamp;
+        if (spanMs < 1000)
+            return;
+        estimatedRateHz = 1000.0 * (rateSampleCount - 1) / spanMs;
+        peakFilter.design(filterSettings, estimatedRateHz);
+    }
+    // Фильтр стартует из установившегося состояния для текущего уровня сигнала
+    peakFilter.prime(sample.irValue, sample.redValue);
+    filterReady = true;
+}
+
+void SignalProcessor::processBatch(const SensorSample* samples, int count) {
+    if (!filterSettings.enabled) {
+        TRACE_SPAN("peak detection");
+        for (int i = 0; i < count; ++i)
+            processSample(samples[i], samples[i].irValue, true);
+        return;
+    }
+
+    int i = 0;
+    for (; i < count && !filterReady; ++i) {
+        preparePeakFilter(samples[i]);
+        processSample(samples[i], 0.0, false);
+    }
+    // Остаток блока фильтруется целиком, затем идёт обычная обработка по отсчётам
+    const int rest = count - i;
+    if (rest <= 0)
+        return;
+    filteredValues.resize(2 * rest);
+    {
+        TRACE_SPAN("BandPassFilter::process");
+        peakFilter.process(samples + i, rest, filteredValues.data());
+    }
+    // По отсчётам: SpO₂, спектральный пульс и детекция пиков
+    TRACE_SPAN("peak detection");
+    for (int k = 0; k < rest; ++k)
+        processSample(samples[i + k], filteredValues[2 * k], true);
+}
+
+void SignalProcessor::process(const SensorSample& sample) {
+    processBatch(&sample, 1);
+}
+
+void SignalProcessor::processSample(const SensorSample& sample, double peakInput, bool detectPeaks) {
+    const qint64 timestamp = sample.timestamp;
+    const double infraredValue = sample.irValue;
+    const double redValue = sample.redValue;
+    const double temperatureValue = sample.tempValue;
+
+    // Если timeStart еще не установлен, сохраняем первую временную метку
+    if (timeStart == 0)
+        timeStart = timestamp;
+    // Вычисляем время относительно первого значения (начало = 0)
+    double currentTimeSec = static_cast<double>(timestamp - timeStart) / 1000.0;
+    lastReceivedTimestamp = timestamp;
+    SAMPLE_TRACE() << "Processing IR=" << infraredValue
+             << ", Red=" << redValue
+             << ", Temp=" << temperatureValue
+             << ", currentTimeSec=" << currentTimeSec;
+
+    // Исходный отсчёт — для графиков и экспорта
+    observer->onSample(timestamp, currentTimeSec, infraredValue, redValue, temperatureValue);
+
+    // Обновляем буферы с учётом времени для метода AC/DC
+    irDcWindow.add(timestamp, infraredValue);
+    redDcWindow.add(timestamp, redValue);
+
+    double infraredDC = irDcWindow.mean();
+    double redDC = redDcWindow.mean();
+    double infraredAC = infraredValue - infraredDC;
+    double redAC = redValue - redDC;
+
+    // Расчёт SpO₂, если данные валидны
+    if (infraredDC != 0 && redDC != 0 && infraredAC > 0 && redAC > 0) {
+        double ratioR = (redAC / redDC) / (infraredAC / infraredDC);
+        int spo2 = static_cast<int>(110 - 25.0 * ratioR);
+        spo2 = qBound(80, spo2, 100);
+        SAMPLE_TRACE() << "Calculated SpO₂=" << spo2;
+        observer->onSpo2(timestamp, currentTimeSec, spo2);
+    }
+
+    // Копим размах между пиками для метода 2 (по исходным значениям — нужна постоянная составляющая)
+    intervalIr.add(infraredValue);
+    intervalRed.add(redValue);
+
+    if (spectralEstimator.getSettings().enabled && spectralEstimator.add(timestamp, infraredValue))
+        observer->onSpectralBpm(timestamp, currentTimeSec, spectralEstimator.bpm(), spectralEstimator.confidence());
+
+    if (!detectPeaks)
+        return;
+
+    // --- Алгоритм детекции пиков с использованием окна ---
+    // Добавляем текущую точку в окно (кольцевой буфер, самая старая вытесняется)
+    peakWindow.push(peakInput, timestamp, infraredValue);
+
+    // Когда окно заполнено, проверяем, что центральная точка строго больше остальных
+    if (peakWindow.centerIsStrictMax()) {
+        qint64 detectedPeakTime = peakWindow.centerTimestamp();
+        // Вводим рефрактерный период: если предыдущий пик отсутствует или разница > 300 мс
+        if (lastPeakTime == 0 || (detectedPeakTime - lastPeakTime) > 300) {
+            double peakTimeSec = static_cast<double>(detectedPeakTime - timeStart) / 1000.0;
+            // Красная точка на графике IR
+            observer->onPeak(detectedPeakTime, peakTimeSec, peakWindow.centerRawValue());
+            // Если имеется предыдущий пик, можно вычислить интервал для BPM
+            if (lastPeakTime != 0) {
+                int deltaMs = static_cast<int>(detectedPeakTime - lastPeakTime);
+                qCDebug(lcBeat) << "Peak interval (ms):" << deltaMs;
+                if (deltaMs > 500 && deltaMs < 1333) {
+                    double bpm = 60000.0 / deltaMs;
+                    qCDebug(lcBeat) << "Calculated BPM:" << bpm;
+                    bpmValues.push_back(bpm);
+                    if (bpmValues.size() > 3)
+                        bpmValues.pop_front();
+                    double avgBpmLocal = calculateAverage(bpmValues);
+                    observer->onBpm(detectedPeakTime, peakTimeSec, bpm, avgBpmLocal);
+                }
+            }
+            if (lastPeakTime != 0) {
+                double irMax = intervalIr.maximum;
+                double irMin = intervalIr.minimum;
+                double redMax = intervalRed.maximum;
+                double redMin = intervalRed.minimum;
+                double irAC = irMax - irMin;
+                double redAC = redMax - redMin;
+                double irDC = (irMax + irMin) / 2.0;
+                double redDC = (redMax + redMin) / 2.0;
+                if (irAC > 0 && redAC > 0 && irDC > 0 && redDC > 0) {
+                    double R = (redAC / redDC) / (irAC / irDC);
+                    int spo2p = static_cast<int>(110 - 25.0 * R);
+                    spo2p = qBound(80, spo2p, 100);
+                    observer->onSpo2Peak(detectedPeakTime, peakTimeSec, spo2p);
+                }
+            }
+            // Новый интервал начинается с текущего отсчёта
+            intervalIr.reset(infraredValue);
+            intervalRed.reset(redValue);
+            lastPeakTime = detectedPeakTime;
+        }
+    }
+    // --- Конец алгоритма детекции пиков ---
+}
@@ -0,0 +1,99 @@
+#ifndef SIGNALPROCESSOR_H
+#define SIGNALPROCESSOR_H
+
+#include <QVector>
+#include "bandPassFilter.h"
+#include "pipelineEvent.h"
+#include "sensorSample.h"
+#include "signalObserver.h"
+#include "slidingWindowMean.h"
+#include "spectralHeartRate.h"
+#include "windowExtremes.h"
+
+// Обработка сигнала без привязки к виджетам: окна DC для SpO₂, детекция пиков, BPM, SpO₂ по пикам.
+// Результаты передаются подписчику SignalObserver (например, PipelineEventCollector для передачи
+// в поток GUI); отображением занимается DataProcessor.
+class SignalProcessor
+{
+public:
+    SignalProcessor();
+
+    // Подписчик не принадлежит процессору; nullptr — результаты отбрасываются
+    void setObserver(SignalObserver* observer);
+
+    // Обрабатывает один отсчёт и сообщает результаты подписчику
+    void process(const SensorSample& sample);
+
+    // Обрабатывает непрерывный блок отсчётов (результат одного readyRead)
+    void processBatch(const SensorSample* samples, int count);
+
+    bool detectPeakImproved(double irValue, qint64 timestamp);
+    double calculateAverage(const QVector<double>& values);
+    double detectSpO2(double irValue, double redValue);
+
+    // Окно постоянной составляющей для метода AC/DC (по умолчанию 4 с); можно менять на ходу
+    void setSpo2WindowMs(int windowMs);
+    int getSpo2WindowMs() const { return spo2WindowMs; }
+
+    // Полосовой фильтр IR перед детекцией пиков (по умолчанию выключен — пики ищутся по сырому IR).
+    // Если частота дискретизации не задана, она оценивается по меткам времени за первую секунду,
+    // и до этого пики не ищутся. Значение пика в onPeak — по-прежнему исходный IR.
+    void setPeakFilter(const BandPassFilter::Settings& settings);
+    const BandPassFilter::Settings& getPeakFilter() const { return filterSettings; }
+
+    // Вторая оценка пульса — по спектру исходного IR (onSpectralBpm), по умолчанию включена.
+    // Не зависит от детекции пиков и их ограничения 45–120 уд/мин
+    void setSpectralHeartRate(const SpectralHeartRate::Settings& settings);
+    const SpectralHeartRate::Settings& getSpectralHeartRate() const { return spectralEstimator.getSettings(); }
+
+    qint64 getStartTime() const { return timeStart; }
+    double getElapsedTime() const { return (static_cast<double>(lastReceivedTimestamp - timeStart)) / 1000.0; }
+
+public:
+    enum PeakState { WAITING, RISING };
+
+private:
+    // peakInput — значение для поиска пика (IR после фильтра или сырой IR)
+    void processSample(const SensorSample& sample, double peakInput, bool detectPeaks);
+    // Оценка частоты дискретизации и расчёт фильтра; filterReady — со следующего отсчёта
+    void preparePeakFilter(const SensorSample& sample);
+
+    SignalObserver* observer;
+
+    QVector<double> bpmValues;
+    qint64 timeStart;
+    qint64 lastReceivedTimestamp;
+    qint64 lastPeakTime;
+
+    // Скользящие средние DC за spo2WindowMs, O(1) на отсчёт
+    SlidingWindowMean redDcWindow;
+    SlidingWindowMean irDcWindow;
+    int spo2WindowMs;
+
+    // Экстремумы IR и Red с последнего пика — для SpO₂ по размаху за цикл
+    RunningExtremes intervalIr;
+    RunningExtremes intervalRed;
+
+    // Для детекции пиков по окну:
+    const int windowSize;  // размер окна (например, 5)
+    PeakWindow peakWindow;
+
+    // Фильтр перед детекцией пиков
+    BandPassFilter::Settings filterSettings;
+    BandPassFilter peakFilter;
+    bool filterReady = false;
+    QVector<double> filteredValues;   // пары (IR, Red) текущего блока
+    qint64 rateFirstTimestamp = -1;   // для оценки частоты дискретизации
+    int rateSampleCount = 0;
+    double estimatedRateHz = 0.0;
+
+    SpectralHeartRate spectralEstimator;
+
+    PeakState peakState;
+    double previousValue;
+    double candidatePeak;
+    qint64 candidateTime;
+    const double dropThreshold;
+};
+
+#endif // SIGNALPROCESSOR_H
@@ -0,0 +1,56 @@
+#include "slidingWindowMean.h"
+
+SlidingWindowMean::SlidingWindowMean(qint64 windowMs)
+    : window(windowMs)
+{
+    ring.resize(64);
+    mask = ring.size() - 1;
+}
+
+void SlidingWindowMean::setWindowMs(qint64 windowMs)
+{
+    window = windowMs;
+    if (count > 0)
+        evictOlderThan(ring[(head + count - 1) & mask].timestamp);
+}
+
+void SlidingWindowMean::clear()
+{
+    head = 0;
+    count = 0;
+    sum = 0.0;
+    evictedSinceRecompute = 0;
+}
+
+void SlidingWindowMean::evictOlderThan(qint64 timestamp)
+{
+    // Та же граница, что и у прежней очереди: удаляется всё, что старше window
+    while (count > 0 && timestamp - ring[head].timestamp > window) {
+        sum -= ring[head].value;
+        head = (head + 1) & mask;
+        --count;
+        ++evictedSinceRecompute;
+    }
+    if (evictedSinceRecompute >= ring.size())
+        recomputeSum();
+}
+
+void SlidingWindowMean::grow()
+{
+    // Порядок сохраняется: самый старый отсчёт снова оказывается в начале
+    QVector<Entry> larger(ring.size() * 2);
+    for (int i = 0; i < count; ++i)
+        larger[i] = ring[(head + i) & mask];
+    ring.swap(larger);
+    mask = ring.size() - 1;
+    head = 0;
+}
+
+void SlidingWindowMean::recomputeSum()
+{
+    double exact = 0.0;
+    for (int i = 0; i < count; ++i)
+        exact += ring[(head + i) & mask].value;
+    sum = exact;
+    evictedSinceRecompute = 0;
+}
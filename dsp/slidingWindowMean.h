@@ -0,0 +1,55 @@
+#ifndef SLIDINGWINDOWMEAN_H
+#define SLIDINGWINDOWMEAN_H
+
+#include <QVector>
+
+// Среднее по скользящему окну времени за O(1) на отсчёт: кольцевой буфер (timestamp, value)
+// и текущая сумма. Отсчёты старше windowMs относительно последнего удаляются.
+// Чтобы ошибка округления текущей суммы не накапливалась, сумма пересчитывается заново
+// каждый раз, когда окно полностью обновилось, — амортизированно это тоже O(1).
+class SlidingWindowMean
+{
+public:
+    explicit SlidingWindowMean(qint64 windowMs = 4000);
+
+    // Новая длина окна применяется сразу (лишние старые отсчёты удаляются)
+    void setWindowMs(qint64 windowMs);
+    qint64 windowMs() const { return window; }
+
+    inline void add(qint64 timestamp, double value);
+
+    double mean() const { return count > 0 ? sum / count : 0.0; }
+    int size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    void clear();
+
+private:
+    struct Entry {
+        qint64 timestamp;
+        double value;
+    };
+
+    void evictOlderThan(qint64 timestamp);
+    void grow();
+    void recomputeSum();
+
+    QVector<Entry> ring; // ёмкость — степень двойки, растёт только при нехватке места
+    int mask = 0;
+    int head = 0;        // индекс самого старого отсчёта
+    int count = 0;
+    double sum = 0.0;
+    int evictedSinceRecompute = 0;
+    qint64 window;
+};
+
+inline void SlidingWindowMean::add(qint64 timestamp, double value)
+{
+    if (count == ring.size())
+        grow();
+    ring[(head + count) & mask] = { timestamp, value };
+    ++count;
+    sum += value;
+    evictOlderThan(timestamp);
+}
+
+#endif // SLIDINGWINDOWMEAN_H
@@ -0,0 +1,186 @@
+#include "spectralHeartRate.h"
+
+#include <QtMath>
+#include <cmath>
+
+namespace {
+const double highPassCutoffHz = 0.3; // ниже полосы пульса: дыхание и дрейф базовой линии
+const double subharmonicRatio = 0.2; // доля мощности пика, с которой 1/2 или 1/3 частоты считается основной
+}
+
+SpectralHeartRate::SpectralHeartRate()
+{
+    configure(Settings());
+}
+
+void SpectralHeartRate::configure(const Settings& newSettings)
+{
+    settings = newSettings;
+    length = qMax(rateHz * 2, settings.windowMs / stepMs);
+    reportEvery = qMax(1, settings.intervalMs / stepMs);
+    // Бин k — частота k·rateHz/length Гц; край полосы не выше частоты Найквиста
+    firstBin = qMax(2, int(std::ceil(settings.minBpm / 60.0 * length / rateHz)));
+    lastBin = qMin(length / 2 - 2, int(std::floor(settings.maxBpm / 60.0 * length / rateHz)));
+    lastBin = qMax(lastBin, firstBin);
+    highPassAlpha = std::exp(-2.0 * M_PI * highPassCutoffHz / rateHz);
+
+    unitRoots.resize(length);
+    for (int i = 0; i < length; ++i)
+        unitRoots[i] = std::polar(1.0, -2.0 * M_PI * i / length);
+    const int binCount = lastBin - firstBin + 3;
+    rotations.resize(binCount);
+    power.resize(lastBin - firstBin + 1);
+    for (int b = 0; b < binCount; ++b)
+        rotations[b] = std::conj(unitRoots[firstBin - 1 + b]);
+    reset();
+}
+
+void SpectralHeartRate::reset()
+{
+    bins.fill(std::complex<double>(), rotations.size());
+    ring.fill(0.0, length);
+    head = 0;
+    pushed = 0;
+    slot = -1;
+    slotSum = 0.0;
+    slotCount = 0;
+    highPassPrimed = false;
+    currentBpm = 0.0;
+    currentConfidence = 0.0;
+}
+
+bool SpectralHeartRate::add(qint64 timestamp, double value)
+{
+    const qint64 current = timestamp / stepMs;
+    bool ready = false;
+    if (slot >= 0 && current != slot) {
+        if (current < slot) {
+            // Время пошло назад (перезапуск ESP32) — начинаем окно заново
+            reset();
+        } else {
+            // Готов прореженный отсчёт; пропуск в данных заполняем последним значением
+            const double mean = slotSum / slotCount;
+            const qint64 gap = qMin<qint64>(current - slot - 1, length);
+            ready = push(mean);
+            for (qint64 i = 0; i < gap; ++i)
+                ready = push(mean) || ready;
+        }
+        slotSum = 0.0;
+        slotCount = 0;
+    }
+    slot = current;
+    slotSum += value;
+    ++slotCount;
+    return ready;
+}
+
+bool SpectralHeartRate::push(double value)
+{
+    if (!highPassPrimed) {
+        // Старт без скачка от постоянной составляющей ~100000
+        highPassIn = value;
+        highPassOut = 0.0;
+        highPassPrimed = true;
+    }
+    const double y = value - highPassIn + highPassAlpha * highPassOut;
+    highPassIn = value;
+    highPassOut = y;
+
+    // Скользящее ДПФ: X_k(n) = e^{j2πk/N}·(X_k(n−1) + x(n) − x(n−N))
+    const double delta = y - ring[head];
+    ring[head] = y;
+    head = (head + 1) % length;
+    ++pushed;
+    if (head == 0) {
+        resynchronize();
+    } else {
+        std::complex<double>* bin = bins.data();
+        const std::complex<double>* rotation = rotations.constData();
+        for (int b = 0; b < bins.size(); ++b)
+            bin[b] = (bin[b] + delta) * rotation[b];
+    }
+
+    if (pushed < length || pushed % reportEvery != 0)
+        return false;
+    return estimate();
+}
+
+void SpectralHeartRate::resynchronize()
+{
+    // Прямое ДПФ по кольцу (от самого старого отсчёта): раз в окно, O(бинов) на отсчёт в среднем
+    for (int b = 0; b < bins.size(); ++b) {
+        const int k = firstBin - 1 + b;
+        std::complex<double> sum;
+        int phase = 0;
+        for (int m = 0; m < length; ++m) {
+            sum += ring[(head + m) % length] * unitRoots[phase];
+            phase += k;
+            if (phase >= length)
+                phase -= length;
+        }
+        bins[b] = sum;
+    }
+}
+
+bool SpectralHeartRate::estimate()
+{
+    // Окно Ханна в частотной области: H_k = X_k/2 − (X_{k−1} + X_{k+1})/4
+    const int count = lastBin - firstBin + 1;
+    double total = 0.0;
+    int best = 0;
+    for (int i = 0; i < count; ++i) {
+        const std::complex<double> h = 0.5 * bins[i + 1] - 0.25 * (bins[i] + bins[i + 2]);
+        power[i] = std::norm(h);
+        total += power[i];
+        if (power[i] > power[best])
+            best = i;
+    }
+    if (total <= 0.0)
+        return false;
+
+    // Острый импульс даёт гармоники, сравнимые с основной частотой: если на 1/3 или 1/2
+    // найденной частоты тоже есть заметный пик, пульс — он
+    const auto localPeak = [&](int center) {
+        int peak = qBound(0, center, count - 1);
+        for (int i = qMax(0, center - 1); i <= qMin(count - 1, center + 1); ++i) {
+            if (power[i] > power[peak])
+                peak = i;
+        }
+        return peak;
+    };
+    for (int divisor = 3; divisor >= 2; --divisor) {
+        const int center = qRound(double(firstBin + best) / divisor) - firstBin;
+        if (center < 0)
+            continue;
+        const int candidate = localPeak(center);
+        if (power[candidate] >= subharmonicRatio * power[best]) {
+            best = candidate;
+            break;
+        }
+    }
+
+    // Уточнение между бинами: парабола через логарифмы амплитуд соседних бинов
+    double offset = 0.0;
+    if (best > 0 && best < count - 1 && power[best - 1] > 0.0 && power[best + 1] > 0.0) {
+        const double a = std::log(power[best - 1]);
+        const double b = std::log(power[best]);
+        const double c = std::log(power[best + 1]);
+        const double denominator = a - 2.0 * b + c;
+        if (denominator < 0.0)
+            offset = qBound(-0.5, 0.5 * (a - c) / denominator, 0.5);
+    }
+    currentBpm = 60.0 * (firstBin + best + offset) * rateHz / length;
+
+    // Уверенность — доля мощности полосы у основной частоты и её гармоник (±1 бин)
+    double pulsePower = 0.0;
+    int covered = -1;
+    for (int harmonic = 1; harmonic <= 3; ++harmonic) {
+        const int center = harmonic * (firstBin + best) - firstBin;
+        for (int i = qMax(covered + 1, center - 1); i <= qMin(count - 1, center + 1); ++i) {
+            pulsePower += power[i];
+            covered = i;
+        }
+    }
+    currentConfidence = qMin(1.0, pulsePower / total);
+    return true;
+}
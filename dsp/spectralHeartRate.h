@@ -0,0 +1,76 @@
+#ifndef SPECTRALHEARTRATE_H
+#define SPECTRALHEARTRATE_H
+
+#include <QVector>
+#include <complex>
+
+// Пульс по спектру IR — вторая оценка рядом с BPM по интервалам между пиками.
+// Отсчёты усредняются по 40 мс (25 Гц, по меткам времени — частота входа не важна),
+// затем ФВЧ убирает постоянную составляющую, и скользящее ДПФ обновляет только бины
+// полосы пульса: O(бинов) на прореженный отсчёт. Раз в окно бины пересчитываются заново
+// по кольцу, чтобы не копилась ошибка округления. Оценка — максимум спектра с окном Ханна
+// (свёртка трёх соседних бинов) с уточнением положения между бинами по параболе
+// через логарифмы амплитуд.
+class SpectralHeartRate
+{
+public:
+    struct Settings {
+        bool enabled = true;
+        int windowMs = 10000;    // длина окна ДПФ: разрешение 60000 / windowMs уд/мин до уточнения
+        int intervalMs = 1000;   // как часто выдавать оценку
+        double minBpm = 30.0;    // полоса поиска
+        double maxBpm = 240.0;
+    };
+
+    static constexpr int rateHz = 25;
+    static constexpr int stepMs = 1000 / rateHz;
+
+    SpectralHeartRate();
+
+    void configure(const Settings& settings);
+    const Settings& getSettings() const { return settings; }
+    void reset();
+
+    // Отсчёт IR; true — готова новая оценка bpm() и confidence()
+    bool add(qint64 timestamp, double value);
+
+    double bpm() const { return currentBpm; }
+    // Доля мощности полосы в пике (0…1): около 1 — чистый пульс, мало — шум или движение
+    double confidence() const { return currentConfidence; }
+
+private:
+    bool push(double value);
+    void resynchronize();
+    bool estimate();
+
+    Settings settings;
+    int length = 0;     // точек в окне ДПФ
+    int firstBin = 0;   // первый бин полосы поиска
+    int lastBin = 0;    // последний бин полосы поиска
+    int reportEvery = 1;
+    double highPassAlpha = 0.0;
+
+    // Бины firstBin-1 … lastBin+1: крайние нужны для окна Ханна
+    QVector<std::complex<double>> bins;
+    QVector<std::complex<double>> rotations;  // e^{+j2πk/N} для каждого бина
+    QVector<std::complex<double>> unitRoots;  // e^{-j2πi/N}, для пересчёта
+    QVector<double> ring;
+    QVector<double> power; // мощность бинов полосы при оценке
+    int head = 0;
+    qint64 pushed = 0;
+
+    // Прореживание по времени
+    qint64 slot = -1;
+    double slotSum = 0.0;
+    int slotCount = 0;
+
+    // ФВЧ первого порядка
+    bool highPassPrimed = false;
+    double highPassIn = 0.0;
+    double highPassOut = 0.0;
+
+    double currentBpm = 0.0;
+    double currentConfidence = 0.0;
+};
+
+#endif // SPECTRALHEARTRATE_H
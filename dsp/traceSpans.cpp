@@ -0,0 +1,171 @@
+#include "traceSpans.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <memory>
+
+namespace Trace {
+namespace detail {
+std::atomic<bool> enabled { false };
+}
+}
+
+namespace {
+
+// Кольцо одного потока. Пишет только владелец: поля — relaxed, номер следующей записи
+// публикуется с release. Читатель после копирования перечитывает номер и отбрасывает
+// записи, которые писатель мог за это время перезаписать (как в seqlock).
+struct ThreadBuffer {
+    struct Event {
+        std::atomic<const char*> name;
+        std::atomic<qint64> startNs;
+        std::atomic<qint64> endNs;
+    };
+
+    int tid = 0;
+    QString threadName;
+    std::unique_ptr<Event[]> events { new Event[Trace::bufferEvents] };
+    std::atomic<quint64> written { 0 };
+};
+
+struct CopiedEvent {
+    const char* name;
+    qint64 startNs;
+    qint64 endNs;
+};
+
+QMutex registryMutex;
+// Кольца не удаляются и после завершения потока — их интервалы нужны в выгрузке
+QVector<ThreadBuffer*> registry;
+thread_local ThreadBuffer* localBuffer = nullptr;
+
+ThreadBuffer* registerThread()
+{
+    ThreadBuffer* buffer = new ThreadBuffer();
+    const QThread* thread = QThread::currentThread();
+    QString name = thread ? thread->objectName() : QString();
+    if (name.isEmpty() && QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+        name = "main";
+    QMutexLocker locker(&registryMutex);
+    buffer->tid = registry.size() + 1;
+    buffer->threadName = name.isEmpty() ? QString("thread-%1").arg(buffer->tid) : name;
+    registry.append(buffer);
+    return buffer;
+}
+
+void copyEvents(const ThreadBuffer* buffer, qint64 sinceNs, QVector<CopiedEvent>& out)
+{
+    const quint64 capacity = Trace::bufferEvents;
+    const quint64 end = buffer->written.load(std::memory_order_acquire);
+    const quint64 begin = end > capacity ? end - capacity : 0;
+    QVector<CopiedEvent> copied;
+    copied.reserve(int(end - begin));
+    for (quint64 i = begin; i < end; ++i) {
+        const ThreadBuffer::Event& event = buffer->events[i % capacity];
+        copied.append({ event.name.load(std::memory_order_relaxed), event.startNs.load(std::memory_order_relaxed),
+                        event.endNs.load(std::memory_order_relaxed) });
+    }
+    // Записи с номером до after − capacity включительно могли быть перезаписаны во время копирования
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const quint64 after = buffer->written.load(std::memory_order_relaxed);
+    const quint64 firstIntact = qMax(begin, after >= capacity ? after - capacity + 1 : 0);
+    for (int i = int(qMin(firstIntact, end) - begin); i < copied.size(); ++i) {
+        if (copied[i].endNs >= sinceNs)
+            out.append(copied[i]);
+    }
+}
+
+} // namespace
+
+namespace Trace {
+
+void setEnabled(bool enabled)
+{
+    detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void record(const char* name, qint64 startNs, qint64 endNs)
+{
+    if (!localBuffer)
+        localBuffer = registerThread();
+    ThreadBuffer* buffer = localBuffer;
+    const quint64 index = buffer->written.load(std::memory_order_relaxed);
+    ThreadBuffer::Event& event = buffer->events[index % bufferEvents];
+    event.name.store(name, std::memory_order_relaxed);
+    event.startNs.store(startNs, std::memory_order_relaxed);
+    event.endNs.store(endNs, std::memory_order_relaxed);
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+bool writeChromeTrace(const QString& filePath, qint64 lastMs)
+{
+    const qint64 nowNs = monotonicNs();
+    const qint64 sinceNs = lastMs > 0 ? nowNs - lastMs * 1000000 : 0;
+    const QString processName = QCoreApplication::instance() ? QCoreApplication::applicationName()
+                                                             : QString("esp32");
+
+    QVector<ThreadBuffer*> buffers;
+    {
+        QMutexLocker locker(&registryMutex);
+        buffers = registry;
+    }
+
+    // Метки — монотонное время в мкс, как есть: Perfetto показывает их от первого интервала
+    QJsonArray traceEvents;
+    QJsonObject processMeta;
+    processMeta["ph"] = "M";
+    processMeta["name"] = "process_name";
+    processMeta["pid"] = 1;
+    processMeta["args"] = QJsonObject { { "name", processName } };
+    traceEvents.append(processMeta);
+
+    QVector<CopiedEvent> events;
+    for (const ThreadBuffer* buffer : std::as_const(buffers)) {
+        QJsonObject threadMeta;
+        threadMeta["ph"] = "M";
+        threadMeta["name"] = "thread_name";
+        threadMeta["pid"] = 1;
+        threadMeta["tid"] = buffer->tid;
+        threadMeta["args"] = QJsonObject { { "name", buffer->threadName } };
+        traceEvents.append(threadMeta);
+
+        events.resize(0);
+        copyEvents(buffer, sinceNs, events);
+        for (const CopiedEvent& event : std::as_const(events)) {
+            QJsonObject json;
+            json["name"] = QString::fromLatin1(event.name);
+            json["cat"] = "esp32";
+            json["ph"] = "X";
+            json["ts"] = event.startNs / 1000.0;
+            json["dur"] = (event.endNs - event.startNs) / 1000.0;
+            json["pid"] = 1;
+            json["tid"] = buffer->tid;
+            traceEvents.append(json);
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+    // Привязка монотонного времени к часам — чтобы сопоставить трассу с журналом
+    root["otherData"] = QJsonObject { { "wallClock", QDateTime::currentDateTime().toString(Qt::ISODateWithMs) },
+                                      { "monotonicUs", nowNs / 1000.0 } };
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot write trace to" << filePath << ":" << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+} // namespace Trace
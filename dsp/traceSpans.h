@@ -0,0 +1,67 @@
+#ifndef TRACESPANS_H
+#define TRACESPANS_H
+
+#include <QString>
+#include <atomic>
+#include <chrono>
+
+// Монотонное время в нс — одно для всех потоков, метки разных стадий можно вычитать
+inline qint64 monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Интервалы (spans) на горячих путях для разбора редких задержек уже после случая.
+// Каждый поток пишет в своё кольцо на bufferEvents интервалов (старые вытесняются),
+// без блокировок; выгрузка — формат Chrome Trace Event, открывается в Perfetto
+// (ui.perfetto.dev) и chrome://tracing. Пока запись выключена, интервал стоит одну
+// проверку флага.
+namespace Trace {
+
+constexpr int bufferEvents = 1 << 15; // на поток; ~0.8 МиБ, выделяется при первой записи
+
+namespace detail {
+extern std::atomic<bool> enabled;
+}
+
+inline bool enabled() { return detail::enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool enabled);
+
+// name — строковый литерал (хранится указатель)
+void record(const char* name, qint64 startNs, qint64 endNs);
+
+// Интервалы, закончившиеся за последние lastMs (0 — всё, что есть в кольцах), в файл JSON.
+// Кольца не очищаются; запись в других потоках не останавливается.
+bool writeChromeTrace(const QString& filePath, qint64 lastMs = 0);
+
+} // namespace Trace
+
+// Интервал от создания до конца области видимости
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char* spanName)
+        : name(Trace::enabled() ? spanName : nullptr)
+        , startNs(name ? monotonicNs() : 0)
+    {
+    }
+    ~TraceSpan()
+    {
+        if (name)
+            Trace::record(name, startNs, monotonicNs());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    qint64 startNs;
+};
+
+#define TRACE_SPAN_CONCAT_(a, b) a##b
+#define TRACE_SPAN_CONCAT(a, b) TRACE_SPAN_CONCAT_(a, b)
+#define TRACE_SPAN(name) TraceSpan TRACE_SPAN_CONCAT(traceSpan_, __LINE__)(name)
+
+#endif // TRACESPANS_H
@@ -0,0 +1,100 @@
+#ifndef WINDOWEXTREMES_H
+#define WINDOWEXTREMES_H
+
+#include <QVector>
+
+// Минимум и максимум с момента последнего reset() — без хранения самих значений
+struct RunningExtremes {
+    double minimum = 0.0;
+    double maximum = 0.0;
+    bool empty = true;
+
+    void add(double value)
+    {
+        if (empty) {
+            minimum = maximum = value;
+            empty = false;
+        } else if (value < minimum) {
+            minimum = value;
+        } else if (value > maximum) {
+            maximum = value;
+        }
+    }
+
+    //! Новый интервал начинается со значения value
+    void reset(double value)
+    {
+        minimum = maximum = value;
+        empty = false;
+    }
+};
+
+// Окно из size последних отсчётов для поиска пика в его центре.
+// Отсчёты лежат в кольцевом буфере (ничего не сдвигается), максимум окна отслеживается
+// монотонной очередью номеров отсчётов: значения в ней не возрастают, поэтому первый элемент —
+// самое раннее вхождение максимума, а равный ему более поздний отсчёт стоит сразу за ним.
+class PeakWindow
+{
+public:
+    explicit PeakWindow(int size)
+        : windowSize(size),
+        values(size),
+        rawValues(size),
+        timestamps(size),
+        maxQueue(size)
+    {
+    }
+
+    // rawValue — сопутствующее значение (например, IR до фильтра), в сравнении не участвует
+    void push(double value, qint64 timestamp, double rawValue)
+    {
+        const int slot = int(pushed % windowSize);
+        values[slot] = value;
+        rawValues[slot] = rawValue;
+        timestamps[slot] = timestamp;
+
+        // Максимум, вышедший из окна вместе с вытесненным отсчётом
+        if (queueCount > 0 && maxQueue[queueHead] + windowSize <= pushed) {
+            queueHead = (queueHead + 1) % windowSize;
+            --queueCount;
+        }
+        // Отсчёты меньше нового уже никогда не станут максимумом окна
+        while (queueCount > 0 && valueAt(maxQueue[back()]) < value)
+            --queueCount;
+        maxQueue[(queueHead + queueCount) % windowSize] = pushed;
+        ++queueCount;
+        ++pushed;
+    }
+
+    bool isFull() const { return pushed >= quint64(windowSize); }
+
+    // Центральный отсчёт строго больше всех остальных в окне
+    bool centerIsStrictMax() const
+    {
+        if (!isFull() || maxQueue[queueHead] != centerIndex())
+            return false;
+        return queueCount == 1 || valueAt(maxQueue[(queueHead + 1) % windowSize]) < valueAt(centerIndex());
+    }
+
+    void push(double value, qint64 timestamp) { push(value, timestamp, value); }
+
+    double centerValue() const { return valueAt(centerIndex()); }
+    double centerRawValue() const { return rawValues[int(centerIndex() % windowSize)]; }
+    qint64 centerTimestamp() const { return timestamps[int(centerIndex() % windowSize)]; }
+
+private:
+    quint64 centerIndex() const { return pushed - windowSize + windowSize / 2; }
+    double valueAt(quint64 index) const { return values[int(index % windowSize)]; }
+    int back() const { return (queueHead + queueCount - 1) % windowSize; }
+
+    int windowSize;
+    QVector<double> values;
+    QVector<double> rawValues;
+    QVector<qint64> timestamps;
+    QVector<quint64> maxQueue; // номера отсчётов, кольцевой буфер
+    int queueHead = 0;
+    int queueCount = 0;
+    quint64 pushed = 0;        // номер следующего отсчёта
+};
+
+#endif // WINDOWEXTREMES_H
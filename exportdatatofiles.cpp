@@ -1,182 +1,407 @@
 #include "exportdatatofiles.h"
-#include "dataProcessor.h"
+#include "columnFile.h"
+#include "sessionJournal.h"
+#include "traceSpans.h"
 
 #include <QFile>
 #include <QDir>
-#include <QDebug>
+#include <QLoggingCategory>
 #include <QTextStream>
-#include <QDataStream>
 #include <QDateTime>
 #include <QPointF>
 #include <QVector>
 #include <QList>
+#include <QFileInfo>
 
-void ExportDataToFiles::exportAllDataToText(const DataProcessor* dp, const QString &baseFilename)
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+Q_LOGGING_CATEGORY(lcExport, "esp32.export")
+
+namespace {
+
+// Общая часть saveVectorTxt для QVector<QPointF> и SeriesStore; forEachPoint(fn) перебирает точки
+template<typename ForEachPoint>
+bool writePointsTxt(ForEachPoint &&forEachPoint, qint64 timeStart, const QString &filename)
 {
-    if(!dp) {
-        qDebug() << "exportAllDataToText: dataProcessor is null!";
-        return;
+    QFile file(filename);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qCWarning(lcExport) << "saveVectorTxt: Cannot open file" << filename;
+        return false;
     }
+    QTextStream out(&file);
+
+    // Для каждой точки (QPointF): x() – это elapsedTime в секундах, y() – значение
+    // Восстанавливаем абсолютное время в миллисекундах и выводим в формате
+    // "hh:mm:ss <tab> value"
+    forEachPoint([&out, timeStart](const QPointF &p) {
+        qint64 absoluteMs = timeStart + static_cast<qint64>(p.x() * 1000);
+        QDateTime dt = QDateTime::fromMSecsSinceEpoch(absoluteMs);
+        QString timeStr = dt.toString("hh:mm:ss");
+        out << timeStr << "\t" << p.y() << "\n";
+    });
+    file.close();
+    qCDebug(lcExport) << "Saved TXT:" << filename;
+    return true;
+}
+
+} // namespace
 
-    // Создаём (или проверяем) папку "Result"
-    QDir dir("Result");
+bool ExportDataToFiles::exportAllDataToText(const SessionHistory &history,
+                                            const QVector<MinuteBPMData> &minuteRecords,
+                                            const QString &baseFilename,
+                                            const QString &directory,
+                                            bool includeSamples)
+{
+    TRACE_SPAN("ExportDataToFiles::exportAllDataToText");
+    // Создаём (или проверяем) папку (по умолчанию "Result")
+    QDir dir(directory);
     if(!dir.exists()) {
         dir.mkpath(".");
     }
 
-    qint64 startTime = dp->getStartTime();
+    qint64 startTime = history.getStartTime();
+    bool ok = true;
 
     // 1) IR
-    QString pathIR = dir.absoluteFilePath(baseFilename + "_IR.txt");
-    saveVectorTxt(dp->getAllIRData(), startTime, pathIR);
+    if (includeSamples) {
+        QString pathIR = dir.absoluteFilePath(baseFilename + "_IR.txt");
+        ok &= saveSamplesTxt(history.samples(), SampleColumn::Ir, pathIR);
+    }
 
     // 2) Red
-    QString pathRed = dir.absoluteFilePath(baseFilename + "_Red.txt");
-    saveVectorTxt(dp->getAllRedData(), startTime, pathRed);
+    if (includeSamples) {
+        QString pathRed = dir.absoluteFilePath(baseFilename + "_Red.txt");
+        ok &= saveSamplesTxt(history.samples(), SampleColumn::Red, pathRed);
+    }
 
     // 3) BPM (временной ряд)
     QString pathBpm = dir.absoluteFilePath(baseFilename + "_BPM.txt");
-    saveVectorTxt(dp->getAllBpmData(), startTime, pathBpm);
+    ok &= saveVectorTxt(history.getAllBpmData(), startTime, pathBpm);
 
     // 4) AvgBPM (временной ряд)
     QString pathAvgBpm = dir.absoluteFilePath(baseFilename + "_AvgBPM.txt");
-    saveVectorTxt(dp->getAllAvgBpmData(), startTime, pathAvgBpm);
+    ok &= saveVectorTxt(history.getAllAvgBpmData(), startTime, pathAvgBpm);
 
     // 5) Temperature
-    QString pathTemp = dir.absoluteFilePath(baseFilename + "_Temp.txt");
-    saveVectorTxt(dp->getAllTempData(), startTime, pathTemp);
+    if (includeSamples) {
+        QString pathTemp = dir.absoluteFilePath(baseFilename + "_Temp.txt");
+        ok &= saveSamplesTxt(history.samples(), SampleColumn::Temp, pathTemp);
+    }
 
     // 6) SpO2 (AC/DC)
     QString pathSpo2 = dir.absoluteFilePath(baseFilename + "_Spo2.txt");
-    saveVectorTxt(dp->getAllSpo2Data(), startTime, pathSpo2);
+    ok &= saveVectorTxt(history.getAllSpo2Data(), startTime, pathSpo2);
 
     // 7) SpO2 by peaks
     QString pathSpo2P = dir.absoluteFilePath(baseFilename + "_Spo2Peaks.txt");
-    saveVectorTxt(dp->getAllSpo2PeakData(), startTime, pathSpo2P);
+    ok &= saveVectorTxt(history.getAllSpo2PeakData(), startTime, pathSpo2P);
 
-    // 7) Файл с данными по BPM за 1 минуту (среднее, минимум, максимум)
+    // 7) Файл с данными по BPM за 1 минуту (среднее, минимум, максимум, медиана)
     QString pathBpm1min = dir.absoluteFilePath(baseFilename + "_BPM1min.txt");
-    QFile file(pathBpm1min);
-    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "exportAllDataToText: Cannot open file" << pathBpm1min;
-    } else {
-        QTextStream out(&file);
-        // Заголовок файла
-        out << "Minute\tAvg BPM\tMin BPM\tMax BPM\n";
-        // Получаем накопленные записи за каждую минуту
-        const QVector<MinuteBPMData>& records = dp->getMinuteCalculator()->getMinuteBPMRecords();
-        for (int i = 0; i < records.size(); ++i) {
-            const MinuteBPMData& rec = records[i];
-            // Выводим время в формате ЧЧ:ММ и три значения через табуляцию
-            out << rec.minuteTimestamp.toString("hh:mm") << "\t"
-                << rec.averageBPM << "\t"
-                << rec.minBPM << "\t"
-                << rec.maxBPM << "\n";
-        }
-        file.close();
-        qDebug() << "Saved BPM 1min TXT:" << pathBpm1min;
-    }
+    ok &= saveMinuteRecordsTxt(minuteRecords, pathBpm1min);
 
-    qDebug() << "Text export complete, baseFilename =" << baseFilename;
+    qCInfo(lcExport) << "Text export complete, baseFilename =" << baseFilename;
+    return ok;
 }
 
-void ExportDataToFiles::exportAllDataToBinary(const DataProcessor* dp, const QString &baseFilename)
+bool ExportDataToFiles::exportAllDataToBinary(const SessionHistory &history,
+                                              const QString &baseFilename,
+                                              const QString &directory,
+                                              bool includeSamples)
 {
-    if(!dp) {
-        qDebug() << "exportAllDataToBinary: dataProcessor is null!";
-        return;
-    }
-
-    // Папка "Result_Binar"
-    QDir dir("Result_Binar");
+    TRACE_SPAN("ExportDataToFiles::exportAllDataToBinary");
+    // Папка (по умолчанию "Result_Binar")
+    QDir dir(directory);
     if(!dir.exists()) {
         dir.mkpath(".");
     }
 
-    qint64 startTime = dp->getStartTime();
+    qint64 startTime = history.getStartTime();
+    // В заголовке — настенное время начала сессии, а не момент экспорта
+    qint64 startEpochMs = history.getStartEpochMs();
+    bool ok = true;
 
-    // 1) IR
-    QString pathIR = dir.absoluteFilePath(baseFilename + "_IR.bin");
-    saveVectorBin(dp->getAllIRData(), startTime, pathIR);
+    // 1) IR, Red, Temp — один файл, общая ось времени
+    if (includeSamples) {
+        QString pathSamples = dir.absoluteFilePath(baseFilename + "_samples" + ColumnFileFormat::suffix);
+        ok &= saveSamplesColumns(history.samples(), startTime, startEpochMs, pathSamples);
+    }
 
-    // 2) Red
-    QString pathRed = dir.absoluteFilePath(baseFilename + "_Red.bin");
-    saveVectorBin(dp->getAllRedData(), startTime, pathRed);
+    // 2) BPM и AvgBPM — одни и те же моменты времени
+    QString pathBpm = dir.absoluteFilePath(baseFilename + "_BPM" + ColumnFileFormat::suffix);
+    ok &= saveSeriesColumns({ "BPM", "AvgBPM" }, { history.getAllBpmData(), history.getAllAvgBpmData() },
+                            startTime, startEpochMs, pathBpm);
 
-    // 3) BPM
-    QString pathBpm = dir.absoluteFilePath(baseFilename + "_BPM.bin");
-    saveVectorBin(dp->getAllBpmData(), startTime, pathBpm);
+    // 3) SpO2 (AC/DC)
+    QString pathSpo2 = dir.absoluteFilePath(baseFilename + "_Spo2" + ColumnFileFormat::suffix);
+    ok &= saveSeriesColumns("SpO2", history.getAllSpo2Data(), startTime, startEpochMs, pathSpo2);
 
-    // 4) AvgBPM
-    QString pathAvgBpm = dir.absoluteFilePath(baseFilename + "_AvgBPM.bin");
-    saveVectorBin(dp->getAllAvgBpmData(), startTime, pathAvgBpm);
+    // 4) SpO2 by peaks
+    QString pathSpo2P = dir.absoluteFilePath(baseFilename + "_Spo2Peaks" + ColumnFileFormat::suffix);
+    ok &= saveSeriesColumns({ "SpO2Peaks" }, { history.getAllSpo2PeakData() }, startTime, startEpochMs,
+                            pathSpo2P);
 
-    // 5) Temp
-    QString pathTemp = dir.absoluteFilePath(baseFilename + "_Temp.bin");
-    saveVectorBin(dp->getAllTempData(), startTime, pathTemp);
+    qCInfo(lcExport) << "Binary export complete, baseFilename =" << baseFilename;
+    return ok;
+}
 
-    // 6) SpO2 (AC/DC)
-    QString pathSpo2 = dir.absoluteFilePath(baseFilename + "_Spo2.bin");
-    saveVectorBin(dp->getAllSpo2Data(), startTime, pathSpo2);
+bool ExportDataToFiles::exportJournal(const QStringList &segments,
+                                      const QVector<MinuteBPMData> &minuteRecords,
+                                      const QString &baseFilename,
+                                      const QString &directory)
+{
+    TRACE_SPAN("ExportDataToFiles::exportJournal");
+    QDir dir(directory);
+    if(!dir.exists()) {
+        dir.mkpath(".");
+    }
 
-    // 7) SpO2 by peaks
-    QString pathSpo2P = dir.absoluteFilePath(baseFilename + "_Spo2Peaks.bin");
-    saveVectorBin(dp->getAllSpo2PeakData(), startTime, pathSpo2P);
+    bool ok = true;
+    QString manifest;
+    int linked = 0;
+    for (const QString &segment : segments) {
+        const QString target = dir.absoluteFilePath(baseFilename + "_" + QFileInfo(segment).fileName());
+        QFile::remove(target);
+        if (hardLink(segment, target)) {
+            manifest += target + "\n";
+            ++linked;
+        } else {
+            // Копия многочасовой сессии заняла бы минуты — указываем, где лежит сегмент
+            manifest += QFileInfo(segment).absoluteFilePath() + "\n";
+        }
+    }
+
+    const QString pathManifest = dir.absoluteFilePath(baseFilename + "_journal.txt");
+    QFile file(pathManifest);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qCWarning(lcExport) << "exportJournal: Cannot open file" << pathManifest;
+        ok = false;
+    } else {
+        file.write(manifest.toUtf8());
+        file.close();
+    }
+
+    if (!minuteRecords.isEmpty())
+        ok &= saveMinuteRecordsTxt(minuteRecords, dir.absoluteFilePath(baseFilename + "_BPM1min.txt"));
 
-    qDebug() << "Binary export complete, baseFilename =" << baseFilename;
+    qCInfo(lcExport) << "Journal export complete, baseFilename =" << baseFilename << ":"
+                     << segments.size() << "segments," << linked << "linked";
+    return ok;
+}
+
+bool ExportDataToFiles::exportJournalToText(const QStringList &segments,
+                                            const QVector<MinuteBPMData> &minuteRecords,
+                                            const QString &baseFilename,
+                                            const QString &directory,
+                                            bool includeSamples)
+{
+    TRACE_SPAN("ExportDataToFiles::exportJournalToText");
+    SessionHistory history;
+    history.setKeepSamples(includeSamples);
+    if (!loadJournal(segments, history))
+        return false;
+    return exportAllDataToText(history, minuteRecords, baseFilename, directory, includeSamples);
+}
+
+bool ExportDataToFiles::exportJournalToBinary(const QStringList &segments,
+                                              const QString &baseFilename,
+                                              const QString &directory,
+                                              bool includeSamples)
+{
+    TRACE_SPAN("ExportDataToFiles::exportJournalToBinary");
+    SessionHistory history;
+    history.setKeepSamples(includeSamples);
+    if (!loadJournal(segments, history))
+        return false;
+    bool ok = exportAllDataToBinary(history, baseFilename, directory, includeSamples);
+    ok &= exportJournal(segments, {}, baseFilename, directory);
+    return ok;
 }
 
 // --------------------- Приватные методы ---------------------
 
-void ExportDataToFiles::saveVectorTxt(const QVector<QPointF> &data,
-                                      qint64 timeStart,
-                                      const QString &filename)
+bool ExportDataToFiles::loadJournal(const QStringList &segments, SessionHistory &history)
+{
+    PipelineEvent event;
+    for (const QString &segment : segments) {
+        SessionJournalReader reader;
+        if (!reader.open(segment)) {
+            qCWarning(lcExport) << "loadJournal: Cannot read segment" << segment << ":" << reader.errorString();
+            return false;
+        }
+        if (history.getStartEpochMs() < 0)
+            history.setStartEpochMs(reader.startEpochMs());
+        while (reader.readNext(event))
+            history.apply(event);
+        // Неизвестная запись — сегмент повреждён; всё прочитанное до неё остаётся в экспорте
+        if (reader.hasError())
+            qCWarning(lcExport) << "loadJournal:" << segment << ":" << reader.errorString();
+    }
+    return true;
+}
+
+bool ExportDataToFiles::hardLink(const QString &existing, const QString &link)
+{
+#if defined(Q_OS_WIN)
+    return CreateHardLinkW(reinterpret_cast<const wchar_t *>(link.utf16()),
+                           reinterpret_cast<const wchar_t *>(existing.utf16()), nullptr);
+#elif defined(Q_OS_UNIX)
+    return ::link(QFile::encodeName(existing).constData(), QFile::encodeName(link).constData()) == 0;
+#else
+    Q_UNUSED(existing);
+    Q_UNUSED(link);
+    return false;
+#endif
+}
+
+bool ExportDataToFiles::saveMinuteRecordsTxt(const QVector<MinuteBPMData> &records, const QString &filename)
 {
     QFile file(filename);
     if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "saveVectorTxt: Cannot open file" << filename;
-        return;
+        qCWarning(lcExport) << "saveMinuteRecordsTxt: Cannot open file" << filename;
+        return false;
     }
     QTextStream out(&file);
-
-    // Для каждой точки (QPointF): x() – это elapsedTime в секундах, y() – значение
-    // Восстанавливаем абсолютное время в миллисекундах и выводим в формате
-    // "hh:mm:ss <tab> value"
-    for(const QPointF &p : data) {
-        qint64 absoluteMs = timeStart + static_cast<qint64>(p.x() * 1000);
-        QDateTime dt = QDateTime::fromMSecsSinceEpoch(absoluteMs);
-        QString timeStr = dt.toString("hh:mm:ss");
-        out << timeStr << "\t" << p.y() << "\n";
+    // Заголовок файла
+    out << "Minute\tAvg BPM\tMin BPM\tMax BPM\tMedian BPM\n";
+    for (int i = 0; i < records.size(); ++i) {
+        const MinuteBPMData& rec = records[i];
+        // Выводим время в формате ЧЧ:ММ и четыре значения через табуляцию
+        out << rec.minuteTimestamp.toString("hh:mm") << "\t"
+            << rec.averageBPM << "\t"
+            << rec.minBPM << "\t"
+            << rec.maxBPM << "\t"
+            << rec.medianBPM << "\n";
     }
     file.close();
-    qDebug() << "Saved TXT:" << filename;
+    qCDebug(lcExport) << "Saved BPM 1min TXT:" << filename;
+    return true;
 }
 
-void ExportDataToFiles::saveVectorBin(const QVector<QPointF> &data,
-                                      qint64 timeStart,
-                                      const QString &filename)
+double ExportDataToFiles::columnValue(const SampleStore::Row &row, SampleColumn column)
+{
+    switch (column) {
+    case SampleColumn::Ir:
+        return row.ir;
+    case SampleColumn::Red:
+        return row.red;
+    case SampleColumn::Temp:
+        break;
+    }
+    return row.temp;
+}
+
+bool ExportDataToFiles::saveSamplesTxt(const SampleStore &samples, SampleColumn column, const QString &filename)
 {
     QFile file(filename);
-    if(!file.open(QIODevice::WriteOnly)) {
-        qDebug() << "saveVectorBin: Cannot open file" << filename;
-        return;
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qCWarning(lcExport) << "saveSamplesTxt: Cannot open file" << filename;
+        return false;
     }
-    QDataStream out(&file);
+    QTextStream out(&file);
 
-    // Формат: (int hour, int min, int sec, int msec, double value)
-    // Для каждой точки
-    for(const QPointF &p : data) {
-        qint64 absoluteMs = timeStart + static_cast<qint64>(p.x() * 1000);
-        QDateTime dt = QDateTime::fromMSecsSinceEpoch(absoluteMs);
+    // Время отсчёта хранится целым числом миллисекунд — пересчёт из секунд не нужен
+    samples.forEach([&out, column](const SampleStore::Row &row) {
+        QDateTime dt = QDateTime::fromMSecsSinceEpoch(row.time);
+        out << dt.toString("hh:mm:ss") << "\t" << columnValue(row, column) << "\n";
+    });
+    file.close();
+    qCDebug(lcExport) << "Saved TXT:" << filename;
+    return true;
+}
 
-        int hour   = dt.time().hour();
-        int minute = dt.time().minute();
-        int second = dt.time().second();
-        int msec   = dt.time().msec();
-        double val = p.y();
+bool ExportDataToFiles::saveSamplesColumns(const SampleStore &samples, qint64 originTimestamp,
+                                           qint64 startEpochMs, const QString &filename)
+{
+    // Типы — как в SampleStore: АЦП без дробной части, температура в сотых долях °C
+    const QVector<ColumnChannel> channels = {
+        { "IR", ColumnFileFormat::UInt32, 1.0 },
+        { "Red", ColumnFileFormat::UInt32, 1.0 },
+        { "Temp", ColumnFileFormat::Int16, 0.01 },
+    };
+    ColumnFileWriter writer;
+    if (!writer.open(filename, channels, originTimestamp, startEpochMs, ColumnFileFormat::SessionTime)) {
+        qCWarning(lcExport) << "saveSamplesColumns: Cannot open file" << filename << ":" << writer.errorString();
+        return false;
+    }
+    // Время сессии, как у рядов BPM и SpO2: после перезапуска платы метки продолжают расти
+    samples.forEach([&writer](const SampleStore::Row &row) {
+        const double values[] = { row.ir, row.red, row.temp };
+        writer.append(row.time, values);
+    });
+    if (!writer.close()) {
+        qCWarning(lcExport) << "saveSamplesColumns: Write failed" << filename << ":" << writer.errorString();
+        return false;
+    }
+    qCDebug(lcExport) << "Saved BIN:" << filename;
+    return true;
+}
 
-        out << hour << minute << second << msec << val;
+bool ExportDataToFiles::saveSeriesColumns(const QStringList &names,
+                                          const QVector<QVector<QPointF>> &series,
+                                          qint64 timeStart,
+                                          qint64 startEpochMs,
+                                          const QString &filename)
+{
+    QVector<ColumnChannel> channels;
+    for (const QString &name : names)
+        channels.append({ name, ColumnFileFormat::Float64, 1.0 });
+    ColumnFileWriter writer;
+    if (!writer.open(filename, channels, timeStart, startEpochMs, ColumnFileFormat::SessionTime)) {
+        qCWarning(lcExport) << "saveSeriesColumns: Cannot open file" << filename << ":" << writer.errorString();
+        return false;
     }
-    file.close();
-    qDebug() << "Saved BIN:" << filename;
+    // x() — секунды времени сессии от начала; метка восстанавливается до миллисекунды
+    QVector<double> values(series.size());
+    for (int i = 0; i < series.first().size(); ++i) {
+        for (int c = 0; c < series.size(); ++c)
+            values[c] = series[c][i].y();
+        writer.append(timeStart + qRound64(series.first()[i].x() * 1000), values.constData());
+    }
+    if (!writer.close()) {
+        qCWarning(lcExport) << "saveSeriesColumns: Write failed" << filename << ":" << writer.errorString();
+        return false;
+    }
+    qCDebug(lcExport) << "Saved BIN:" << filename;
+    return true;
+}
+
+bool ExportDataToFiles::saveSeriesColumns(const QString &name, const SeriesStore &series, qint64 timeStart,
+                                          qint64 startEpochMs, const QString &filename)
+{
+    ColumnFileWriter writer;
+    if (!writer.open(filename, { { name, ColumnFileFormat::Float64, 1.0 } }, timeStart, startEpochMs,
+                     ColumnFileFormat::SessionTime)) {
+        qCWarning(lcExport) << "saveSeriesColumns: Cannot open file" << filename << ":" << writer.errorString();
+        return false;
+    }
+    series.forEach([&writer, timeStart](const QPointF &p) {
+        const double value = p.y();
+        writer.append(timeStart + qRound64(p.x() * 1000), &value);
+    });
+    if (!writer.close()) {
+        qCWarning(lcExport) << "saveSeriesColumns: Write failed" << filename << ":" << writer.errorString();
+        return false;
+    }
+    qCDebug(lcExport) << "Saved BIN:" << filename;
+    return true;
+}
+
+bool ExportDataToFiles::saveVectorTxt(const QVector<QPointF> &data,
+                                      qint64 timeStart,
+                                      const QString &filename)
+{
+    return writePointsTxt([&data](auto &&fn) {
+        for (const QPointF &p : data)
+            fn(p);
+    }, timeStart, filename);
+}
+
+bool ExportDataToFiles::saveVectorTxt(const SeriesStore &data, qint64 timeStart, const QString &filename)
+{
+    return writePointsTxt([&data](auto &&fn) { data.forEach(fn); }, timeStart, filename);
 }
@@ -5,24 +5,83 @@
 #include <QPointF>
 #include <QVector>
 #include <QList>
-class DataProcessor;
+#include <QStringList>
+#include "minuteStatistics.h"
+#include "sessionHistory.h"
 
+// Экспорт не зависит от графиков: окно и пакетная обработка записей пишут одинаковые файлы.
+// Методы возвращают false, если хотя бы один файл не удалось записать.
 class ExportDataToFiles
 {
 public:
-    // Экспорт всех «полных» данных (IR, Red, BPM, ... ) в текстовые файлы
-    static void exportAllDataToText(const DataProcessor* dp, const QString &baseFilename);
+    // Экспорт всех «полных» данных (IR, Red, BPM, ... ) и поминутной статистики в текстовые файлы.
+    // includeSamples = false — без файлов исходных отсчётов (IR, Red, Temp)
+    static bool exportAllDataToText(const SessionHistory &history,
+                                    const QVector<MinuteBPMData> &minuteRecords,
+                                    const QString &baseFilename,
+                                    const QString &directory = "Result",
+                                    bool includeSamples = true);
 
-    // Экспорт в двоичном (binary) формате
-    static void exportAllDataToBinary(const DataProcessor* dp, const QString &baseFilename);
+    // Экспорт в двоичном формате .espc (columnFile.h): отсчёты (IR, Red, Temp) одним файлом,
+    // BPM вместе с AvgBPM, SpO₂ обоими методами — по файлу; время — исходное время ESP32
+    static bool exportAllDataToBinary(const SessionHistory &history,
+                                      const QString &baseFilename,
+                                      const QString &directory = "Result_Binar",
+                                      bool includeSamples = true);
+
+    // Экспорт при непрерывной записи (SessionJournal): закрытые сегменты журнала не переписываются,
+    // а связываются жёсткими ссылками в каталог экспорта (на другом томе — перечисляются в манифесте
+    // <baseFilename>_journal.txt) — время не зависит от длительности сессии.
+    // Непустые minuteRecords — ещё и файл поминутной статистики, как в текстовом экспорте
+    static bool exportJournal(const QStringList &segments,
+                              const QVector<MinuteBPMData> &minuteRecords,
+                              const QString &baseFilename,
+                              const QString &directory = "Result");
+
+    // Экспорт при непрерывной записи в те же файлы, что exportAllDataToText / exportAllDataToBinary:
+    // история строится заново из закрытых сегментов журнала (SessionJournal::finalizeSegments).
+    // Закрытые сегменты не меняются, поэтому экспорт идёт в любом потоке, пока окно продолжает приём.
+    // Двоичный экспорт вдобавок связывает сами сегменты (exportJournal) — исходный архив сессии
+    static bool exportJournalToText(const QStringList &segments,
+                                    const QVector<MinuteBPMData> &minuteRecords,
+                                    const QString &baseFilename,
+                                    const QString &directory = "Result",
+                                    bool includeSamples = true);
+    static bool exportJournalToBinary(const QStringList &segments,
+                                      const QString &baseFilename,
+                                      const QString &directory = "Result_Binar",
+                                      bool includeSamples = true);
 
 private:
-    // Вспомогательные методы для сохранения одного вектора в TXT/BIN
-    static void saveVectorTxt(const QVector<QPointF> &data, qint64 startTime, const QString &filename);
+    // События сегментов по порядку — в history; время начала сессии — из заголовка журнала
+    static bool loadJournal(const QStringList &segments, SessionHistory &history);
+
+    enum class SampleColumn { Ir, Red, Temp };
+    static double columnValue(const SampleStore::Row &row, SampleColumn column);
+
+    // Один столбец исходных отсчётов в TXT (формат строк тот же, что у saveVectorTxt)
+    static bool saveSamplesTxt(const SampleStore &samples, SampleColumn column, const QString &filename);
+    // Все столбцы исходных отсчётов в один .espc; startEpochMs — настенное время начала сессии
+    static bool saveSamplesColumns(const SampleStore &samples, qint64 originTimestamp, qint64 startEpochMs,
+                                   const QString &filename);
+    // Ряды одинаковой длины с общими моментами времени (x — секунды от timeStart) — в один .espc
+    static bool saveSeriesColumns(const QStringList &names,
+                                  const QVector<QVector<QPointF>> &series,
+                                  qint64 timeStart,
+                                  qint64 startEpochMs,
+                                  const QString &filename);
+    static bool saveSeriesColumns(const QString &name, const SeriesStore &series, qint64 timeStart,
+                                  qint64 startEpochMs, const QString &filename);
+
+    // Жёсткая ссылка на файл (тот же том); false — не поддерживается или не удалась
+    static bool hardLink(const QString &existing, const QString &link);
+
+    // Поминутная статистика BPM: среднее, минимум, максимум, медиана
+    static bool saveMinuteRecordsTxt(const QVector<MinuteBPMData> &records, const QString &filename);
 
-    static void saveVectorBin(const QVector<QPointF> &data,
-                              qint64 timeStart,
-                              const QString &filename);
+    // Вспомогательный метод для сохранения одного вектора в TXT
+    static bool saveVectorTxt(const QVector<QPointF> &data, qint64 startTime, const QString &filename);
+    static bool saveVectorTxt(const SeriesStore &data, qint64 startTime, const QString &filename);
 };
 
 #endif // EXPORTDATAFILES_H
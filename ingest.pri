@@ -0,0 +1,18 @@
+# Общий код приёма и разбора потока данных ESP32 (приложение, бенчмарки, эмулятор)
+# SensorSample объявлен в dsp/ (только заголовок, без линковки с библиотекой)
+INCLUDEPATH += $$PWD $$PWD/dsp
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/binaryProtocol.cpp \
+    $$PWD/csvSampleParser.cpp \
+    $$PWD/replaySource.cpp \
+    $$PWD/sampleStreamDecoder.cpp \
+    $$PWD/streamRecording.cpp
+
+HEADERS += \
+    $$PWD/binaryProtocol.h \
+    $$PWD/csvSampleParser.h \
+    $$PWD/replaySource.h \
+    $$PWD/sampleStreamDecoder.h \
+    $$PWD/streamRecording.h
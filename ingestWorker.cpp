@@ -0,0 +1,127 @@
+#include "ingestWorker.h"
+#include "replaySource.h"
+#include "sessionJournal.h"
+#include "traceSpans.h"
+
+#include <QLoggingCategory>
+
+Q_LOGGING_CATEGORY(lcParse, "esp32.parse")
+
+IngestWorker::IngestWorker(const QString& host, quint16 port,
+                           const ConnectionManager::Settings& connectionSettings, QObject* parent)
+    : QObject(parent),
+    host(host),
+    port(port),
+    eventRing(eventRingCapacity)
+{
+    // Дочерний объект переезжает в поток обработки вместе с IngestWorker
+    connectionManager = new ConnectionManager(this);
+    connectionManager->setSettings(connectionSettings);
+    connectionManager->setEndpoint(host, port);
+    processedEvents.reserve(1024);
+    signalProcessor.setObserver(&eventCollector);
+}
+
+void IngestWorker::start() {
+    // Все объекты создаются здесь, чтобы они принадлежали потоку обработки
+    decodeErrorFlush = new QTimer(this);
+    decodeErrorFlush->setSingleShot(true);
+    decodeErrorFlush->setInterval(int(decodeErrorLog.interval()));
+    connect(decodeErrorFlush, &QTimer::timeout, this, &IngestWorker::reportDecodeErrors);
+
+    if (isReplay()) {
+        dataReceiver = new DataReceiver(nullptr, this);
+        dataReceiver->setDecodeLatency(&pipelineStats[PipelineStats::Decode]);
+        connect(dataReceiver, &DataReceiver::dataBatchReady, this, &IngestWorker::onBatchReceived);
+        connect(dataReceiver, &DataReceiver::decodeStatsChanged, this, &IngestWorker::onDecodeStatsChanged);
+        replaySource = new ReplaySource(replayFile, replaySpeed, this);
+        connect(replaySource, &ReplaySource::chunkReady, dataReceiver, &DataReceiver::feedChunk);
+        connect(replaySource, &ReplaySource::streamReset, dataReceiver, &DataReceiver::resetStream);
+        replaySource->start();
+        return;
+    }
+
+    socket = new QTcpSocket(this);
+    socket->setReadBufferSize(0);
+    connectionManager->setSocket(socket);
+
+    dataReceiver = new DataReceiver(socket, this);
+    dataReceiver->setDecodeLatency(&pipelineStats[PipelineStats::Decode]);
+    connect(socket, &QTcpSocket::readyRead, dataReceiver, &DataReceiver::readData);
+    connect(dataReceiver, &DataReceiver::dataBatchReady, this, &IngestWorker::onBatchReceived);
+    connect(dataReceiver, &DataReceiver::decodeStatsChanged, this, &IngestWorker::onDecodeStatsChanged);
+    if (!recordFile.isEmpty() && recorder.open(recordFile))
+        dataReceiver->setRecorder(&recorder);
+
+    connectionManager->start();
+}
+
+void IngestWorker::setHost(const QString& newHost) {
+    host = newHost;
+    connectionManager->setEndpoint(host, port);
+    if (socket)
+        connectionManager->restart();
+}
+
+void IngestWorker::setSpo2WindowMs(int windowMs) {
+    signalProcessor.setSpo2WindowMs(windowMs);
+}
+
+void IngestWorker::setPeakFilter(const BandPassFilter::Settings& settings) {
+    signalProcessor.setPeakFilter(settings);
+}
+
+void IngestWorker::setSpectralHeartRate(const SpectralHeartRate::Settings& settings) {
+    signalProcessor.setSpectralHeartRate(settings);
+}
+
+void IngestWorker::onBatchReceived(const QVector<SensorSample>& samples)
+{
+    connectionManager->notifyDataReceived();
+    processedEvents.resize(0);
+    const qint64 processStartNs = monotonicNs();
+    {
+        TRACE_SPAN("SignalProcessor::processBatch");
+        signalProcessor.processBatch(samples.constData(), samples.size());
+    }
+    pipelineStats[PipelineStats::Process].record(monotonicNs() - processStartNs);
+    for (const PipelineEvent& event : std::as_const(processedEvents))
+        publish(event);
+    if (journal)
+        journal->append(processedEvents.constData(), processedEvents.size());
+    // Отметка ожидания ставится, только если GUI уже забрал всё предыдущее
+    qint64 none = 0;
+    if (!processedEvents.isEmpty())
+        oldestPendingNs.compare_exchange_strong(none, dataReceiver->chunkReceivedNs(), std::memory_order_release);
+}
+
+void IngestWorker::onDecodeStatsChanged()
+{
+    const SampleStreamDecoder& decoder = dataReceiver->decoder();
+    decodedSamples.store(decoder.samplesDecoded(), std::memory_order_relaxed);
+    decodeErrorCount.store(decoder.errorCount(), std::memory_order_relaxed);
+    detectedProtocol.store(static_cast<int>(decoder.protocol()), std::memory_order_relaxed);
+    reportDecodeErrors();
+}
+
+void IngestWorker::reportDecodeErrors()
+{
+    // Ошибки разбора — одной строкой за интервал, с числом новых с прошлого сообщения
+    const quint64 errors = decodeErrorCount.load(std::memory_order_relaxed);
+    if (errors == reportedDecodeErrors)
+        return;
+    if (!decodeErrorLog.allow()) {
+        // Подавленные ошибки не теряются, даже если после всплеска данных больше нет
+        if (!decodeErrorFlush->isActive())
+            decodeErrorFlush->start();
+        return;
+    }
+    qCWarning(lcParse) << host << ":" << errors - reportedDecodeErrors << "malformed lines/frames, total" << errors;
+    reportedDecodeErrors = errors;
+}
+
+void IngestWorker::publish(const PipelineEvent& event) {
+    // GUI не успевает забирать данные — не ждём, а считаем потерянные события
+    if (!eventRing.tryPush(event))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,112 @@
+#ifndef INGESTWORKER_H
+#define INGESTWORKER_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+#include "asyncLogger.h"
+#include "connectionManager.h"
+#include "dataReceiver.h"
+#include "pipelineStats.h"
+#include "pipelineEvent.h"
+#include "sampleStreamDecoder.h"
+#include "signalProcessor.h"
+#include "spscRingBuffer.h"
+#include "streamRecording.h"
+
+class ReplaySource;
+class SessionJournal;
+
+// Приём и обработка данных в отдельном потоке: владеет сокетом, декодером и состоянием DSP.
+// Результаты публикуются в кольцевой буфер без блокировок, который GUI опрашивает по своему таймеру.
+class IngestWorker : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int eventRingCapacity = 1 << 15;
+
+    IngestWorker(const QString& host, quint16 port,
+                 const ConnectionManager::Settings& connectionSettings = ConnectionManager::Settings(),
+                 QObject* parent = nullptr);
+
+    // Настраиваются до start(): запись сырого потока в файл и/или воспроизведение записи вместо сокета
+    void setRecordFile(const QString& path) { recordFile = path; }
+    void setReplay(const QString& path, double speed) { replayFile = path; replaySpeed = speed; }
+    bool isReplay() const { return !replayFile.isEmpty(); }
+    // Непрерывная запись результатов обработки на диск; журналом владеет DeviceSession
+    void setJournal(SessionJournal* sessionJournal) { journal = sessionJournal; }
+
+    // Читатель — только поток GUI
+    SpscRingBuffer<PipelineEvent>& events() { return eventRing; }
+
+    // Состояние соединения и счётчики доступны из любого потока
+    const ConnectionManager* connection() const { return connectionManager; }
+    bool isConnected() const { return connectionManager->state() == ConnectionManager::State::Connected; }
+    quint64 droppedEvents() const { return dropped.load(std::memory_order_relaxed); }
+    quint64 samplesDecoded() const { return decodedSamples.load(std::memory_order_relaxed); }
+    quint64 decodeErrors() const { return decodeErrorCount.load(std::memory_order_relaxed); }
+    SampleStreamDecoder::Protocol protocol() const
+    {
+        return static_cast<SampleStreamDecoder::Protocol>(detectedProtocol.load(std::memory_order_relaxed));
+    }
+
+    // Задержки по стадиям; Queue, Render и EndToEnd заполняет DeviceSession в потоке GUI
+    PipelineStats& stats() { return pipelineStats; }
+    const PipelineStats& stats() const { return pipelineStats; }
+    // Время чтения самого старого блока, события которого ещё не забраны (0 — таких нет);
+    // вызывает читатель кольцевого буфера после забора
+    qint64 takeOldestPendingNs() { return oldestPendingNs.exchange(0, std::memory_order_acq_rel); }
+
+public slots:
+    //! Создание сокета и подключение либо запуск воспроизведения (вызывается уже в потоке обработки)
+    void start();
+
+    //! Смена адреса ESP32 с переподключением
+    void setHost(const QString& newHost);
+
+    //! Окно постоянной составляющей для SpO₂ (AC/DC), мс
+    void setSpo2WindowMs(int windowMs);
+    void setPeakFilter(const BandPassFilter::Settings& settings);
+    void setSpectralHeartRate(const SpectralHeartRate::Settings& settings);
+
+private slots:
+    void onBatchReceived(const QVector<SensorSample>& samples);
+    void onDecodeStatsChanged();
+    void reportDecodeErrors();
+
+private:
+    void publish(const PipelineEvent& event);
+
+    QString host;
+    quint16 port;
+
+    QTcpSocket* socket = nullptr;
+    DataReceiver* dataReceiver = nullptr;
+    ConnectionManager* connectionManager; // дочерний объект, создаётся в конструкторе
+
+    QString recordFile;
+    StreamRecorder recorder;
+    QString replayFile;
+    double replaySpeed = 1.0;
+    ReplaySource* replaySource = nullptr;
+    SessionJournal* journal = nullptr;
+
+    SignalProcessor signalProcessor;
+    QVector<PipelineEvent> processedEvents; // переиспользуется для каждого блока
+    PipelineEventCollector eventCollector { processedEvents };
+
+    SpscRingBuffer<PipelineEvent> eventRing;
+    std::atomic<quint64> dropped { 0 };
+    std::atomic<quint64> decodedSamples { 0 };
+    std::atomic<quint64> decodeErrorCount { 0 };
+    quint64 reportedDecodeErrors = 0;
+    PipelineStats pipelineStats;
+    std::atomic<qint64> oldestPendingNs { 0 };
+    LogRateLimiter decodeErrorLog; // испорченный поток даёт ошибку на каждую строку
+    QTimer* decodeErrorFlush = nullptr; // дописывает подавленные ограничителем ошибки последнего всплеска
+    std::atomic<int> detectedProtocol { 0 };
+};
+
+#endif // INGESTWORKER_H
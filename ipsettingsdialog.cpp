@@ -26,6 +26,11 @@ QString IpSettingsDialog::getIpAddress() const
     return ui->lineEditIp->text();
 }
 
+void IpSettingsDialog::setIpAddress(const QString &ip)
+{
+    ui->lineEditIp->setText(ip);
+}
+
 void IpSettingsDialog::on_saveButton_clicked()
 {
     QString ip = ui->lineEditIp->text();
@@ -16,6 +16,7 @@ public:
     ~IpSettingsDialog();
 
     QString getIpAddress() const;
+    void setIpAddress(const QString &ip);
 
 private slots:
     void on_saveButton_clicked();
@@ -1,11 +1,29 @@
 #include "mainwindow.h"
+#include "asyncLogger.h"
+#include "traceSpans.h"
 
 #include <QApplication>
+#include <QSettings>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    MainWindow w;
-    w.show();
-    return a.exec();
+
+    // Вывод сообщений — в отдельном потоке; правила категорий и файл журнала из настроек
+    {
+        QSettings settings("MyCompany", "MyApp");
+        AsyncLogger::install(settings.value("logFile").toString());
+        AsyncLogger::setFilterRules(settings.value("logRules").toString());
+        // Запись интервалов включена заранее — чтобы редкую задержку можно было выгрузить после случая
+        Trace::setEnabled(settings.value("traceSpans", false).toBool());
+    }
+
+    int result;
+    {
+        MainWindow w;
+        w.show();
+        result = a.exec();
+    }
+    AsyncLogger::shutdown();
+    return result;
 }
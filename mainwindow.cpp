@@ -2,13 +2,21 @@
 #include "ui_mainwindow.h"
 
 #include <QGridLayout>
+#include <QInputDialog>
 #include <QPushButton>
+#include <QStackedWidget>
 #include <QTimer>
 #include <QSettings>
 #include <QDateTime>
-#include <QDebug>
+#include <QStatusBar>
+#include <QThreadPool>
+#include <memory>
+#include "asyncLogger.h"
 #include "ipsettingsdialog.h"
+#include "pipelineStatsPanel.h"
 #include "exportdatatofiles.h"
+#include "sessionDashboard.h"
+#include "sessionView.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -19,356 +27,241 @@ MainWindow::MainWindow(QWidget *parent)
     font.setPointSize(14);
 
     QApplication::setFont(font);  // Это изменит шрифт для всех виджетов приложения
-    // Создаем серии для динамических порогов
-    thresholdSeriesIR = new QLineSeries(this);
-    thresholdSeriesIR->setName("Dynamic Threshold");
-    thresholdSeriesRED = new QLineSeries(this);
-    thresholdSeriesRED->setName("Dynamic Threshold");
 
-    // Метка для среднего BPM за 1 минуту
-    averageMinuteBpmLabel = new QLabel("Avg BPM (1 min): --", this);
+    // Сессии устройств: приём данных из сокетов и обработка сигнала — в пуле потоков
+    sessionManager = new SessionManager(this);
 
-    // Серия для SpO₂
-    QLineSeries *bloodOxygenSaturationSeries = new QLineSeries();
-    bloodOxygenSaturationSeries->setName("SpO₂ AC/DC");
-    QLineSeries *bloodOxygenSaturationPeakSeries = new QLineSeries();
-    bloodOxygenSaturationPeakSeries->setName("SpO₂ Peaks");
+    // Страница 0 — сводка по устройствам, далее — графики каждого устройства
+    pages = new QStackedWidget(this);
+    dashboard = new SessionDashboard(sessionManager, this);
+    pages->addWidget(dashboard);
+    connect(dashboard, &SessionDashboard::sessionActivated, this, &MainWindow::showSession);
+    connect(dashboard, &SessionDashboard::addDeviceRequested, this, &MainWindow::onAddDeviceRequested);
+    connect(sessionManager, &SessionManager::sessionAdded, this, &MainWindow::onSessionAdded);
 
-    // Создаем оси для графиков (отображение в секундах)
-    QValueAxis *axisIrX   = new QValueAxis();
-    QValueAxis *axisBpmX  = new QValueAxis();
-    QValueAxis *axisAvgX  = new QValueAxis();
-    QValueAxis *axisTempX = new QValueAxis();
-    QValueAxis *axisRedX  = new QValueAxis();
-    QValueAxis *axisSpo2X = new QValueAxis();
+    // Кнопки экспорта и настройки IP (относятся к открытому устройству)
+    dashboardButton = new QPushButton("All devices", this);
+    connect(dashboardButton, &QPushButton::clicked,
+            this, &MainWindow::showDashboard);
 
-    // Инициализация DataProcessor – внутри он работает с миллисекундами,
-    // а для графиков конвертирует время в секунды
-    dataProcessor = new DataProcessor(
-        new QLineSeries(), // BPM series
-        new QLineSeries(), // Avg BPM series
-        new QLineSeries(), // IR series
-        new QLineSeries(), // Temperature series
-        bloodOxygenSaturationSeries, // SpO₂ series
-        bloodOxygenSaturationPeakSeries, // SpO₂ by peaks
-        axisIrX, axisBpmX, axisAvgX, axisTempX, axisRedX, axisSpo2X,
-        averageMinuteBpmLabel
-        );
-
-    dataCheckTimer = new QTimer(this);
-    dataCheckTimer->setInterval(10000); // Проверка каждые 10 с
-    connect(dataCheckTimer, &QTimer::timeout,
-            this, &MainWindow::checkDataTimeout);
-    lastDataTime = QDateTime::currentDateTime();
-    dataCheckTimer->start();
-
-    // Создаем QTcpSocket и подключаемся к ESP32
-    socket = new QTcpSocket(this);
-    socket->setReadBufferSize(0);
-    connect(socket, &QTcpSocket::disconnected, this, &MainWindow::onSocketDisconnected);
-    connect(socket, &QTcpSocket::errorOccurred, this, &MainWindow::onSocketError);
-
-    // Инициализируем графики
-    redChartView         = new QChartView(this);
-    infraredChartView    = new QChartView(this);
-    beatsPerMinuteChartView = new QChartView(this);
-    averageBpmChartView  = new QChartView(this);
-    temperatureChartView = new QChartView(this);
-    spo2ChartView        = new QChartView(this);
-
-    {
-        QChart *redChart = new QChart();
-        redChart->legend()->setVisible(false);
-        redChart->setTitle("Red Data");
-        QValueAxis* axisRedXPtr = dataProcessor->getRedAxisX();
-        axisRedXPtr->setTitleText("Time (s)");
-        axisRedXPtr->setRange(0, 300);
-        redChart->addAxis(axisRedXPtr, Qt::AlignBottom);
-
-        redAxisY = new QValueAxis();
-        redAxisY->setTitleText("Red Value");
-        redAxisY->setRange(20000, 30000);
-        redChart->addAxis(redAxisY, Qt::AlignLeft);
-
-        redChart->addSeries(dataProcessor->getRedSeries());
-        dataProcessor->getRedSeries()->attachAxis(axisRedXPtr);
-        dataProcessor->getRedSeries()->attachAxis(redAxisY);
-
-        redChart->addSeries(thresholdSeriesRED);
-        thresholdSeriesRED->attachAxis(axisRedXPtr);
-        thresholdSeriesRED->attachAxis(redAxisY);
-
-        redChartView->setChart(redChart);
-    }
-
-    {
-        QChart *irChart = new QChart();
-        irChart->legend()->setVisible(false);
-        irChart->setTitle("Infrared (IR) Data");
-        QValueAxis *axisIrXPtr = dataProcessor->getIrAxisX();
-        axisIrXPtr->setTitleText("Time (s)");
-        axisIrXPtr->setRange(0, 300);
-        irChart->addAxis(axisIrXPtr, Qt::AlignBottom);
-
-        infraredAxisY = new QValueAxis();
-        infraredAxisY->setTitleText("IR Value");
-        infraredAxisY->setRange(95000, 110000);
-        irChart->addAxis(infraredAxisY, Qt::AlignLeft);
-
-        // Основная серия IR
-        irChart->addSeries(dataProcessor->getIRSeries());
-        dataProcessor->getIRSeries()->attachAxis(axisIrXPtr);
-        dataProcessor->getIRSeries()->attachAxis(infraredAxisY);
-
-        // Пороговая серия (если используется)
-        irChart->addSeries(thresholdSeriesIR);
-        thresholdSeriesIR->attachAxis(axisIrXPtr);
-        thresholdSeriesIR->attachAxis(infraredAxisY);
-
-        // Добавляем серию пиков (красные точки)
-        irChart->addSeries(dataProcessor->getPeakSeries());
-        dataProcessor->getPeakSeries()->attachAxis(axisIrXPtr);
-        dataProcessor->getPeakSeries()->attachAxis(infraredAxisY);
-
-        infraredChartView->setChart(irChart);
-    }
-
-
-    {
-        QChart *bpmChart = new QChart();
-        bpmChart->legend()->setVisible(false);
-        bpmChart->setTitle("Beats Per Minute");
-        QValueAxis *axisBpmXPtr = dataProcessor->getBpmAxisX();
-        axisBpmXPtr->setTitleText("Time (s)");
-        axisBpmXPtr->setRange(0, 300);
-        bpmChart->addAxis(axisBpmXPtr, Qt::AlignBottom);
-
-        QValueAxis *bpmAxisY = new QValueAxis();
-        bpmAxisY->setTitleText("BPM Value");
-        bpmAxisY->setRange(50, 140);
-        bpmChart->addAxis(bpmAxisY, Qt::AlignLeft);
-
-        bpmChart->addSeries(dataProcessor->getBPMSeries());
-        dataProcessor->getBPMSeries()->attachAxis(axisBpmXPtr);
-        dataProcessor->getBPMSeries()->attachAxis(bpmAxisY);
-
-        beatsPerMinuteChartView->setChart(bpmChart);
-    }
-
-    {
-        QChart *avgBpmChart = new QChart();
-        avgBpmChart->legend()->setVisible(false);
-        avgBpmChart->setTitle("Average BPM");
-        QValueAxis *axisAvgBpmXPtr = dataProcessor->getAvgBpmAxisX();
-        axisAvgBpmXPtr->setTitleText("Time (s)");
-        axisAvgBpmXPtr->setRange(0, 300);
-        avgBpmChart->addAxis(axisAvgBpmXPtr, Qt::AlignBottom);
-
-        QValueAxis *avgBpmAxisY = new QValueAxis();
-        avgBpmAxisY->setTitleText("Avg BPM");
-        avgBpmAxisY->setRange(50, 140);
-        avgBpmChart->addAxis(avgBpmAxisY, Qt::AlignLeft);
-
-        avgBpmChart->addSeries(dataProcessor->getAvgBPMSeries());
-        dataProcessor->getAvgBPMSeries()->attachAxis(axisAvgBpmXPtr);
-        dataProcessor->getAvgBPMSeries()->attachAxis(avgBpmAxisY);
-
-        averageBpmChartView->setChart(avgBpmChart);
-    }
-
-    {
-        QChart *tempChart = new QChart();
-        tempChart->legend()->setVisible(false);
-        tempChart->setTitle("Temperature Data");
-        QValueAxis *axisTempXPtr = dataProcessor->getTempAxisX();
-        axisTempXPtr->setTitleText("Time (s)");
-        axisTempXPtr->setRange(0, 300);
-        tempChart->addAxis(axisTempXPtr, Qt::AlignBottom);
-
-        QValueAxis *tempAxisY = new QValueAxis();
-        tempAxisY->setTitleText("Temp. (°C)");
-        tempAxisY->setRange(25, 38);
-        tempChart->addAxis(tempAxisY, Qt::AlignLeft);
-
-        tempChart->addSeries(dataProcessor->getTempSeries());
-        dataProcessor->getTempSeries()->attachAxis(axisTempXPtr);
-        dataProcessor->getTempSeries()->attachAxis(tempAxisY);
-
-        temperatureChartView->setChart(tempChart);
-    }
-
-    {
-        QChart *spo2Chart = new QChart();
-        spo2Chart->legend()->setVisible(false);
-        spo2Chart->setTitle("SpO₂ Data");
-        QValueAxis *axisSpo2XPtr = dataProcessor->getSpo2AxisX();
-        axisSpo2XPtr->setTitleText("Time (s)");
-        axisSpo2XPtr->setRange(0, 300);
-        spo2Chart->addAxis(axisSpo2XPtr, Qt::AlignBottom);
-
-        QValueAxis *spo2AxisY = new QValueAxis();
-        spo2AxisY->setTitleText("SpO₂ (%)");
-        spo2AxisY->setRange(90, 105);
-        spo2Chart->addAxis(spo2AxisY, Qt::AlignLeft);
-
-        spo2Chart->addSeries(dataProcessor->getSpo2Series());
-        spo2Chart->addSeries(dataProcessor->getSpo2PeakSeries());
-        dataProcessor->getSpo2Series()->setColor(Qt::blue);
-        dataProcessor->getSpo2PeakSeries()->setColor(Qt::darkGreen);
-        dataProcessor->getSpo2Series()->attachAxis(axisSpo2XPtr);
-        dataProcessor->getSpo2Series()->attachAxis(spo2AxisY);
-        dataProcessor->getSpo2PeakSeries()->attachAxis(axisSpo2XPtr);
-        dataProcessor->getSpo2PeakSeries()->attachAxis(spo2AxisY);
-
-        spo2ChartView->setChart(spo2Chart);
-    }
-
-    // Кнопки экспорта и настройки IP
-    QPushButton *exportDataTextButton = new QPushButton("Export Data (Text)", this);
+    exportDataTextButton = new QPushButton("Export Data (Text)", this);
     connect(exportDataTextButton, &QPushButton::clicked,
             this, &MainWindow::onExportDataText);
 
-    QPushButton *exportDataBinButton = new QPushButton("Export Data (Binary)", this);
+    exportDataBinButton = new QPushButton("Export Data (Binary)", this);
     connect(exportDataBinButton, &QPushButton::clicked,
             this, &MainWindow::onExportDataBinary);
 
-    QPushButton *ipSettingsButton = new QPushButton("Настройка IP", this);
+    ipSettingsButton = new QPushButton("Настройка IP", this);
     connect(ipSettingsButton, &QPushButton::clicked,
             this, &MainWindow::onIpSettingsClicked);
 
+    // Самописцы вместо Qt Charts — для высоких частот отсчётов и многих устройств
+    stripChartsButton = new QPushButton("Fast charts", this);
+    stripChartsButton->setCheckable(true);
+    connect(stripChartsButton, &QPushButton::toggled, this, [this](bool checked) {
+        sessionManager->setStripCharts(checked);
+        sessionManager->saveToSettings();
+    });
+
+    // Трассировка каждого отсчёта и пика (esp32.sample, esp32.beat) — только на время отладки
+    traceButton = new QPushButton("Trace samples", this);
+    traceButton->setCheckable(true);
+    traceButton->setChecked(AsyncLogger::sampleTracing());
+    connect(traceButton, &QPushButton::toggled, this, [](bool checked) {
+        AsyncLogger::setSampleTracing(checked);
+    });
+
+    // Задержки стадий конвейера по всем устройствам; скрытая панель не обновляется
+    statsPanel = new PipelineStatsPanel(sessionManager, this);
+    statsPanel->hide();
+    statsButton = new QPushButton("Pipeline stats", this);
+    statsButton->setCheckable(true);
+    connect(statsButton, &QPushButton::toggled, statsPanel, &QWidget::setVisible);
+
     QGridLayout *layout = new QGridLayout();
-    layout->addWidget(redChartView,            0, 0);
-    layout->addWidget(infraredChartView,       0, 1);
-    layout->addWidget(beatsPerMinuteChartView, 1, 0);
-    layout->addWidget(averageBpmChartView,     1, 1);
-    layout->addWidget(temperatureChartView,    2, 0);
-    layout->addWidget(spo2ChartView,           2, 1);
-    layout->addWidget(exportDataTextButton,    4, 0, 1, 2);
-    layout->addWidget(exportDataBinButton,     5, 0, 1, 2);
-    layout->addWidget(ipSettingsButton,        6, 0, 1, 2);
+    layout->addWidget(pages,                0, 0, 1, 2);
+    layout->addWidget(statsPanel,           1, 0, 1, 2);
+    layout->addWidget(dashboardButton,      3, 0, 1, 2);
+    layout->addWidget(exportDataTextButton, 4, 0, 1, 2);
+    layout->addWidget(exportDataBinButton,  5, 0, 1, 2);
+    layout->addWidget(ipSettingsButton,     6, 0, 1, 2);
+    layout->addWidget(stripChartsButton,    7, 0, 1, 2);
+    layout->addWidget(traceButton,          8, 0, 1, 2);
+    layout->addWidget(statsButton,          9, 0, 1, 2);
 
     QWidget *centralW = new QWidget();
     centralW->setLayout(layout);
     setCentralWidget(centralW);
 
-    // Создаем DataReceiver и соединяем его сигнал с нашим слотом
-    dataReceiver = new DataReceiver(socket, this);
-    connect(socket, &QTcpSocket::readyRead, dataReceiver, &DataReceiver::readData);
-    // Обновленный сигнал dataReady теперь передает timestamp (в мс) + 3 значения
-    connect(dataReceiver, &DataReceiver::dataReady,
-            this, &MainWindow::handleReceivedData);
+    sessionManager->loadFromSettings();
+    {
+        const QSignalBlocker blocker(stripChartsButton);
+        stripChartsButton->setChecked(sessionManager->usesStripCharts());
+    }
 
-    connectToEsp32();
+    // С одним устройством сразу показываем его графики, как раньше
+    if (sessionManager->sessionCount() == 1)
+        showSession(0);
+    else
+        showDashboard();
 
-    // Таймер для обновления среднего BPM за минуту
-    QTimer *minuteTimer = new QTimer(this);
-    connect(minuteTimer, &QTimer::timeout,
-            dataProcessor->getMinuteCalculator(), &MinuteAverageCalculator::updateAverage);
-    minuteTimer->start(60000);
-    qDebug() << "Minute-average BPM timer started, interval =" << minuteTimer->interval();
+    QTimer *statusTimer = new QTimer(this);
+    connect(statusTimer, &QTimer::timeout, this, &MainWindow::updateStatusBar);
+    statusTimer->start(1000);
 }
 
 MainWindow::~MainWindow() {
-    delete dataProcessor;
+    // Сессии (и их DataProcessor) удаляются раньше графиков, которые ими заполняются
+    delete sessionManager;
     delete ui;
 }
 
-//------------------------------------------------------------------------------
-// Попытка подключения к ESP32
-//------------------------------------------------------------------------------
-void MainWindow::connectToEsp32() {
-    QSettings settings("MyCompany", "MyApp");
-    currentIpAddress = settings.value("ipAddress", "192.168.31.222").toString();
-    qDebug() << "Attempting to connect to" << currentIpAddress << "on port 80...";
-    socket->abort();
-    socket->connectToHost(currentIpAddress, 80);
-    if (!socket->waitForConnected(5000)) {
-        qDebug() << "Not connected. Will retry in 5s...";
-        QTimer::singleShot(5000, this, &MainWindow::connectToEsp32);
-    } else {
-        qDebug() << "Successfully connected to" << currentIpAddress;
-    }
+DeviceSession *MainWindow::currentSession() const {
+    return sessionManager->session(currentSessionIndex);
+}
+
+void MainWindow::onSessionAdded(DeviceSession *session) {
+    pages->addWidget(session->view());
+    dashboard->refresh();
+}
+
+void MainWindow::showDashboard() {
+    currentSessionIndex = -1;
+    pages->setCurrentWidget(dashboard);
+    dashboardButton->setEnabled(false);
+    exportDataTextButton->setEnabled(false);
+    exportDataBinButton->setEnabled(false);
+    ipSettingsButton->setEnabled(false);
+    setWindowTitle("ESP32 SpO₂ Monitor");
+    updateStatusBar();
+}
+
+void MainWindow::showSession(int index) {
+    DeviceSession *session = sessionManager->session(index);
+    if (!session)
+        return;
+    currentSessionIndex = index;
+    pages->setCurrentWidget(session->view());
+    dashboardButton->setEnabled(true);
+    exportDataTextButton->setEnabled(true);
+    exportDataBinButton->setEnabled(true);
+    ipSettingsButton->setEnabled(true);
+    setWindowTitle("ESP32 SpO₂ Monitor — " + session->config().name);
+    updateStatusBar();
+}
+
+void MainWindow::onAddDeviceRequested() {
+    bool ok = false;
+    const QString host = QInputDialog::getText(this, "Add device", "ESP32 IP address:",
+                                               QLineEdit::Normal, QString(), &ok).trimmed();
+    if (!ok || host.isEmpty())
+        return;
+    DeviceSession::Config config;
+    config.name = QString("ESP32 #%1").arg(sessionManager->sessionCount() + 1);
+    config.host = host;
+    sessionManager->addSession(config);
+    sessionManager->saveToSettings();
 }
 
 //------------------------------------------------------------------------------
-// Настройка IP-адреса
+// Настройка IP-адреса открытого устройства
 //------------------------------------------------------------------------------
 void MainWindow::onIpSettingsClicked() {
+    DeviceSession *session = currentSession();
+    if (!session)
+        return;
     IpSettingsDialog dlg(this);
+    dlg.setIpAddress(session->config().host);
     if (dlg.exec() == QDialog::Accepted) {
         QString newIp = dlg.getIpAddress();
-        qDebug() << "New IP address saved:" << newIp;
-        currentIpAddress = newIp;
-        QSettings settings("MyCompany", "MyApp");
-        settings.setValue("ipAddress", newIp);
-        socket->disconnectFromHost();
-        socket->connectToHost(currentIpAddress, 80);
+        qCInfo(lcSession) << "New IP address saved:" << newIp;
+        session->setHost(newIp);
+        sessionManager->saveToSettings();
+        dashboard->refresh();
     }
 }
 
-//------------------------------------------------------------------------------
-// Приходят новые данные из датчика
-//------------------------------------------------------------------------------
-// Слот теперь принимает timestamp (в мс) от ESP32, а на графиках используется время в секундах
-void MainWindow::handleReceivedData(qint64 timestamp, double infraredValue,
-                                    double redValue, double temperatureValue)
+void MainWindow::updateStatusBar()
 {
-    lastDataTime = QDateTime::currentDateTime();
-    // Передаем данные (timestamp в мс) в DataProcessor
-    dataProcessor->processValues(timestamp, infraredValue, redValue, temperatureValue);
-
-    // Обновляем буферы для автоподстройки осей Y
-    lastInfraredValues.append(infraredValue);
-    if (lastInfraredValues.size() > 10)
-        lastInfraredValues.pop_front();
-    if (lastInfraredValues.size() == 10) {
-        double sumIr = 0.0;
-        for (double v : lastInfraredValues)
-            sumIr += v;
-        double avgIr = sumIr / lastInfraredValues.size();
-        infraredAxisY->setRange(avgIr - 500, avgIr + 500);
+    DeviceSession *session = currentSession();
+    if (!session) {
+        statusBar()->showMessage(QString("Devices: %1, processing threads: %2")
+                                     .arg(sessionManager->sessionCount())
+                                     .arg(sessionManager->threadCount()));
+        return;
     }
-    lastRedValues.append(redValue);
-    if (lastRedValues.size() > 10)
-        lastRedValues.removeFirst();
-    if (lastRedValues.size() == 10) {
-        double sumRed = 0.0;
-        for (double v : lastRedValues)
-            sumRed += v;
-        double avgRed = sumRed / lastRedValues.size();
-        redAxisY->setRange(avgRed - 200, avgRed + 200);
-    }
-
+    const IngestWorker *worker = session->worker();
+    const ConnectionManager *connection = worker->connection();
+    statusBar()->showMessage(QString("%1 (connect %2 ms, reconnects %3, last %4 ms, max %5 ms) | "
+                                     "Protocol: %6, samples: %7, decode errors: %8, dropped events: %9")
+                                 .arg(ConnectionManager::stateName(connection->state()))
+                                 .arg(connection->lastConnectLatencyMs())
+                                 .arg(connection->reconnectCount())
+                                 .arg(connection->lastReconnectLatencyMs())
+                                 .arg(connection->maxReconnectLatencyMs())
+                                 .arg(SampleStreamDecoder::protocolName(worker->protocol()))
+                                 .arg(worker->samplesDecoded())
+                                 .arg(worker->decodeErrors())
+                                 .arg(worker->droppedEvents()));
 }
 
-void MainWindow::checkDataTimeout() {
-    qint64 secsSinceLastData = lastDataTime.secsTo(QDateTime::currentDateTime());
-    if (secsSinceLastData > 10) {
-        qDebug() << "No data from ESP32 for" << secsSinceLastData
-                 << "seconds. Reconnecting...";
-        socket->disconnectFromHost();
-        socket->abort();
-        connectToEsp32();
+QString MainWindow::exportBaseFilename(const DeviceSession *session) const {
+    QString baseFilename = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+    // Несколько устройств — в имя файла добавляем имя устройства
+    if (sessionManager->sessionCount() > 1) {
+        QString name = session->config().name;
+        for (QChar &c : name) {
+            if (!c.isLetterOrNumber())
+                c = '_';
+        }
+        baseFilename += "_" + name;
     }
-}
-
-void MainWindow::onSocketDisconnected() {
-    qDebug() << "Socket disconnected. Reconnect in 5 seconds...";
-    QTimer::singleShot(5000, this, &MainWindow::connectToEsp32);
-}
-
-void MainWindow::onSocketError(QAbstractSocket::SocketError socketError) {
-    qDebug() << "Socket error:" << socketError
-             << "description=" << socket->errorString();
-    QTimer::singleShot(3000, this, &MainWindow::connectToEsp32);
+    return baseFilename;
 }
 
 void MainWindow::onExportDataText() {
-    QString baseFilename = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
-    ExportDataToFiles::exportAllDataToText(dataProcessor, baseFilename);
+    DeviceSession *session = currentSession();
+    if (!session)
+        return;
+    QString baseFilename = exportBaseFilename(session);
+    const DataProcessor *processor = session->processor();
+    // При непрерывной записи всё уже на диске: файлы строятся из сегментов журнала вне окна
+    if (SessionJournal *journal = session->journal()) {
+        exportFromJournal(journal, baseFilename, processor->getBpmStatistics().minuteRecords(), false);
+        return;
+    }
+    ExportDataToFiles::exportAllDataToText(processor->history(),
+                                           processor->getBpmStatistics().minuteRecords(),
+                                           baseFilename);
 }
 
 void MainWindow::onExportDataBinary() {
-    QString baseFilename = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
-    ExportDataToFiles::exportAllDataToBinary(dataProcessor, baseFilename);
+    DeviceSession *session = currentSession();
+    if (!session)
+        return;
+    QString baseFilename = exportBaseFilename(session);
+    if (SessionJournal *journal = session->journal()) {
+        exportFromJournal(journal, baseFilename, {}, true);
+        return;
+    }
+    ExportDataToFiles::exportAllDataToBinary(session->processor()->history(), baseFilename);
+}
+
+void MainWindow::exportFromJournal(SessionJournal *journal, const QString &baseFilename,
+                                   const QVector<MinuteBPMData> &minuteRecords, bool binary) {
+    // История в окне продолжает пополняться, поэтому файлы строятся из закрытых сегментов:
+    // окно не ждёт ни fsync, ни чтения многочасовой сессии
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    *connection = connect(journal, &SessionJournal::segmentsFinalized, this,
+                          [connection, baseFilename, minuteRecords, binary](const QStringList &segments) {
+        QObject::disconnect(*connection);
+        QThreadPool::globalInstance()->start([segments, baseFilename, minuteRecords, binary]() {
+            if (binary)
+                ExportDataToFiles::exportJournalToBinary(segments, baseFilename);
+            else
+                ExportDataToFiles::exportJournalToText(segments, minuteRecords, baseFilename);
+        });
+    });
+    journal->finalizeSegmentsAsync();
 }
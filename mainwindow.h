@@ -2,17 +2,18 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QTcpSocket>
-#include <QtCharts/QChartView>
-#include <QLabel>
-#include "dataProcessor.h"
-#include "dataReceiver.h"
 #include "exportdatatofiles.h"
+#include "sessionManager.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
+class QPushButton;
+class QStackedWidget;
+class PipelineStatsPanel;
+class SessionDashboard;
+
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
@@ -21,69 +22,46 @@ public:
     ~MainWindow();
 
 private slots:
-    //! Подключение к ESP
-    void connectToEsp32();
-
     //! Диалог настройки IP-адреса
     void onIpSettingsClicked();
 
-    //! Обработка новых данных от датчика (timestamp в мс от ESP32)
-    void handleReceivedData(qint64 timestamp, double infraredValue, double redValue, double temperatureValue);
-
     //! Экспорт данных в текстовые файлы
     void onExportDataText();
 
     //! Экспорт данных в бинарные файлы
     void onExportDataBinary();
-    void checkDataTimeout();
-    void onSocketDisconnected();
-    void onSocketError(QAbstractSocket::SocketError socketError);
-
-private:
-    Ui::MainWindow *ui;
-    QTcpSocket *socket;
-    QString currentIpAddress;
-
-    // Виджеты-графики
-    QChartView *redChartView;
-    QChartView *infraredChartView;
-    QChartView *beatsPerMinuteChartView;
-    QChartView *averageBpmChartView;
-    QChartView *temperatureChartView;
-    QChartView *spo2ChartView;
+    void updateStatusBar();
 
-    // Оси X (для графиков, отображаем время в секундах)
-    QValueAxis *infraredAxisX;
-    QValueAxis *beatsPerMinuteAxisX;
-    QValueAxis *averageBpmAxisX;
-    QValueAxis *temperatureAxisX;
-    QValueAxis *spo2AxisX;
+    //! Переключение между сводкой устройств и графиками одного устройства
+    void showDashboard();
+    void showSession(int index);
+    void onSessionAdded(DeviceSession *session);
+    void onAddDeviceRequested();
 
-    // Оси Y
-    QValueAxis *infraredAxisY;
-    QValueAxis *redAxisY;
-
-    // Буферы для автоподстройки осей Y
-    QVector<double> lastInfraredValues;
-    QVector<double> lastRedValues;
-
-    //! Линия динамического порога
-    QLineSeries *thresholdSeriesIR;
-    QLineSeries *thresholdSeriesRED;
-
-    //! Метка для среднего BPM за 1 мин.
-    QLabel *averageMinuteBpmLabel;
-
-    //! Основная логика обработки
-    DataProcessor *dataProcessor;
+private:
+    DeviceSession *currentSession() const;
+    QString exportBaseFilename(const DeviceSession *session) const;
+    //! Экспорт при непрерывной записи: сегменты закрывает поток журнала, файлы пишутся в пуле потоков
+    void exportFromJournal(SessionJournal *journal, const QString &baseFilename,
+                           const QVector<MinuteBPMData> &minuteRecords, bool binary);
 
-    //! Приём данных из сокета
-    DataReceiver *dataReceiver;
-    QDateTime lastDataTime;
-    QTimer *dataCheckTimer;
+    Ui::MainWindow *ui;
 
-    void setupCharts();
-    void setupUiElements();
+    //! Сессии устройств (приём и обработка в пуле потоков)
+    SessionManager *sessionManager;
+
+    QStackedWidget *pages;
+    SessionDashboard *dashboard;
+    PipelineStatsPanel *statsPanel;
+    int currentSessionIndex = -1;
+
+    QPushButton *dashboardButton;
+    QPushButton *exportDataTextButton;
+    QPushButton *exportDataBinButton;
+    QPushButton *ipSettingsButton;
+    QPushButton *stripChartsButton;
+    QPushButton *traceButton;
+    QPushButton *statsButton;
 };
 
 #endif // MAINWINDOW_H
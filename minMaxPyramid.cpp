@@ -0,0 +1,225 @@
+#include "minMaxPyramid.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+void merge(MinMaxPyramid::Bucket& into, const MinMaxPyramid::Bucket& from)
+{
+    into.lastTimestamp = from.lastTimestamp;
+    for (int c = 0; c < MinMaxPyramid::ChannelCount; ++c) {
+        into.minimum[c] = std::min(into.minimum[c], from.minimum[c]);
+        into.maximum[c] = std::max(into.maximum[c], from.maximum[c]);
+    }
+}
+
+double channelValue(const SampleStore::Row& row, MinMaxPyramid::Channel channel)
+{
+    switch (channel) {
+    case MinMaxPyramid::Ir:
+        return row.ir;
+    case MinMaxPyramid::Red:
+        return row.red;
+    default:
+        return row.temp;
+    }
+}
+
+// Минимум и максимум по столбцам экрана
+class ColumnAccumulator
+{
+public:
+    ColumnAccumulator(qint64 fromMs, qint64 toMs, int columns)
+        : fromMs(fromMs), spanMs(toMs - fromMs), columns(columns),
+        low(columns, std::numeric_limits<float>::max()),
+        high(columns, std::numeric_limits<float>::lowest())
+    {
+    }
+
+    void add(qint64 timestamp, float minimum, float maximum)
+    {
+        const int column = int(qBound<qint64>(0, (timestamp - fromMs) * columns / spanMs, columns - 1));
+        low[column] = std::min(low[column], minimum);
+        high[column] = std::max(high[column], maximum);
+    }
+
+    void write(qint64 originMs, QVector<QPointF>& out) const
+    {
+        for (int column = 0; column < columns; ++column) {
+            if (low[column] > high[column])
+                continue;
+            const double x = (fromMs - originMs + (column + 0.5) * spanMs / columns) / 1000.0;
+            out.append(QPointF(x, low[column]));
+            out.append(QPointF(x, high[column]));
+        }
+    }
+
+private:
+    qint64 fromMs;
+    qint64 spanMs;
+    int columns;
+    QVector<float> low;
+    QVector<float> high;
+};
+
+} // namespace
+
+void MinMaxPyramid::append(qint64 timestamp, double ir, double red, double temp)
+{
+    Bucket bucket = { timestamp, timestamp, { float(ir), float(red), float(temp) }, { float(ir), float(red), float(temp) } };
+    for (int level = 0; level < levelCount; ++level) {
+        if (pendingCount[level] == 0)
+            pending[level] = bucket;
+        else
+            merge(pending[level], bucket);
+        if (++pendingCount[level] < fanOut)
+            return;
+        // Корзина уровня готова и становится очередным элементом следующего уровня
+        levels[level].push_back(pending[level]);
+        bucket = pending[level];
+        pendingCount[level] = 0;
+    }
+}
+
+void MinMaxPyramid::clear()
+{
+    for (int level = 0; level < levelCount; ++level) {
+        levels[level].clear();
+        pendingCount[level] = 0;
+    }
+}
+
+qint64 MinMaxPyramid::factor(int level)
+{
+    qint64 result = fanOut;
+    for (int i = 0; i < level; ++i)
+        result *= fanOut;
+    return result;
+}
+
+qint64 MinMaxPyramid::levelSize(int level) const
+{
+    // Хвост уровня — незавершённые корзины этого и всех более мелких уровней: они не пересекаются
+    // и вместе покрывают отсчёты после последней готовой корзины
+    qint64 size = qint64(levels[level].size());
+    for (int l = level; l >= 0; --l)
+        size += pendingCount[l] > 0 ? 1 : 0;
+    return size;
+}
+
+const MinMaxPyramid::Bucket& MinMaxPyramid::bucket(int level, qint64 index) const
+{
+    const qint64 complete = qint64(levels[level].size());
+    if (index < complete)
+        return levels[level][index];
+    qint64 tail = index - complete;
+    for (int l = level; l > 0; --l) {
+        if (pendingCount[l] > 0 && tail-- == 0)
+            return pending[l];
+    }
+    return pending[0];
+}
+
+qint64 MinMaxPyramid::firstBucketEndingAfter(int level, qint64 timestamp) const
+{
+    qint64 low = 0;
+    qint64 high = levelSize(level);
+    while (low < high) {
+        const qint64 mid = (low + high) / 2;
+        if (bucket(level, mid).lastTimestamp < timestamp)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+void MinMaxPyramid::envelope(const SampleStore& raw, Channel channel, qint64 fromMs, qint64 toMs, int columns,
+                             qint64 originMs, QVector<QPointF>& out) const
+{
+    out.resize(0);
+    if (toMs <= fromMs || columns <= 0)
+        return;
+
+    // Самый грубый уровень, на котором в интервал попадает не меньше columns корзин
+    for (int level = levelCount - 1; level >= 0; --level) {
+        const qint64 first = firstBucketEndingAfter(level, fromMs);
+        const qint64 end = firstBucketEndingAfter(level, toMs + 1);
+        if (end - first < columns)
+            continue;
+        ColumnAccumulator accumulator(fromMs, toMs, columns);
+        for (qint64 i = first; i < qMin(end + 1, levelSize(level)); ++i) {
+            const Bucket& b = bucket(level, i);
+            if (b.firstTimestamp > toMs)
+                break;
+            accumulator.add((b.firstTimestamp + b.lastTimestamp) / 2, b.minimum[channel], b.maximum[channel]);
+        }
+        accumulator.write(originMs, out);
+        return;
+    }
+
+    // Даже корзин по 16 отсчётов меньше, чем столбцов: отсчётов не больше 16·columns
+    const qint64 begin = raw.lowerBound(fromMs);
+    const qint64 end = raw.lowerBound(toMs + 1);
+    if (end - begin <= 2 * qint64(columns)) {
+        out.reserve(int(end - begin));
+        raw.forEach(begin, end, [&](const SampleStore::Row& row) {
+            out.append(QPointF((row.time - originMs) / 1000.0, channelValue(row, channel)));
+        });
+        return;
+    }
+    ColumnAccumulator accumulator(fromMs, toMs, columns);
+    raw.forEach(begin, end, [&](const SampleStore::Row& row) {
+        const float value = float(channelValue(row, channel));
+        accumulator.add(row.time, value, value);
+    });
+    accumulator.write(originMs, out);
+}
+
+quint64 MinMaxPyramid::memoryBytes() const
+{
+    quint64 bytes = sizeof(*this);
+    for (int level = 0; level < levelCount; ++level)
+        bytes += quint64(levels[level].size()) * sizeof(Bucket);
+    return bytes;
+}
+
+void decimatePoints(const QVector<QPointF>& points, double fromX, double toX, int columns, QVector<QPointF>& out)
+{
+    out.resize(0);
+    if (toX <= fromX || columns <= 0)
+        return;
+    const auto byX = [](const QPointF& p, double x) { return p.x() < x; };
+    const auto begin = std::lower_bound(points.begin(), points.end(), fromX, byX);
+    const auto end = std::lower_bound(begin, points.end(), toX, byX);
+    if (end - begin <= 2 * columns) {
+        for (auto it = begin; it != end; ++it)
+            out.append(*it);
+        return;
+    }
+
+    // Те же столбцы, что и у огибающей; время в мс только для расчёта номера столбца
+    ColumnAccumulator accumulator(qint64(fromX * 1000.0), qint64(toX * 1000.0), columns);
+    for (auto it = begin; it != end; ++it)
+        accumulator.add(qint64(it->x() * 1000.0), float(it->y()), float(it->y()));
+    accumulator.write(0, out);
+}
+
+void decimatePoints(const SeriesStore& points, double fromX, double toX, int columns, QVector<QPointF>& out)
+{
+    out.resize(0);
+    if (toX <= fromX || columns <= 0)
+        return;
+    const qint64 begin = points.lowerBound(fromX);
+    const qint64 end = points.lowerBound(toX);
+    if (end - begin <= 2 * qint64(columns)) {
+        points.forEach(begin, end, [&out](const QPointF& p) { out.append(p); });
+        return;
+    }
+    ColumnAccumulator accumulator(qint64(fromX * 1000.0), qint64(toX * 1000.0), columns);
+    points.forEach(begin, end, [&accumulator](const QPointF& p) {
+        accumulator.add(qint64(p.x() * 1000.0), float(p.y()), float(p.y()));
+    });
+    accumulator.write(0, out);
+}
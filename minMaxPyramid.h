@@ -0,0 +1,61 @@
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <QPointF>
+#include <QVector>
+#include <deque>
+#include "sampleStore.h"
+
+// Пирамида минимумов/максимумов по истории отсчётов IR, Red и Temp для просмотра всей сессии.
+// Время корзин — время сессии (SampleStore::Row::time): оно не убывает и после перезапуска ESP32.
+// Уровень L хранит корзины по 16^(L+1) отсчётов (16×, 256×, 4096×); нижний уровень 1× — сами
+// отсчёты в SampleStore. Корзина уровня L+1 собирается из 16 корзин уровня L, поэтому добавление
+// отсчёта стоит амортизированно O(1), а любой интервал времени рисуется чтением O(столбцов) корзин.
+// Незавершённые корзины участвуют в запросах наравне с готовыми — последние секунды тоже видны.
+class MinMaxPyramid
+{
+public:
+    enum Channel { Ir, Red, Temp, ChannelCount };
+
+    static constexpr int levelCount = 3;
+    static constexpr int fanOut = 16;
+
+    struct Bucket {
+        qint64 firstTimestamp;
+        qint64 lastTimestamp;
+        float minimum[ChannelCount]; // значения АЦП до 18 бит представимы во float точно
+        float maximum[ChannelCount];
+    };
+
+    void append(qint64 timestamp, double ir, double red, double temp);
+    void clear();
+
+    // Число отсчётов в корзине уровня level
+    static qint64 factor(int level);
+    // Корзины уровня, включая незавершённую последнюю
+    qint64 levelSize(int level) const;
+    const Bucket& bucket(int level, qint64 index) const;
+
+    // Огибающая канала на [fromMs, toMs] не более чем из columns столбцов (по две точки на столбец:
+    // минимум и максимум). Если отсчётов в интервале мало, возвращаются сами отсчёты из raw.
+    // По оси X — секунды от originMs, как у графиков.
+    void envelope(const SampleStore& raw, Channel channel, qint64 fromMs, qint64 toMs, int columns,
+                  qint64 originMs, QVector<QPointF>& out) const;
+
+    quint64 memoryBytes() const;
+
+private:
+    // Первая корзина уровня, заканчивающаяся не раньше timestamp
+    qint64 firstBucketEndingAfter(int level, qint64 timestamp) const;
+
+    std::deque<Bucket> levels[levelCount]; // deque: готовые корзины не перемещаются при росте
+    Bucket pending[levelCount];
+    int pendingCount[levelCount] = {};
+};
+
+// Прореживание редкого ряда (BPM, SpO₂) по тому же принципу: точки из [fromX, toX], не более
+// двух на столбец. points упорядочены по X.
+void decimatePoints(const QVector<QPointF>& points, double fromX, double toX, int columns, QVector<QPointF>& out);
+void decimatePoints(const SeriesStore& points, double fromX, double toX, int columns, QVector<QPointF>& out);
+
+#endif // MINMAXPYRAMID_H
@@ -0,0 +1,87 @@
+#include "pipelineStats.h"
+
+// ================= LatencyHistogram =================
+qint64 LatencyHistogram::bucketUpper(int bucket)
+{
+    if (bucket < subBuckets)
+        return bucket;
+    const int shift = bucket / subBuckets - 1;
+    const qint64 sub = bucket % subBuckets + subBuckets;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::reset()
+{
+    for (std::atomic<quint64>& bucket : counts)
+        bucket.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::meanNs() const
+{
+    const quint64 n = count();
+    return n > 0 ? double(sum.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+qint64 LatencyHistogram::percentile(double p) const
+{
+    // Счётчики корзин читаются по одному — их сумма, а не total, согласована со снимком
+    quint64 snapshot[bucketCount];
+    quint64 n = 0;
+    for (int i = 0; i < bucketCount; ++i) {
+        snapshot[i] = counts[i].load(std::memory_order_relaxed);
+        n += snapshot[i];
+    }
+    if (n == 0)
+        return 0;
+    const quint64 rank = qMax<quint64>(1, quint64(qBound(0.0, p, 1.0) * n + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < bucketCount; ++i) {
+        seen += snapshot[i];
+        if (seen >= rank)
+            return qMin(bucketUpper(i), max());
+    }
+    return max();
+}
+
+QJsonObject LatencyHistogram::toJson() const
+{
+    const auto us = [](double ns) { return ns / 1000.0; };
+    QJsonObject json;
+    json["count"] = double(count());
+    json["mean_us"] = us(meanNs());
+    json["p50_us"] = us(percentile(0.50));
+    json["p90_us"] = us(percentile(0.90));
+    json["p99_us"] = us(percentile(0.99));
+    json["max_us"] = us(max());
+    return json;
+}
+
+// ================= PipelineStats =================
+const char* PipelineStats::stageName(int stage)
+{
+    switch (stage) {
+    case Decode: return "decode";
+    case Process: return "process";
+    case Queue: return "queue";
+    case Render: return "render";
+    case EndToEnd: return "end_to_end";
+    default: return "?";
+    }
+}
+
+void PipelineStats::reset()
+{
+    for (LatencyHistogram& histogram : stages)
+        histogram.reset();
+}
+
+QJsonObject PipelineStats::toJson() const
+{
+    QJsonObject json;
+    for (int stage = 0; stage < StageCount; ++stage)
+        json[stageName(stage)] = stages[stage].toJson();
+    return json;
+}
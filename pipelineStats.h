@@ -0,0 +1,94 @@
+#ifndef PIPELINESTATS_H
+#define PIPELINESTATS_H
+
+#include <QJsonObject>
+#include <QtAlgorithms>
+#include <atomic>
+#include "traceSpans.h" // monotonicNs()
+
+// Гистограмма задержек в логарифмических корзинах, как HDR Histogram: 8 корзин на каждое
+// удвоение, так что квантиль известен с точностью до 12.5 %; диапазон до ~4.9 ч.
+// Пишет один поток (record() без блокировок: relaxed-атомики), читать можно из любого;
+// снимок, снятый во время записи, может разойтись с ней на несколько значений.
+class LatencyHistogram
+{
+public:
+    static constexpr int subBucketBits = 3;
+    static constexpr int subBuckets = 1 << subBucketBits;
+    static constexpr int maxBits = 44;
+    static constexpr int bucketCount = (maxBits - subBucketBits + 1) * subBuckets;
+
+    LatencyHistogram() { reset(); }
+
+    inline void record(qint64 ns);
+
+    quint64 count() const { return total.load(std::memory_order_relaxed); }
+    qint64 max() const { return maximum.load(std::memory_order_relaxed); }
+    double meanNs() const;
+    // Верхняя граница корзины, в которую попадает квантиль p (0…1), но не больше max()
+    qint64 percentile(double p) const;
+
+    // Сброс из читающего потока: значения, записанные в этот момент, могут потеряться
+    void reset();
+
+    // {"count", "mean_us", "p50_us", "p90_us", "p99_us", "max_us"}
+    QJsonObject toJson() const;
+
+private:
+    static int bucketOf(qint64 ns);
+    static qint64 bucketUpper(int bucket);
+
+    std::atomic<quint64> counts[bucketCount];
+    std::atomic<quint64> total;
+    std::atomic<qint64> sum;
+    std::atomic<qint64> maximum;
+};
+
+inline int LatencyHistogram::bucketOf(qint64 ns)
+{
+    if (ns < subBuckets)
+        return int(qMax<qint64>(0, ns));
+    ns = qMin(ns, (qint64(1) << maxBits) - 1);
+    // Старший бит задаёт удвоение, следующие subBucketBits бит — корзину внутри него
+    const int msb = 63 - int(qCountLeadingZeroBits(quint64(ns)));
+    const int shift = msb - subBucketBits;
+    return (shift + 1) * subBuckets + int((ns >> shift) - subBuckets);
+}
+
+inline void LatencyHistogram::record(qint64 ns)
+{
+    // Пишет один поток — чтение-изменение-запись без атомарных RMW-инструкций
+    std::atomic<quint64>& bucket = counts[bucketOf(ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum.store(sum.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    if (ns > maximum.load(std::memory_order_relaxed))
+        maximum.store(ns, std::memory_order_relaxed);
+}
+
+// Задержки по стадиям конвейера одного устройства. Decode и Process пишет поток обработки,
+// остальные — поток GUI; у каждой гистограммы один писатель.
+struct PipelineStats
+{
+    enum Stage {
+        Decode,   // чтение из сокета (или блок записи) до разобранных отсчётов, на блок
+        Process,  // SignalProcessor::processBatch, на блок
+        Queue,    // самый старый блок, ждавший в кольцевом буфере, до забора в GUI
+        Render,   // кадр графиков сессии
+        EndToEnd, // чтение из сокета до кадра, в котором отсчёт нарисован
+        StageCount
+    };
+
+    static const char* stageName(int stage);
+
+    LatencyHistogram stages[StageCount];
+
+    LatencyHistogram& operator[](Stage stage) { return stages[stage]; }
+    const LatencyHistogram& operator[](Stage stage) const { return stages[stage]; }
+
+    void reset();
+    // {"decode": {...}, "process": {...}, ...}
+    QJsonObject toJson() const;
+};
+
+#endif // PIPELINESTATS_H
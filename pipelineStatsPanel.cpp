@@ -0,0 +1,208 @@
+#include "pipelineStatsPanel.h"
+#include "sessionManager.h"
+#include "traceSpans.h"
+
+#include <QCheckBox>
+#include <QDateTime>
+#include <QFile>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPushButton>
+#include <QSettings>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace {
+
+enum Column {
+    DeviceColumn,
+    RateColumn,
+    ErrorsColumn,
+    DroppedColumn,
+    MemoryColumn,
+    StageColumn,
+    CountColumn,
+    P50Column,
+    P99Column,
+    MaxColumn,
+    ColumnCount
+};
+
+// Задержка в удобных единицах: до миллисекунды — в мкс
+QString formatLatency(qint64 ns)
+{
+    if (ns < 1000000)
+        return QString("%1 µs").arg(ns / 1000.0, 0, 'f', 1);
+    return QString("%1 ms").arg(ns / 1000000.0, 0, 'f', 2);
+}
+
+void setCell(QTableWidget *table, int row, int column, const QString& text)
+{
+    QTableWidgetItem *item = table->item(row, column);
+    if (!item) {
+        item = new QTableWidgetItem();
+        table->setItem(row, column, item);
+    }
+    item->setText(text);
+}
+
+} // namespace
+
+PipelineStatsPanel::PipelineStatsPanel(SessionManager *manager, QWidget *parent)
+    : QWidget(parent)
+    , manager(manager)
+{
+    table = new QTableWidget(0, ColumnCount, this);
+    table->setHorizontalHeaderLabels({"Device", "Samples/s", "Parse errors", "Dropped", "Memory",
+                                      "Stage", "Count", "p50", "p99", "Max"});
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionMode(QAbstractItemView::NoSelection);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    QPushButton *resetButton = new QPushButton("Reset", this);
+    connect(resetButton, &QPushButton::clicked, this, &PipelineStatsPanel::resetStats);
+    QPushButton *saveButton = new QPushButton("Save JSON", this);
+    connect(saveButton, &QPushButton::clicked, this, &PipelineStatsPanel::saveJson);
+
+    QCheckBox *traceCheck = new QCheckBox("Record trace spans", this);
+    traceCheck->setChecked(Trace::enabled());
+    connect(traceCheck, &QCheckBox::toggled, this, [](bool checked) {
+        Trace::setEnabled(checked);
+        QSettings("MyCompany", "MyApp").setValue("traceSpans", checked);
+    });
+    QPushButton *traceButton = new QPushButton("Save trace", this);
+    connect(traceButton, &QPushButton::clicked, this, &PipelineStatsPanel::saveTrace);
+
+    QHBoxLayout *buttons = new QHBoxLayout();
+    buttons->addWidget(traceCheck);
+    buttons->addWidget(traceButton);
+    buttons->addStretch();
+    buttons->addWidget(resetButton);
+    buttons->addWidget(saveButton);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(table);
+    layout->addLayout(buttons);
+
+    QTimer *refreshTimer = new QTimer(this);
+    connect(refreshTimer, &QTimer::timeout, this, [this]() {
+        if (isVisible())
+            refresh();
+    });
+    refreshTimer->start(1000);
+    sinceLastRefresh.start();
+}
+
+void PipelineStatsPanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+}
+
+void PipelineStatsPanel::refresh()
+{
+    const int count = manager->sessionCount();
+    const double elapsedSec = qMax(sinceLastRefresh.restart(), qint64(1)) / 1000.0;
+    const int stageCount = PipelineStats::StageCount;
+
+    // Новые сессии: столбцы сводки объединены на все строки стадий устройства
+    if (table->rowCount() != count * stageCount) {
+        table->clearSpans();
+        table->setRowCount(count * stageCount);
+        for (int session = 0; session < count; ++session) {
+            for (int column = DeviceColumn; column < StageColumn; ++column)
+                table->setSpan(session * stageCount, column, stageCount, 1);
+        }
+    }
+    lastSampleCounts.resize(count);
+    sampleRates.resize(count);
+
+    for (int index = 0; index < count; ++index) {
+        const DeviceSession *session = manager->session(index);
+        const DeviceSession::Summary s = session->summary();
+        sampleRates[index] = (s.samplesDecoded - lastSampleCounts[index]) / elapsedSec;
+        lastSampleCounts[index] = s.samplesDecoded;
+
+        const int firstRow = index * stageCount;
+        setCell(table, firstRow, DeviceColumn, session->config().name);
+        setCell(table, firstRow, RateColumn, QString::number(sampleRates[index], 'f', 0));
+        setCell(table, firstRow, ErrorsColumn, QString::number(s.decodeErrors));
+        setCell(table, firstRow, DroppedColumn, QString::number(s.droppedEvents));
+        setCell(table, firstRow, MemoryColumn,
+                QString("%1 MiB").arg(s.historyBytes / (1024.0 * 1024.0), 0, 'f', 1));
+
+        const PipelineStats& stats = session->stats();
+        for (int stage = 0; stage < stageCount; ++stage) {
+            const LatencyHistogram& histogram = stats.stages[stage];
+            const int row = firstRow + stage;
+            setCell(table, row, StageColumn, PipelineStats::stageName(stage));
+            setCell(table, row, CountColumn, QString::number(histogram.count()));
+            const bool empty = histogram.count() == 0;
+            setCell(table, row, P50Column, empty ? QString("--") : formatLatency(histogram.percentile(0.50)));
+            setCell(table, row, P99Column, empty ? QString("--") : formatLatency(histogram.percentile(0.99)));
+            setCell(table, row, MaxColumn, empty ? QString("--") : formatLatency(histogram.max()));
+        }
+    }
+}
+
+void PipelineStatsPanel::resetStats()
+{
+    for (int index = 0; index < manager->sessionCount(); ++index)
+        manager->session(index)->stats().reset();
+    refresh();
+}
+
+QJsonDocument PipelineStatsPanel::snapshot() const
+{
+    QJsonArray sessions;
+    for (int index = 0; index < manager->sessionCount(); ++index) {
+        const DeviceSession *session = manager->session(index);
+        const DeviceSession::Summary s = session->summary();
+        QJsonObject json;
+        json["name"] = session->config().name;
+        json["host"] = session->config().host;
+        json["samples_decoded"] = double(s.samplesDecoded);
+        json["samples_per_sec"] = sampleRates.value(index, 0.0);
+        json["decode_errors"] = double(s.decodeErrors);
+        json["dropped_events"] = double(s.droppedEvents);
+        json["history_bytes"] = double(s.historyBytes);
+        if (session->journal()) {
+            json["journal_bytes"] = double(s.journalBytes);
+            json["journal_dropped"] = double(s.journalDropped);
+        }
+        json["stages"] = session->stats().toJson();
+        sessions.append(json);
+    }
+    QJsonObject root;
+    root["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["sessions"] = sessions;
+    return QJsonDocument(root);
+}
+
+void PipelineStatsPanel::saveJson()
+{
+    // Как и экспорт данных — в рабочий каталог, имя по времени
+    const QString fileName = QString("pipeline_stats_%1.json")
+                                 .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(lcSession) << "Cannot write pipeline stats to" << fileName << ":" << file.errorString();
+        return;
+    }
+    file.write(snapshot().toJson(QJsonDocument::Indented));
+    qCInfo(lcSession) << "Pipeline stats saved to" << fileName;
+}
+
+void PipelineStatsPanel::saveTrace()
+{
+    const qint64 lastMs = QSettings("MyCompany", "MyApp").value("traceSeconds", 30).toLongLong() * 1000;
+    const QString fileName = QString("trace_%1.json")
+                                 .arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+    if (Trace::writeChromeTrace(fileName, lastMs))
+        qCInfo(lcSession) << "Trace spans saved to" << fileName << "(open in ui.perfetto.dev)";
+}
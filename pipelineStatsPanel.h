@@ -0,0 +1,42 @@
+#ifndef PIPELINESTATSPANEL_H
+#define PIPELINESTATSPANEL_H
+
+#include <QWidget>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QVector>
+
+class QTableWidget;
+class SessionManager;
+
+// Задержки стадий конвейера по всем устройствам (p50/p99/max) и счётчики сессий;
+// обновляется раз в секунду, пока панель видна. Снимок сохраняется в JSON для сравнения прогонов.
+// Здесь же включается запись интервалов трассировки (Trace) и их выгрузка для Perfetto.
+class PipelineStatsPanel : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit PipelineStatsPanel(SessionManager *manager, QWidget *parent = nullptr);
+
+    // {"timestamp", "sessions": [{"name", "samples_per_sec", ..., "stages": {...}}]}
+    QJsonDocument snapshot() const;
+
+public slots:
+    void refresh();
+    void resetStats();
+    void saveJson();
+    // Интервалы горячих путей за последние traceSeconds (настройка, по умолчанию 30 с) — Chrome Trace JSON
+    void saveTrace();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private:
+    SessionManager *manager;
+    QTableWidget *table;
+    QVector<quint64> lastSampleCounts; // для расчёта отсчётов в секунду
+    QVector<double> sampleRates;
+    QElapsedTimer sinceLastRefresh;
+};
+
+#endif // PIPELINESTATSPANEL_H
@@ -0,0 +1,26 @@
+# Накопление результатов обработки и экспорт — только QtCore
+# (приложение, пакетная обработка записей, бенчмарки). Сама обработка сигнала — библиотека dsp.
+include(dsp/dsp.pri)
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/asyncLogger.cpp \
+    $$PWD/columnFile.cpp \
+    $$PWD/exportdatatofiles.cpp \
+    $$PWD/minMaxPyramid.cpp \
+    $$PWD/pipelineStats.cpp \
+    $$PWD/sampleStore.cpp \
+    $$PWD/sessionHistory.cpp \
+    $$PWD/sessionJournal.cpp
+
+HEADERS += \
+    $$PWD/asyncLogger.h \
+    $$PWD/columnFile.h \
+    $$PWD/exportdatatofiles.h \
+    $$PWD/minMaxPyramid.h \
+    $$PWD/pipelineStats.h \
+    $$PWD/sampleStore.h \
+    $$PWD/sessionHistory.h \
+    $$PWD/sessionJournal.h
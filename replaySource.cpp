@@ -0,0 +1,96 @@
+#include "replaySource.h"
+
+#include <QLoggingCategory>
+#include <QTimer>
+
+Q_LOGGING_CATEGORY(lcReplay, "esp32.replay")
+
+ReplaySource::ReplaySource(const QString& path, double speed, QObject* parent)
+    : QObject(parent),
+    path(path),
+    speed(qMax(0.0, speed))
+{
+    stepTimer = new QTimer(this);
+    stepTimer->setSingleShot(true);
+    stepTimer->setTimerType(Qt::PreciseTimer);
+    connect(stepTimer, &QTimer::timeout, this, &ReplaySource::step);
+}
+
+bool ReplaySource::start()
+{
+    if (!reader.open(path)) {
+        qCWarning(lcReplay) << "ReplaySource:" << path << ":" << reader.errorString();
+        return false;
+    }
+    qCInfo(lcReplay) << "Replaying" << path << (speed > 0.0 ? QString("at x%1").arg(speed) : QString("as fast as possible"));
+    finishedFlag = false;
+    hasPending = false;
+    firstOffsetNs = -1;
+    clock.start();
+    stepTimer->start(0);
+    return true;
+}
+
+void ReplaySource::stop()
+{
+    stepTimer->stop();
+    reader.close();
+}
+
+void ReplaySource::step()
+{
+    if (speed <= 0.0) {
+        for (int i = 0; i < chunksPerStep; ++i) {
+            if (!reader.readNext(pending)) {
+                finish();
+                return;
+            }
+            emitChunk();
+        }
+        // Остальное — следующим событием, чтобы поток мог обслужить другие объекты
+        stepTimer->start(0);
+        return;
+    }
+
+    // Реальное (или ускоренное) время: отдаём все блоки, момент которых уже наступил
+    for (;;) {
+        if (!hasPending) {
+            if (!reader.readNext(pending)) {
+                finish();
+                return;
+            }
+            hasPending = true;
+            if (firstOffsetNs < 0)
+                firstOffsetNs = pending.offsetNs;
+        }
+        const qint64 dueNs = qint64((pending.offsetNs - firstOffsetNs) / speed);
+        const qint64 waitNs = dueNs - clock.nsecsElapsed();
+        if (waitNs > 0) {
+            stepTimer->start(int(qMin<qint64>(waitNs / 1000000, 1000)));
+            return;
+        }
+        emitChunk();
+        hasPending = false;
+    }
+}
+
+void ReplaySource::emitChunk()
+{
+    ++chunks;
+    if (pending.type == StreamRecording::Chunk::StreamReset) {
+        emit streamReset();
+        return;
+    }
+    bytes += pending.data.size();
+    emit chunkReady(pending.data);
+}
+
+void ReplaySource::finish()
+{
+    if (reader.hasError())
+        qCWarning(lcReplay) << "ReplaySource:" << path << ":" << reader.errorString();
+    reader.close();
+    finishedFlag = true;
+    qCInfo(lcReplay) << "Replay finished:" << chunks << "chunks," << bytes << "bytes in" << clock.elapsed() << "ms";
+    emit finished();
+}
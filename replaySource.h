@@ -0,0 +1,57 @@
+#ifndef REPLAYSOURCE_H
+#define REPLAYSOURCE_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include "streamRecording.h"
+
+class QTimer;
+
+// Воспроизведение записи .esprec теми же блоками, в том же порядке, что они были приняты.
+// speed = 1 — в реальном времени, 10 — в 10 раз быстрее, 0 — максимально быстро.
+// Результат не зависит от скорости: декодер и обработка видят одинаковую последовательность байтов.
+class ReplaySource : public QObject
+{
+    Q_OBJECT
+public:
+    // Сколько блоков подаётся за один проход в режиме "максимально быстро",
+    // прежде чем вернуть управление циклу событий
+    static constexpr int chunksPerStep = 256;
+
+    ReplaySource(const QString& path, double speed, QObject* parent = nullptr);
+
+    bool start();
+    void stop();
+
+    bool isFinished() const { return finishedFlag; }
+    quint64 chunksReplayed() const { return chunks; }
+    quint64 bytesReplayed() const { return bytes; }
+
+signals:
+    void chunkReady(const QByteArray& data);
+    void streamReset();
+    void finished();
+
+private slots:
+    void step();
+
+private:
+    void emitChunk();
+    void finish();
+
+    QString path;
+    double speed;
+    StreamRecordingReader reader;
+    StreamRecording::Chunk pending;
+    bool hasPending = false;
+    bool finishedFlag = false;
+
+    QTimer* stepTimer;
+    QElapsedTimer clock;     // от начала воспроизведения
+    qint64 firstOffsetNs = -1;
+    quint64 chunks = 0;
+    quint64 bytes = 0;
+};
+
+#endif // REPLAYSOURCE_H
@@ -0,0 +1,160 @@
+#include "sampleStore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+SampleStore::SampleStore() = default;
+SampleStore::~SampleStore() = default;
+
+SampleStore::Chunk* SampleStore::startChunk(qint64 timestamp, qint64 timeShift)
+{
+    // Без обнуления массивов блока: строки всё равно записываются до чтения
+    chunks.push_back(std::unique_ptr<Chunk>(new Chunk));
+    Chunk* chunk = chunks.back().get();
+    chunk->baseTimestamp = timestamp;
+    chunk->timeShift = timeShift;
+    chunk->firstIndex = count;
+    return chunk;
+}
+
+void SampleStore::append(qint64 timestamp, qint64 time, double ir, double red, double temp)
+{
+    if (count > 0 && time < lastTime)
+        time = lastTime;
+    lastTime = time;
+    const qint64 timeShift = time - timestamp;
+
+    Chunk* chunk = chunks.empty() ? nullptr : chunks.back().get();
+    // Новый блок — когда текущий заполнен, сменился сдвиг времени сессии (время ESP32 пошло назад
+    // после перезапуска — смещения внутри блока остаются неубывающими) или смещение времени
+    // не помещается в 32 бита (метки начались заново спустя недели работы)
+    if (!chunk || chunk->count == chunkSize || chunk->timeShift != timeShift
+        || timestamp - chunk->baseTimestamp > std::numeric_limits<qint32>::max())
+        chunk = startChunk(timestamp, timeShift);
+
+    const int i = chunk->count++;
+    chunk->timeOffset[i] = qint32(timestamp - chunk->baseTimestamp);
+    chunk->ir[i] = quint32(qBound(0.0, std::round(ir), 4294967295.0));
+    chunk->red[i] = quint32(qBound(0.0, std::round(red), 4294967295.0));
+    chunk->temp[i] = qint16(qBound(-32768.0, std::round(temp * 100.0), 32767.0));
+    ++count;
+}
+
+void SampleStore::clear()
+{
+    chunks.clear();
+    count = 0;
+}
+
+std::size_t SampleStore::chunkOf(qint64 index) const
+{
+    // Блоки обычно полные, но после скачка времени блок закрывается раньше — ищем по firstIndex
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), index,
+                               [](qint64 value, const std::unique_ptr<Chunk>& chunk) {
+                                   return value < chunk->firstIndex;
+                               });
+    return std::size_t(it - chunks.begin()) - 1;
+}
+
+SampleStore::Row SampleStore::at(qint64 index) const
+{
+    const Chunk& chunk = *chunks[chunkOf(index)];
+    return chunk.row(int(index - chunk.firstIndex));
+}
+
+qint64 SampleStore::lowerBound(qint64 time) const
+{
+    // Первый блок, последняя строка которого не раньше time, затем поиск внутри него.
+    // Время сессии не убывает во всём хранилище, поэтому блоки упорядочены
+    auto it = std::lower_bound(chunks.begin(), chunks.end(), time,
+                               [](const std::unique_ptr<Chunk>& chunk, qint64 value) {
+                                   return chunk->baseTimestamp + chunk->timeShift + chunk->timeOffset[chunk->count - 1]
+                                          < value;
+                               });
+    if (it == chunks.end())
+        return count;
+    const Chunk& chunk = **it;
+    const qint64 offset = time - chunk.baseTimestamp - chunk.timeShift;
+    if (offset <= 0)
+        return chunk.firstIndex;
+    const qint32* found = std::lower_bound(chunk.timeOffset, chunk.timeOffset + chunk.count, qint32(offset));
+    return chunk.firstIndex + (found - chunk.timeOffset);
+}
+
+quint64 SampleStore::memoryBytes() const
+{
+    return quint64(chunks.size()) * sizeof(Chunk) + quint64(chunks.capacity()) * sizeof(std::unique_ptr<Chunk>);
+}
+
+// --------------------- SeriesStore ---------------------
+
+SeriesStore::SeriesStore() = default;
+SeriesStore::~SeriesStore() = default;
+
+void SeriesStore::append(double x, double y)
+{
+    qint64 ms = qRound64(x * 1000.0);
+    if (count > 0 && ms < lastMs)
+        ms = lastMs;
+    lastMs = ms;
+
+    Chunk* chunk = chunks.empty() ? nullptr : chunks.back().get();
+    if (!chunk || chunk->count == chunkSize || ms - chunk->baseMs > std::numeric_limits<qint32>::max()) {
+        chunks.push_back(std::unique_ptr<Chunk>(new Chunk));
+        chunk = chunks.back().get();
+        chunk->baseMs = ms;
+        chunk->firstIndex = count;
+    }
+    const int i = chunk->count++;
+    chunk->offsetMs[i] = qint32(ms - chunk->baseMs);
+    chunk->value[i] = float(y);
+    ++count;
+}
+
+void SeriesStore::clear()
+{
+    chunks.clear();
+    count = 0;
+}
+
+std::size_t SeriesStore::chunkOf(qint64 index) const
+{
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), index,
+                               [](qint64 value, const std::unique_ptr<Chunk>& chunk) {
+                                   return value < chunk->firstIndex;
+                               });
+    return std::size_t(it - chunks.begin()) - 1;
+}
+
+QPointF SeriesStore::at(qint64 index) const
+{
+    const Chunk& chunk = *chunks[chunkOf(index)];
+    return chunk.point(int(index - chunk.firstIndex));
+}
+
+qint64 SeriesStore::lowerBound(double x) const
+{
+    // Сравнение в секундах — так же, как с QPointF::x() исходного ряда
+    auto it = std::lower_bound(chunks.begin(), chunks.end(), x, [](const std::unique_ptr<Chunk>& chunk, double value) {
+        return chunk->point(chunk->count - 1).x() < value;
+    });
+    if (it == chunks.end())
+        return count;
+    const Chunk& chunk = **it;
+    int low = 0;
+    int high = chunk.count;
+    while (low < high) {
+        const int mid = (low + high) / 2;
+        if (chunk.point(mid).x() < x)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return chunk.firstIndex + low;
+}
+
+quint64 SeriesStore::memoryBytes() const
+{
+    return quint64(chunks.size()) * sizeof(Chunk) + quint64(chunks.capacity()) * sizeof(std::unique_ptr<Chunk>);
+}
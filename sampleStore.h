@@ -0,0 +1,174 @@
+#ifndef SAMPLESTORE_H
+#define SAMPLESTORE_H
+
+#include <QPointF>
+#include <QtGlobal>
+#include <memory>
+#include <vector>
+
+// Исходные отсчёты длинной сессии в компактном столбцовом виде.
+// Отсчёты лежат блоками по chunkSize строк; заполненный блок больше не перемещается и не
+// перевыделяется — растёт только массив указателей на блоки.
+// Строка занимает 14 байт вместо 48 у трёх QPointF:
+//   время  — смещение от начала блока, мс, i32 (время хранится один раз на строку)
+//   IR/Red — u32 (АЦП MAX30102 — 18 бит, дробная часть не нужна)
+//   Temp   — сотые доли °C, i16 (как в двоичном протоколе)
+// Кроме времени ESP32 у строки есть время сессии — по нему идёт поиск. После перезапуска ESP32
+// время датчика идёт назад, а время сессии — нет; блок хранит один сдвиг между ними, поэтому
+// при его смене (и при любом скачке времени датчика назад) начинается новый блок.
+class SampleStore
+{
+public:
+    static constexpr int chunkSize = 4096;
+
+    struct Row {
+        qint64 timestamp; // время ESP32, мс
+        qint64 time;      // время сессии, мс: до первого перезапуска ESP32 совпадает с timestamp
+        double ir;
+        double red;
+        double temp;
+    };
+
+    SampleStore();
+    ~SampleStore();
+
+    // time не убывает; меньшее значение поднимается до последнего
+    void append(qint64 timestamp, qint64 time, double ir, double red, double temp);
+    void clear();
+
+    qint64 size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    Row at(qint64 index) const; // 0 <= index < size()
+    // Номер первой строки со временем сессии не раньше time; size(), если такой нет
+    qint64 lowerBound(qint64 time) const;
+
+    // fn(const Row&) для каждой строки по порядку; без поиска блока на каждую строку
+    template<typename Fn>
+    void forEach(Fn&& fn) const;
+    // То же для строк [begin, end): блок ищется один раз, а не для каждой строки, как в at()
+    template<typename Fn>
+    void forEach(qint64 begin, qint64 end, Fn&& fn) const;
+
+    // Фактически занятая память (блоки и массив указателей) и её доля на один отсчёт
+    quint64 memoryBytes() const;
+    double bytesPerSample() const { return count > 0 ? double(memoryBytes()) / count : 0.0; }
+
+private:
+    struct Chunk {
+        qint64 baseTimestamp = 0;
+        qint64 timeShift = 0;  // время сессии − время ESP32, одно на блок
+        qint64 firstIndex = 0; // номер первой строки блока во всём хранилище
+        int count = 0;
+        qint32 timeOffset[chunkSize]; // не убывают внутри блока
+        quint32 ir[chunkSize];
+        quint32 red[chunkSize];
+        qint16 temp[chunkSize];
+
+        Row row(int i) const
+        {
+            const qint64 timestamp = baseTimestamp + timeOffset[i];
+            return { timestamp, timestamp + timeShift, double(ir[i]), double(red[i]), temp[i] / 100.0 };
+        }
+    };
+
+    Chunk* startChunk(qint64 timestamp, qint64 timeShift);
+    // Номер блока, в котором лежит строка index
+    std::size_t chunkOf(qint64 index) const;
+
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    qint64 count = 0;
+    qint64 lastTime = 0;
+};
+
+// Длинный ряд «время сессии (с) — значение» в том же блочном виде. Для SpO₂ по AC/DC, где точка
+// приходит почти с каждым отсчётом: 8 байт на точку вместо 16 у QPointF (и до 32 с запасом QVector).
+//   x — смещение от начала блока, мс, i32 (x исходно — целые мс, делённые на 1000)
+//   y — float (SpO₂ — целые проценты)
+class SeriesStore
+{
+public:
+    static constexpr int chunkSize = 4096;
+
+    SeriesStore();
+    ~SeriesStore();
+
+    // x не убывает (время сессии); меньшее значение поднимается до последнего
+    void append(double x, double y);
+    void clear();
+
+    qint64 size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    QPointF at(qint64 index) const; // 0 <= index < size()
+    // Номер первой точки с x не меньше заданного; size(), если такой нет
+    qint64 lowerBound(double x) const;
+
+    // fn(const QPointF&) для точек [begin, end) по порядку
+    template<typename Fn>
+    void forEach(qint64 begin, qint64 end, Fn&& fn) const;
+    template<typename Fn>
+    void forEach(Fn&& fn) const { forEach(0, count, fn); }
+
+    quint64 memoryBytes() const;
+
+private:
+    struct Chunk {
+        qint64 baseMs = 0;
+        qint64 firstIndex = 0;
+        int count = 0;
+        qint32 offsetMs[chunkSize];
+        float value[chunkSize];
+
+        QPointF point(int i) const { return QPointF((baseMs + offsetMs[i]) / 1000.0, value[i]); }
+    };
+
+    std::size_t chunkOf(qint64 index) const;
+
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    qint64 count = 0;
+    qint64 lastMs = 0;
+};
+
+template<typename Fn>
+void SampleStore::forEach(Fn&& fn) const
+{
+    for (const std::unique_ptr<Chunk>& chunk : chunks) {
+        for (int i = 0; i < chunk->count; ++i) {
+            const Row row = chunk->row(i);
+            fn(row);
+        }
+    }
+}
+
+template<typename Fn>
+void SampleStore::forEach(qint64 begin, qint64 end, Fn&& fn) const
+{
+    if (begin >= end)
+        return;
+    std::size_t c = chunkOf(begin);
+    int i = int(begin - chunks[c]->firstIndex);
+    for (qint64 index = begin; index < end; ++c, i = 0) {
+        const Chunk& chunk = *chunks[c];
+        for (; i < chunk.count && index < end; ++i, ++index) {
+            const Row row = chunk.row(i);
+            fn(row);
+        }
+    }
+}
+
+template<typename Fn>
+void SeriesStore::forEach(qint64 begin, qint64 end, Fn&& fn) const
+{
+    if (begin >= end)
+        return;
+    std::size_t c = chunkOf(begin);
+    int i = int(begin - chunks[c]->firstIndex);
+    for (qint64 index = begin; index < end; ++c, i = 0) {
+        const Chunk& chunk = *chunks[c];
+        for (; i < chunk.count && index < end; ++i, ++index) {
+            const QPointF point = chunk.point(i);
+            fn(point);
+        }
+    }
+}
+
+#endif // SAMPLESTORE_H
@@ -0,0 +1,57 @@
+#include "sampleStreamDecoder.h"
+
+#include <cstring>
+
+int SampleStreamDecoder::feed(const char* data, qsizetype size, QVector<SensorSample>& out)
+{
+    return feed(data, size, [&out](const SensorSample& sample) { out.append(sample); });
+}
+
+const char* SampleStreamDecoder::protocolName(Protocol protocol)
+{
+    switch (protocol) {
+    case Protocol::Csv:
+        return "CSV";
+    case Protocol::Binary:
+        return "binary";
+    case Protocol::Unknown:
+        break;
+    }
+    return "unknown";
+}
+
+void SampleStreamDecoder::reset()
+{
+    detected = Protocol::Unknown;
+    probe.clear();
+    csv.reset();
+    binary.reset();
+}
+
+bool SampleStreamDecoder::probeBinary(const char* data, qsizetype size)
+{
+    // В тексте CSV байта 0xA5 нет: пока он не встретился, проверка — один memchr по порции
+    const char magic = char(BinaryProtocol::magicBytes[0]);
+    if (probe.isEmpty()) {
+        const char* start = static_cast<const char*>(std::memchr(data, magic, size_t(size)));
+        if (!start)
+            return false;
+        size -= start - data;
+        data = start;
+    }
+    probe.append(data, size);
+    if (BinaryProtocol::findFrame(probe.constData(), probe.size()))
+        return true;
+
+    // Кадр, начатый раньше последних frameSize(maxSamplesPerFrame) байт, уже был бы целым
+    const qsizetype keep = BinaryProtocol::frameSize(BinaryProtocol::maxSamplesPerFrame);
+    if (probe.size() > 2 * keep) {
+        const qsizetype from = probe.size() - keep;
+        const char* start = static_cast<const char*>(std::memchr(probe.constData() + from, magic, size_t(keep)));
+        if (start)
+            probe.remove(0, start - probe.constData());
+        else
+            probe.clear();
+    }
+    return false;
+}
@@ -0,0 +1,64 @@
+#ifndef SAMPLESTREAMDECODER_H
+#define SAMPLESTREAMDECODER_H
+
+#include <QVector>
+#include <utility>
+#include "binaryProtocol.h"
+#include "csvSampleParser.h"
+
+// Определяет протокол устройства по первому байту потока (magic двоичного кадра или текст)
+// и передаёт данные соответствующему декодеру. Двоичный протокол фиксируется до reset(),
+// CSV — нет: целый кадр с верными magic, заголовком и CRC переключает на двоичный
+// (поток подхвачен с середины кадра или прошивку перевели на двоичный протокол)
+class SampleStreamDecoder
+{
+public:
+    enum class Protocol { Unknown, Csv, Binary };
+
+    template<typename Sink>
+    int feed(const char* data, qsizetype size, Sink&& sink);
+
+    int feed(const char* data, qsizetype size, QVector<SensorSample>& out);
+
+    Protocol protocol() const { return detected; }
+    static const char* protocolName(Protocol protocol);
+
+    const CsvSampleParser& csvParser() const { return csv; }
+    const BinaryFrameDecoder& binaryDecoder() const { return binary; }
+
+    quint64 samplesDecoded() const { return csv.counters().linesParsed + binary.counters().samplesDecoded; }
+    quint64 errorCount() const { return csv.errorCount() + binary.errorCount(); }
+
+    // Вызывается при новом соединении: протокол определяется заново, счётчики сохраняются
+    void reset();
+
+private:
+    // Копит байты CSV-потока начиная с первого 0xA5; true — в них есть целый двоичный кадр
+    bool probeBinary(const char* data, qsizetype size);
+
+    Protocol detected = Protocol::Unknown;
+    QByteArray probe;
+    CsvSampleParser csv;
+    BinaryFrameDecoder binary;
+};
+
+template<typename Sink>
+int SampleStreamDecoder::feed(const char* data, qsizetype size, Sink&& sink)
+{
+    if (size <= 0)
+        return 0;
+    if (detected == Protocol::Unknown)
+        detected = (quint8(data[0]) == BinaryProtocol::magicBytes[0]) ? Protocol::Binary : Protocol::Csv;
+
+    if (detected == Protocol::Csv && probeBinary(data, size)) {
+        detected = Protocol::Binary;
+        csv.reset();
+        const QByteArray bytes = std::exchange(probe, QByteArray());
+        return binary.feed(bytes.constData(), bytes.size(), sink);
+    }
+    if (detected == Protocol::Binary)
+        return binary.feed(data, size, sink);
+    return csv.feed(data, size, sink);
+}
+
+#endif // SAMPLESTREAMDECODER_H
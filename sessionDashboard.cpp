@@ -0,0 +1,107 @@
+#include "sessionDashboard.h"
+#include "sessionManager.h"
+
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace {
+
+enum Column {
+    DeviceColumn,
+    HostColumn,
+    StatusColumn,
+    BpmColumn,
+    AvgBpmColumn,
+    SpectralBpmColumn,
+    Spo2Column,
+    Spo2PeakColumn,
+    RateColumn,
+    ErrorsColumn,
+    DroppedColumn,
+    ColumnCount
+};
+
+QString valueOrDash(double value, int precision)
+{
+    return value > 0.0 ? QString::number(value, 'f', precision) : QString("--");
+}
+
+// Состояние соединения; после переподключений — их число и время последнего восстановления
+QString connectionStatus(const DeviceSession::Summary& s)
+{
+    QString status = ConnectionManager::stateName(s.connectionState);
+    if (s.reconnects > 0)
+        status += QString(" (%1 reconnects, last %2 ms)").arg(s.reconnects).arg(s.lastReconnectMs);
+    return status;
+}
+
+} // namespace
+
+SessionDashboard::SessionDashboard(SessionManager *manager, QWidget *parent)
+    : QWidget(parent)
+    , manager(manager)
+{
+    table = new QTableWidget(0, ColumnCount, this);
+    table->setHorizontalHeaderLabels({"Device", "Host", "Status", "BPM", "Avg BPM", "Spectral BPM",
+                                      "SpO₂ AC/DC", "SpO₂ Peaks", "Samples/s", "Errors", "Dropped"});
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    connect(table, &QTableWidget::cellDoubleClicked, this, [this](int row, int) {
+        emit sessionActivated(row);
+    });
+
+    QPushButton *addDeviceButton = new QPushButton("Add device", this);
+    connect(addDeviceButton, &QPushButton::clicked, this, &SessionDashboard::addDeviceRequested);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(table);
+    layout->addWidget(addDeviceButton);
+
+    QTimer *refreshTimer = new QTimer(this);
+    connect(refreshTimer, &QTimer::timeout, this, &SessionDashboard::refresh);
+    refreshTimer->start(1000);
+    sinceLastRefresh.start();
+}
+
+void SessionDashboard::refresh()
+{
+    const int count = manager->sessionCount();
+    const double elapsedSec = qMax(sinceLastRefresh.restart(), qint64(1)) / 1000.0;
+    table->setRowCount(count);
+    lastSampleCounts.resize(count);
+
+    for (int row = 0; row < count; ++row) {
+        const DeviceSession *session = manager->session(row);
+        const DeviceSession::Summary s = session->summary();
+        const double rate = (s.samplesDecoded - lastSampleCounts[row]) / elapsedSec;
+        lastSampleCounts[row] = s.samplesDecoded;
+
+        const QString cells[ColumnCount] = {
+            session->config().name,
+            QString("%1:%2").arg(session->config().host).arg(session->config().port),
+            connectionStatus(s),
+            valueOrDash(s.lastBpm, 1),
+            valueOrDash(s.lastAvgBpm, 1),
+            valueOrDash(s.lastSpectralBpm, 1),
+            valueOrDash(s.lastSpo2, 0),
+            valueOrDash(s.lastSpo2Peak, 0),
+            QString::number(rate, 'f', 0),
+            QString::number(s.decodeErrors),
+            QString::number(s.droppedEvents),
+        };
+        for (int column = 0; column < ColumnCount; ++column) {
+            QTableWidgetItem *item = table->item(row, column);
+            if (!item) {
+                item = new QTableWidgetItem();
+                table->setItem(row, column, item);
+            }
+            item->setText(cells[column]);
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef SESSIONDASHBOARD_H
+#define SESSIONDASHBOARD_H
+
+#include <QWidget>
+#include <QElapsedTimer>
+#include <QVector>
+
+class QTableWidget;
+class SessionManager;
+
+// Сводная таблица по всем устройствам; двойной щелчок открывает графики устройства
+class SessionDashboard : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit SessionDashboard(SessionManager *manager, QWidget *parent = nullptr);
+
+signals:
+    void sessionActivated(int index);
+    void addDeviceRequested();
+
+public slots:
+    void refresh();
+
+private:
+    SessionManager *manager;
+    QTableWidget *table;
+    QVector<quint64> lastSampleCounts; // для расчёта отсчётов в секунду
+    QElapsedTimer sinceLastRefresh;
+};
+
+#endif // SESSIONDASHBOARD_H
@@ -0,0 +1,61 @@
+#include "sessionHistory.h"
+
+void SessionHistory::apply(const PipelineEvent* events, int count)
+{
+    for (int i = 0; i < count; ++i)
+        apply(events[i]);
+}
+
+void SessionHistory::apply(const PipelineEvent& event)
+{
+    if (event.type == PipelineEvent::Sample) {
+        // Начало сессии восстанавливаем по первому отсчёту
+        if (timeStart == 0) {
+            timeStart = event.timestamp - qRound64(event.timeSec * 1000.0);
+            lastSessionTime = event.timestamp;
+        }
+        if (event.timestamp + timelineShift < lastSessionTime) {
+            // Перезапуск ESP32: время сессии продолжается с последнего значения
+            timelineShift = lastSessionTime - event.timestamp;
+        }
+        lastSessionTime = event.timestamp + timelineShift;
+        lastReceivedTimestamp = event.timestamp;
+    }
+
+    const double t = sessionTimeSec(event);
+    switch (event.type) {
+    case PipelineEvent::Sample:
+        if (!keepSamples)
+            break;
+        sampleStore.append(event.timestamp, lastSessionTime, event.value, event.value2, event.value3);
+        samplePyramid.append(lastSessionTime, event.value, event.value2, event.value3);
+        break;
+    case PipelineEvent::Spo2:
+        spo2Store.append(t, event.value);
+        break;
+    case PipelineEvent::Bpm:
+        allBpmData.append(QPointF(t, event.value));
+        allAvgBpmData.append(QPointF(t, event.value2));
+        break;
+    case PipelineEvent::Spo2Peak:
+        allSpo2PeakData.append(QPointF(t, event.value));
+        break;
+    case PipelineEvent::SpectralBpm:
+        allSpectralBpmData.append(QPointF(t, event.value));
+        break;
+    case PipelineEvent::Peak:
+        break;
+    }
+}
+
+SessionHistory::MemoryReport SessionHistory::memoryReport() const
+{
+    MemoryReport report;
+    report.samples = sampleStore.size();
+    report.sampleBytes = sampleStore.memoryBytes();
+    report.pyramidBytes = samplePyramid.memoryBytes();
+    for (const QVector<QPointF>* series : { &allBpmData, &allAvgBpmData, &allSpo2PeakData, &allSpectralBpmData })
+        report.seriesBytes += quint64(series->capacity()) * sizeof(QPointF);
+    report.seriesBytes += spo2Store.memoryBytes();
+    return report;
+}
@@ -0,0 +1,78 @@
+#ifndef SESSIONHISTORY_H
+#define SESSIONHISTORY_H
+
+#include <QPointF>
+#include <QVector>
+#include "minMaxPyramid.h"
+#include "pipelineEvent.h"
+#include "sampleStore.h"
+
+// Накопленные результаты обработки одной сессии (для экспорта). Не зависит от графиков:
+// используется и окном (через DataProcessor), и пакетной обработкой записей.
+// Исходные отсчёты — в компактном SampleStore, SpO₂ по AC/DC (почти точка на отсчёт) — в SeriesStore;
+// редкие результаты (BPM, SpO₂ по пикам) — точками, где по оси X время от начала сессии в секундах,
+// по Y — значение.
+// Время сессии не идёт назад: если время ESP32 пошло назад (перезапуск устройства), оно сдвигается
+// так, чтобы продолжаться с последнего значения (как в RollingStatistics). До перезапуска время
+// сессии совпадает с временем ESP32, а X — с PipelineEvent::timeSec.
+class SessionHistory
+{
+public:
+    // Без исходных отсчётов (IR/Red/Temp) история в разы меньше — для длинных записей,
+    // где сами отсчёты и так есть в файле записи
+    void setKeepSamples(bool keep) { keepSamples = keep; }
+
+    void apply(const PipelineEvent* events, int count);
+    void apply(const PipelineEvent& event);
+
+    qint64 getStartTime() const { return timeStart; }
+    // Настенное время (мс от эпохи) в момент getStartTime(): из записи или журнала, для живого
+    // подключения — часы хоста при первом отсчёте; -1 — неизвестно
+    void setStartEpochMs(qint64 epochMs) { startEpochMs = epochMs; }
+    qint64 getStartEpochMs() const { return startEpochMs; }
+    qint64 getLastTimestamp() const { return lastReceivedTimestamp; }
+    double getElapsedTime() const { return (static_cast<double>(lastSessionTime - timeStart)) / 1000.0; }
+    // X события на оси сессии (с учётом перезапусков ESP32, учтённых на момент вызова)
+    double sessionTimeSec(const PipelineEvent& event) const { return event.timeSec + timelineShift / 1000.0; }
+
+    // Исходные отсчёты IR/Red/Temp (пусто при setKeepSamples(false))
+    const SampleStore& samples() const { return sampleStore; }
+    // Огибающие тех же отсчётов для просмотра всей сессии с любым масштабом
+    const MinMaxPyramid& pyramid() const { return samplePyramid; }
+
+    const QVector<QPointF>& getAllBpmData() const { return allBpmData; }
+    const QVector<QPointF>& getAllAvgBpmData() const { return allAvgBpmData; }
+    const SeriesStore& getAllSpo2Data() const { return spo2Store; }
+    const QVector<QPointF>& getAllSpo2PeakData() const { return allSpo2PeakData; }
+    const QVector<QPointF>& getAllSpectralBpmData() const { return allSpectralBpmData; }
+
+    // Память, занятая историей: отсчёты отдельно от остальных рядов
+    struct MemoryReport {
+        qint64 samples = 0;
+        quint64 sampleBytes = 0;
+        quint64 pyramidBytes = 0;
+        quint64 seriesBytes = 0;  // BPM (по пикам, средний, по спектру), оба SpO₂
+
+        double bytesPerSample() const { return samples > 0 ? double(sampleBytes) / samples : 0.0; }
+        quint64 totalBytes() const { return sampleBytes + pyramidBytes + seriesBytes; }
+    };
+    MemoryReport memoryReport() const;
+
+private:
+    SampleStore sampleStore;
+    MinMaxPyramid samplePyramid;
+    QVector<QPointF> allBpmData;
+    QVector<QPointF> allAvgBpmData;
+    SeriesStore spo2Store;
+    QVector<QPointF> allSpo2PeakData;
+    QVector<QPointF> allSpectralBpmData;
+
+    qint64 timeStart = 0;
+    qint64 startEpochMs = -1;
+    qint64 lastReceivedTimestamp = 0;
+    qint64 lastSessionTime = 0;
+    qint64 timelineShift = 0; // время сессии − время ESP32, мс
+    bool keepSamples = true;
+};
+
+#endif // SESSIONHISTORY_H
@@ -0,0 +1,348 @@
+#include "sessionJournal.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QLoggingCategory>
+#include <QtEndian>
+#include <cstring>
+
+#if defined(Q_OS_WIN)
+#include <io.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+Q_LOGGING_CATEGORY(lcJournal, "esp32.journal")
+
+namespace {
+
+const int pollIntervalMs = 100; // как часто поток записи забирает очередь
+
+template<typename T>
+char* put(char* out, T value)
+{
+    qToLittleEndian(value, out);
+    return out + sizeof(T);
+}
+
+template<typename T>
+T get(const char* in)
+{
+    return qFromLittleEndian<T>(in);
+}
+
+int recordSize(quint8 type)
+{
+    if (type == PipelineEvent::Sample)
+        return SessionJournalFormat::sampleRecordSize;
+    if (type <= PipelineEvent::SpectralBpm)
+        return SessionJournalFormat::valueRecordSize;
+    return 0;
+}
+
+} // namespace
+
+SessionJournal::SessionJournal(const Settings& settings)
+    : settings(settings)
+    , queue(queueCapacity)
+{
+    setObjectName("journal");
+    popped.resize(4096);
+    buffer.reserve(settings.writeBufferBytes + SessionJournalFormat::valueRecordSize);
+}
+
+SessionJournal::~SessionJournal()
+{
+    stop();
+}
+
+void SessionJournal::append(const PipelineEvent* events, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        if (!queue.tryPush(events[i]))
+            dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Всплеск (воспроизведение на максимальной скорости) — будим поток записи, не дожидаясь опроса
+    if (queue.sizeApprox() > queueCapacity / 4) {
+        QMutexLocker locker(&mutex);
+        wake.wakeOne();
+    }
+}
+
+bool SessionJournal::requestFinalize(quint64* ticket)
+{
+    // Под mutex
+    if (writerDone || !isRunning())
+        return false;
+    *ticket = ++finalizeTicket;
+    wake.wakeOne();
+    return true;
+}
+
+QStringList SessionJournal::finalizeSegments()
+{
+    QMutexLocker locker(&mutex);
+    quint64 ticket;
+    if (requestFinalize(&ticket)) {
+        while (finalizedTicket < ticket)
+            finalized.wait(&mutex);
+    }
+    return closedSegments;
+}
+
+void SessionJournal::finalizeSegmentsAsync()
+{
+    QStringList segments;
+    {
+        QMutexLocker locker(&mutex);
+        quint64 ticket;
+        if (requestFinalize(&ticket))
+            return;
+        segments = closedSegments;
+    }
+    emit segmentsFinalized(segments);
+}
+
+void SessionJournal::stop()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        wake.wakeOne();
+    }
+    wait();
+}
+
+void SessionJournal::run()
+{
+    sinceWrite.start();
+    sinceSync.start();
+    for (;;) {
+        bool stop;
+        quint64 ticket;
+        {
+            QMutexLocker locker(&mutex);
+            if (!stopping && finalizeTicket == finalizedTicket)
+                wake.wait(&mutex, pollIntervalMs);
+            stop = stopping;
+            // Запросы до этого номера поставлены после событий, которые drainQueue() заберёт ниже
+            ticket = finalizeTicket;
+        }
+
+        drainQueue();
+        if (!buffer.isEmpty() && sinceWrite.elapsed() >= settings.flushIntervalMs)
+            writeBuffer();
+        if (unsynced && sinceSync.elapsed() >= settings.syncIntervalMs)
+            syncSegment();
+
+        if (ticket != finalizedTicket || stop) {
+            writeBuffer();
+            closeSegment();
+            QStringList segments;
+            {
+                QMutexLocker locker(&mutex);
+                // После остановки записывать больше нечего — выполнены и запросы, пришедшие позже
+                writerDone = stop;
+                finalizedTicket = stop ? finalizeTicket : ticket;
+                segments = closedSegments;
+                finalized.wakeAll();
+            }
+            emit segmentsFinalized(segments);
+            if (stop)
+                break;
+        }
+    }
+}
+
+void SessionJournal::drainQueue()
+{
+    int count;
+    while ((count = queue.tryPop(popped.data(), popped.size())) > 0) {
+        for (int i = 0; i < count; ++i)
+            encode(popped[i]);
+    }
+}
+
+void SessionJournal::encode(const PipelineEvent& event)
+{
+    // Новый сегмент — по размеру или возрасту текущего; первый открывается с первым событием
+    if (file.isOpen()) {
+        const bool tooLarge = segmentBytes + buffer.size() >= settings.maxSegmentBytes;
+        const bool tooOld = settings.maxSegmentMinutes > 0
+                            && segmentAge.elapsed() >= qint64(settings.maxSegmentMinutes) * 60000;
+        if (tooLarge || tooOld) {
+            writeBuffer();
+            closeSegment();
+        }
+    }
+    if (!file.isOpen()) {
+        if (hasFailed() || !openSegment(event)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    const qsizetype offset = buffer.size();
+    if (event.type == PipelineEvent::Sample) {
+        buffer.resize(offset + SessionJournalFormat::sampleRecordSize);
+        char* out = buffer.data() + offset;
+        out = put<quint8>(out, event.type);
+        out = put<qint64>(out, event.timestamp);
+        out = put<qint32>(out, qint32(qRound(event.value)));
+        out = put<qint32>(out, qint32(qRound(event.value2)));
+        put<qint16>(out, qint16(qRound(event.value3 * 100.0)));
+    } else {
+        buffer.resize(offset + SessionJournalFormat::valueRecordSize);
+        char* out = buffer.data() + offset;
+        out = put<quint8>(out, event.type);
+        out = put<qint64>(out, event.timestamp);
+        out = put<double>(out, event.value);
+        put<double>(out, event.value2);
+    }
+    if (buffer.size() >= settings.writeBufferBytes)
+        writeBuffer();
+}
+
+bool SessionJournal::openSegment(const PipelineEvent& first)
+{
+    // Время начала сессии одно на все сегменты — timeSec не зависит от того, где разрезан журнал
+    if (segmentIndex == 0) {
+        const qint64 sinceOriginMs = qRound64(first.timeSec * 1000.0);
+        origin = first.timestamp - sinceOriginMs;
+        sessionEpochMs = settings.startEpochMs >= 0 ? settings.startEpochMs
+                                                    : QDateTime::currentMSecsSinceEpoch() - sinceOriginMs;
+    }
+    ++segmentIndex;
+
+    QDir dir(settings.directory);
+    if (!dir.exists())
+        dir.mkpath(".");
+    const QString path = dir.absoluteFilePath(QString("%1_%2%3")
+                                                  .arg(settings.baseName)
+                                                  .arg(segmentIndex, 3, 10, QChar('0'))
+                                                  .arg(SessionJournalFormat::suffix));
+    file.setFileName(path);
+    // Без буфера QFile: данные и так уходят крупными блоками
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        qCWarning(lcJournal) << "Cannot create journal segment" << path << ":" << file.errorString();
+        failed.store(true, std::memory_order_relaxed);
+        return false;
+    }
+
+    char header[SessionJournalFormat::fileHeaderSize] = {};
+    char* out = header;
+    memcpy(out, SessionJournalFormat::magic, 4);
+    out = put<quint16>(out + 4, SessionJournalFormat::version);
+    out = put<quint16>(out, 0);
+    out = put<quint32>(out, quint32(segmentIndex));
+    out = put<quint32>(out, 0);
+    out = put<qint64>(out, sessionEpochMs);
+    put<qint64>(out, origin);
+    // Буфер здесь пуст (предыдущий сегмент дописан) — заголовок уйдёт на диск вместе с первыми записями
+    buffer.append(header, sizeof(header));
+    segmentBytes = 0;
+    segmentAge.start();
+    qCInfo(lcJournal) << "Journal segment" << path;
+    return true;
+}
+
+void SessionJournal::writeBuffer()
+{
+    sinceWrite.restart();
+    if (buffer.isEmpty() || !file.isOpen())
+        return;
+    const qint64 n = file.write(buffer.constData(), buffer.size());
+    if (n != buffer.size()) {
+        qCWarning(lcJournal) << "Journal write failed:" << file.fileName() << ":" << file.errorString();
+        failed.store(true, std::memory_order_relaxed);
+        // Уже записанное остаётся годным сегментом
+        closeSegment();
+    } else {
+        segmentBytes += n;
+        written.fetch_add(quint64(n), std::memory_order_relaxed);
+        unsynced = true;
+        if (settings.syncIntervalMs <= 0)
+            syncSegment();
+    }
+    buffer.resize(0);
+}
+
+void SessionJournal::syncSegment()
+{
+    sinceSync.restart();
+    if (!unsynced || !file.isOpen())
+        return;
+    // Данные уже в кэше ОС; fsync — чтобы они пережили отключение питания, а не только падение программы
+#if defined(Q_OS_WIN)
+    _commit(file.handle());
+#elif defined(Q_OS_UNIX)
+    ::fsync(file.handle());
+#endif
+    unsynced = false;
+}
+
+void SessionJournal::closeSegment()
+{
+    if (!file.isOpen())
+        return;
+    syncSegment();
+    file.close();
+    QMutexLocker locker(&mutex);
+    closedSegments.append(file.fileName());
+}
+
+// --------------------- Чтение ---------------------
+
+bool SessionJournalReader::open(const QString& path)
+{
+    error.clear();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    char header[SessionJournalFormat::fileHeaderSize];
+    if (file.read(header, sizeof(header)) != qint64(sizeof(header))
+        || memcmp(header, SessionJournalFormat::magic, 4) != 0) {
+        error = "not a session journal";
+        return false;
+    }
+    const quint16 version = get<quint16>(header + 4);
+    if (version != SessionJournalFormat::version) {
+        error = QString("unsupported journal version %1").arg(version);
+        return false;
+    }
+    segmentIndex = int(get<quint32>(header + 8));
+    startMs = get<qint64>(header + 16);
+    origin = get<qint64>(header + 24);
+    return true;
+}
+
+bool SessionJournalReader::readNext(PipelineEvent& event)
+{
+    char record[SessionJournalFormat::valueRecordSize];
+    if (file.read(record, 1) != 1)
+        return false;
+    const int size = recordSize(quint8(record[0]));
+    if (size == 0) {
+        error = QString("unknown record type %1 at offset %2").arg(quint8(record[0])).arg(file.pos() - 1);
+        return false;
+    }
+    // Неполная запись в конце — сегмент оборван аварией; всё до неё годно
+    if (file.read(record + 1, size - 1) != size - 1)
+        return false;
+
+    event.type = PipelineEvent::Type(quint8(record[0]));
+    event.timestamp = get<qint64>(record + 1);
+    event.timeSec = double(event.timestamp - origin) / 1000.0;
+    if (event.type == PipelineEvent::Sample) {
+        event.value = get<qint32>(record + 9);
+        event.value2 = get<qint32>(record + 13);
+        event.value3 = get<qint16>(record + 17) / 100.0;
+    } else {
+        event.value = get<double>(record + 9);
+        event.value2 = get<double>(record + 17);
+        event.value3 = 0.0;
+    }
+    return true;
+}
@@ -0,0 +1,148 @@
+#ifndef SESSIONJOURNAL_H
+#define SESSIONJOURNAL_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include "pipelineEvent.h"
+#include "spscRingBuffer.h"
+
+// Непрерывная запись результатов сессии (отсчёты, пики, BPM, SpO₂) на диск по ходу приёма,
+// чтобы авария или отключение питания не уносили многочасовую сессию.
+// Поток обработки кладёт события в очередь без блокировок; поток записи копит их в буфере
+// и пишет крупными последовательными блоками, раз в syncIntervalMs делает fsync и начинает
+// новый файл (сегмент) по размеру или по времени. Экспорт закрывает текущий сегмент
+// и читает закрытые сегменты — они больше не меняются.
+//
+// Формат сегмента (little-endian):
+//   заголовок, 32 байта: magic "ESPJ" | version u16 | reserved u16 | segment u32 | reserved u32 |
+//                        startEpochMs i64 (настенное время начала сессии, одно во всех сегментах) |
+//                        originTimestamp i64 (время ESP32 начала сессии, мс)
+//   записи: type u8 | timestamp i64 | для Sample: IR i32, Red i32, Temp i16 (сотые доли градуса);
+//           для остальных: value f64, value2 f64
+namespace SessionJournalFormat {
+
+constexpr char magic[4] = { 'E', 'S', 'P', 'J' };
+constexpr quint16 version = 1;
+constexpr int fileHeaderSize = 32;
+constexpr int sampleRecordSize = 19;
+constexpr int valueRecordSize = 25;
+constexpr const char* suffix = ".espj";
+
+} // namespace SessionJournalFormat
+
+class SessionJournal : public QThread
+{
+    Q_OBJECT
+public:
+    struct Settings {
+        QString directory;                       // пусто — запись выключена
+        QString baseName;                        // сегменты: <baseName>_001.espj, _002, ...
+        int syncIntervalMs = 5000;               // fsync не реже; 0 — после каждой записи
+        qint64 maxSegmentBytes = 256ll << 20;    // новый сегмент по размеру...
+        int maxSegmentMinutes = 60;              // ...или по времени (0 — без ограничения)
+        int writeBufferBytes = 1 << 20;          // размер одной записи на диск
+        int flushIntervalMs = 1000;              // неполный буфер пишется не реже
+        qint64 startEpochMs = -1;                // настенное время начала сессии (из записи при
+                                                 // воспроизведении); -1 — часы хоста при первом событии
+    };
+
+    static constexpr int queueCapacity = 1 << 16;
+
+    explicit SessionJournal(const Settings& settings);
+    ~SessionJournal() override;
+
+    // Только поток обработки (единственный писатель очереди). Не ждёт диска:
+    // при переполнении очереди события теряются и учитываются в droppedEvents()
+    void append(const PipelineEvent* events, int count);
+
+    // Из любого другого потока: дописывает очередь, делает fsync и закрывает текущий сегмент.
+    // Возвращает все закрытые сегменты сессии; запись продолжится в следующий.
+    // Ждёт поток записи (до секунды при медленном диске) — для окна есть finalizeSegmentsAsync()
+    QStringList finalizeSegments();
+    // То же без ожидания: по готовности — segmentsFinalized() из потока записи
+    // (если поток уже остановлен — сразу, из вызывающего). Запросы до закрытия сегмента
+    // обслуживаются одним закрытием, и каждый получает сигнал
+    void finalizeSegmentsAsync();
+    void stop();
+
+    int pendingEvents() const { return queue.sizeApprox(); }
+    quint64 droppedEvents() const { return dropped.load(std::memory_order_relaxed); }
+    quint64 bytesWritten() const { return written.load(std::memory_order_relaxed); }
+    bool hasFailed() const { return failed.load(std::memory_order_relaxed); }
+
+signals:
+    // Все закрытые сегменты сессии, включая события, поставленные в очередь до запроса
+    void segmentsFinalized(const QStringList& segments);
+
+protected:
+    void run() override;
+
+private:
+    bool requestFinalize(quint64* ticket); // false — поток записи не работает, закрывать нечего
+    void drainQueue();
+    void encode(const PipelineEvent& event);
+    bool openSegment(const PipelineEvent& first);
+    void writeBuffer();
+    void syncSegment();
+    void closeSegment();
+
+    Settings settings;
+    SpscRingBuffer<PipelineEvent> queue;
+    std::atomic<quint64> dropped { 0 };
+    std::atomic<quint64> written { 0 };
+    std::atomic<bool> failed { false };
+
+    QMutex mutex;
+    QWaitCondition wake;
+    QWaitCondition finalized;
+    bool stopping = false;
+    bool writerDone = false;      // поток записи закрыл последний сегмент
+    quint64 finalizeTicket = 0;   // номер последнего запроса закрытия
+    quint64 finalizedTicket = 0;  // все запросы до этого номера выполнены
+    QStringList closedSegments; // под mutex
+
+    // Только поток записи
+    QFile file;
+    QByteArray buffer;
+    QVector<PipelineEvent> popped;
+    QElapsedTimer sinceWrite;
+    QElapsedTimer sinceSync;
+    QElapsedTimer segmentAge;
+    qint64 origin = 0;
+    qint64 sessionEpochMs = 0;
+    qint64 segmentBytes = 0;
+    int segmentIndex = 0;
+    bool unsynced = false;
+};
+
+// Чтение сегмента по записям; оборванная последняя запись (авария) считается концом файла
+class SessionJournalReader
+{
+public:
+    bool open(const QString& path);
+    void close() { file.close(); }
+
+    // timeSec восстанавливается от originTimestamp, как в SignalProcessor
+    bool readNext(PipelineEvent& event);
+
+    int segment() const { return segmentIndex; }
+    // Настенное время в момент originTimestamp() — начала сессии
+    qint64 startEpochMs() const { return startMs; }
+    qint64 originTimestamp() const { return origin; }
+    bool hasError() const { return !error.isEmpty(); }
+    QString errorString() const { return error; }
+
+private:
+    QFile file;
+    int segmentIndex = 0;
+    qint64 startMs = 0;
+    qint64 origin = 0;
+    QString error;
+};
+
+#endif // SESSIONJOURNAL_H
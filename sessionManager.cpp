@@ -0,0 +1,214 @@
+#include "sessionManager.h"
+#include "sessionView.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QSettings>
+#include <QTimer>
+
+Q_LOGGING_CATEGORY(lcSession, "esp32.session")
+
+SessionManager::SessionManager(QObject* parent)
+    : QObject(parent)
+{
+    // Одно ядро оставляем потоку GUI
+    maxThreads = qMax(1, QThread::idealThreadCount() - 1);
+
+    // GUI забирает результаты в своём темпе (~30 раз в секунду) и никогда не блокирует потоки обработки
+    QTimer *drainTimer = new QTimer(this);
+    connect(drainTimer, &QTimer::timeout, this, &SessionManager::drainAll);
+    drainTimer->start(33);
+
+    // Графики перерисовываются с фиксированной частотой кадров, а не на каждый блок событий
+    frameTimer = new QTimer(this);
+    connect(frameTimer, &QTimer::timeout, this, &SessionManager::renderAll);
+    setFrameRate(frameRateHz);
+}
+
+SessionManager::~SessionManager()
+{
+    // Рабочие объекты удаляются в своих потоках при их завершении (deleteLater)
+    for (QThread* thread : std::as_const(workerThreads)) {
+        thread->quit();
+        thread->wait();
+    }
+    qDeleteAll(workerThreads);
+    qDeleteAll(deviceSessions);
+}
+
+void SessionManager::loadFromSettings()
+{
+    QSettings settings("MyCompany", "MyApp");
+    recordDirectory = settings.value("recordDirectory").toString();
+    journalSettings.directory = settings.value("journalDirectory").toString();
+    journalSettings.syncIntervalMs = settings.value("journalSyncMs", journalSettings.syncIntervalMs).toInt();
+    journalSettings.maxSegmentBytes = settings.value("journalSegmentMiB", journalSettings.maxSegmentBytes >> 20)
+                                          .toLongLong() << 20;
+    journalSettings.maxSegmentMinutes = settings.value("journalSegmentMinutes",
+                                                       journalSettings.maxSegmentMinutes).toInt();
+    setFrameRate(settings.value("frameRateHz", frameRateHz).toInt());
+    stripCharts = settings.value("stripCharts", stripCharts).toBool();
+    const int size = settings.beginReadArray("devices");
+    for (int i = 0; i < size; ++i) {
+        settings.setArrayIndex(i);
+        DeviceSession::Config config;
+        config.host = settings.value("host").toString();
+        config.name = settings.value("name", config.host).toString();
+        config.port = static_cast<quint16>(settings.value("port", 80).toUInt());
+        // Необязательные параметры переподключения, по умолчанию — значения ConnectionManager::Settings
+        ConnectionManager::Settings& connection = config.connection;
+        connection.connectTimeoutMs = settings.value("connectTimeoutMs", connection.connectTimeoutMs).toInt();
+        connection.maxBackoffMs = settings.value("maxBackoffMs", connection.maxBackoffMs).toInt();
+        connection.stallTimeoutMs = settings.value("stallTimeoutMs", connection.stallTimeoutMs).toInt();
+        config.spo2WindowMs = settings.value("spo2WindowMs", config.spo2WindowMs).toInt();
+        BandPassFilter::Settings& filter = config.peakFilter;
+        filter.enabled = settings.value("peakFilter", filter.enabled).toBool();
+        filter.lowHz = settings.value("peakFilterLowHz", filter.lowHz).toDouble();
+        filter.highHz = settings.value("peakFilterHighHz", filter.highHz).toDouble();
+        filter.order = settings.value("peakFilterOrder", filter.order).toInt();
+        filter.movingAverage = settings.value("peakFilterMovingAverage", filter.movingAverage).toInt();
+        filter.derivative = settings.value("peakFilterDerivative", filter.derivative).toBool();
+        filter.sampleRateHz = settings.value("peakFilterSampleRateHz", filter.sampleRateHz).toDouble();
+        SpectralHeartRate::Settings& spectral = config.spectralHeartRate;
+        spectral.enabled = settings.value("spectralBpm", spectral.enabled).toBool();
+        spectral.windowMs = settings.value("spectralWindowMs", spectral.windowMs).toInt();
+        spectral.intervalMs = settings.value("spectralIntervalMs", spectral.intervalMs).toInt();
+        config.replayFile = settings.value("replayFile").toString();
+        config.replaySpeed = settings.value("replaySpeed", config.replaySpeed).toDouble();
+        if (!config.host.isEmpty())
+            addSession(config);
+    }
+    settings.endArray();
+
+    if (deviceSessions.isEmpty()) {
+        DeviceSession::Config config;
+        config.name = "ESP32";
+        config.host = settings.value("ipAddress", "192.168.31.222").toString();
+        addSession(config);
+    }
+}
+
+void SessionManager::saveToSettings() const
+{
+    QSettings settings("MyCompany", "MyApp");
+    settings.setValue("frameRateHz", frameRateHz);
+    settings.setValue("stripCharts", stripCharts);
+    settings.beginWriteArray("devices", deviceSessions.size());
+    for (int i = 0; i < deviceSessions.size(); ++i) {
+        const DeviceSession::Config& config = deviceSessions[i]->config();
+        settings.setArrayIndex(i);
+        settings.setValue("name", config.name);
+        settings.setValue("host", config.host);
+        settings.setValue("port", config.port);
+        settings.setValue("connectTimeoutMs", config.connection.connectTimeoutMs);
+        settings.setValue("maxBackoffMs", config.connection.maxBackoffMs);
+        settings.setValue("stallTimeoutMs", config.connection.stallTimeoutMs);
+        settings.setValue("spo2WindowMs", config.spo2WindowMs);
+        settings.setValue("peakFilter", config.peakFilter.enabled);
+        settings.setValue("peakFilterLowHz", config.peakFilter.lowHz);
+        settings.setValue("peakFilterHighHz", config.peakFilter.highHz);
+        settings.setValue("peakFilterOrder", config.peakFilter.order);
+        settings.setValue("peakFilterMovingAverage", config.peakFilter.movingAverage);
+        settings.setValue("peakFilterDerivative", config.peakFilter.derivative);
+        settings.setValue("peakFilterSampleRateHz", config.peakFilter.sampleRateHz);
+        settings.setValue("spectralBpm", config.spectralHeartRate.enabled);
+        settings.setValue("spectralWindowMs", config.spectralHeartRate.windowMs);
+        settings.setValue("spectralIntervalMs", config.spectralHeartRate.intervalMs);
+        if (!config.replayFile.isEmpty()) {
+            settings.setValue("replayFile", config.replayFile);
+            settings.setValue("replaySpeed", config.replaySpeed);
+        }
+    }
+    settings.endArray();
+}
+
+QString SessionManager::fileStem(const QString& deviceName)
+{
+    QString name = deviceName;
+    for (QChar& c : name) {
+        if (!c.isLetterOrNumber())
+            c = '_';
+    }
+    return QString("%1_%2").arg(name, QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+}
+
+QString SessionManager::recordingPath(const QString& deviceName) const
+{
+    QDir dir(recordDirectory);
+    if (!dir.exists())
+        dir.mkpath(".");
+    return dir.absoluteFilePath(fileStem(deviceName) + ".esprec");
+}
+
+DeviceSession* SessionManager::addSession(const DeviceSession::Config& sessionConfig)
+{
+    // Живые устройства записываются, если в настройках задан каталог записей
+    DeviceSession::Config config = sessionConfig;
+    if (!recordDirectory.isEmpty() && config.replayFile.isEmpty() && config.recordFile.isEmpty())
+        config.recordFile = recordingPath(config.name);
+    // Результаты обработки — для всех сессий, включая воспроизведение: экспорт берёт их с диска
+    if (!journalSettings.directory.isEmpty() && config.journal.directory.isEmpty()) {
+        config.journal = journalSettings;
+        config.journal.baseName = fileStem(config.name);
+    }
+
+    DeviceSession* session = new DeviceSession(config, this);
+    deviceSessions.append(session);
+    session->view()->setStripCharts(stripCharts);
+
+    QThread* thread = pickThread();
+    IngestWorker* worker = session->worker();
+    worker->moveToThread(thread);
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+    QMetaObject::invokeMethod(worker, &IngestWorker::start, Qt::QueuedConnection);
+
+    qCInfo(lcSession) << "Session" << config.name << "(" << config.host << ") assigned to" << thread->objectName();
+    emit sessionAdded(session);
+    return session;
+}
+
+QThread* SessionManager::pickThread()
+{
+    // Новый поток, пока не достигнут предел пула, иначе — наименее загруженный
+    if (workerThreads.size() < maxThreads) {
+        QThread* thread = new QThread();
+        thread->setObjectName(QString("ingest-%1").arg(workerThreads.size()));
+        thread->start();
+        workerThreads.append(thread);
+        threadLoad.append(1);
+        return thread;
+    }
+    int best = 0;
+    for (int i = 1; i < threadLoad.size(); ++i) {
+        if (threadLoad[i] < threadLoad[best])
+            best = i;
+    }
+    ++threadLoad[best];
+    return workerThreads[best];
+}
+
+void SessionManager::drainAll()
+{
+    for (DeviceSession* session : std::as_const(deviceSessions))
+        session->drain();
+}
+
+void SessionManager::renderAll()
+{
+    for (DeviceSession* session : std::as_const(deviceSessions))
+        session->render();
+}
+
+void SessionManager::setFrameRate(int hz)
+{
+    frameRateHz = qBound(1, hz, 120);
+    frameTimer->start(1000 / frameRateHz);
+}
+
+void SessionManager::setStripCharts(bool enabled)
+{
+    stripCharts = enabled;
+    for (DeviceSession* session : std::as_const(deviceSessions))
+        session->view()->setStripCharts(enabled);
+}
+
@@ -0,0 +1,67 @@
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+
+#include <QLoggingCategory>
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include "deviceSession.h"
+
+class QTimer;
+
+// Сообщения о сессиях и настройках (MainWindow, SessionManager)
+Q_DECLARE_LOGGING_CATEGORY(lcSession)
+
+// Набор независимых сессий устройств. Приём и обработка сессий распределяются по пулу потоков
+// (не больше числа ядер); у каждой сессии свой сокет, декодер, DSP и кольцевой буфер,
+// поэтому медленное или неисправное устройство не задерживает остальные.
+class SessionManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SessionManager(QObject* parent = nullptr);
+    ~SessionManager();
+
+    //! Список устройств из QSettings (массив "devices", при его отсутствии — "ipAddress")
+    //! Устройство с ключом "replayFile" воспроизводит запись вместо подключения
+    void loadFromSettings();
+    void saveToSettings() const;
+
+    DeviceSession* addSession(const DeviceSession::Config& config);
+
+    int sessionCount() const { return deviceSessions.size(); }
+    DeviceSession* session(int index) const { return deviceSessions.value(index, nullptr); }
+    int threadCount() const { return workerThreads.size(); }
+
+    //! Частота кадров графиков ("frameRateHz" в QSettings, по умолчанию 30); не зависит от частоты отсчётов
+    void setFrameRate(int hz);
+    int frameRate() const { return frameRateHz; }
+    //! Самописцы вместо Qt Charts во всех сессиях ("stripCharts" в QSettings)
+    void setStripCharts(bool enabled);
+    bool usesStripCharts() const { return stripCharts; }
+
+signals:
+    void sessionAdded(DeviceSession* session);
+
+private slots:
+    void drainAll();
+    void renderAll();
+
+private:
+    QThread* pickThread();
+    QString recordingPath(const QString& deviceName) const;
+    static QString fileStem(const QString& deviceName);
+
+    QVector<DeviceSession*> deviceSessions;
+    QVector<QThread*> workerThreads;
+    QVector<int> threadLoad; // число сессий в каждом потоке
+    int maxThreads;
+    QTimer* frameTimer;
+    int frameRateHz = 30;
+    bool stripCharts = false;
+    QString recordDirectory; // "recordDirectory" в QSettings: сырые потоки всех устройств пишутся сюда
+    // "journalDirectory" и др. в QSettings: результаты обработки пишутся на диск по ходу сессии
+    SessionJournal::Settings journalSettings;
+};
+
+#endif // SESSIONMANAGER_H
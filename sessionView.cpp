@@ -0,0 +1,471 @@
+#include "sessionView.h"
+#include "traceSpans.h"
+
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QStackedWidget>
+#include <QWheelEvent>
+#include <algorithm>
+
+namespace {
+const double minimumSpanSec = 5.0;
+const double liveSpanSec = 20.0;
+
+// Ось Y по размаху огибающей с небольшим запасом
+void fitAxisY(QLineSeries *series, QValueAxis *axis)
+{
+    const auto points = series->points();
+    if (points.isEmpty())
+        return;
+    double low = points.first().y();
+    double high = low;
+    for (const QPointF &p : points) {
+        low = qMin(low, p.y());
+        high = qMax(high, p.y());
+    }
+    const double margin = qMax(1.0, (high - low) * 0.05);
+    axis->setRange(low - margin, high + margin);
+}
+}
+
+SessionView::SessionView(DataProcessor *dataProcessor, QLabel *averageMinuteBpmLabel, QWidget *parent)
+    : QWidget(parent)
+    , dataProcessor(dataProcessor)
+    , averageMinuteBpmLabel(averageMinuteBpmLabel)
+{
+    // Создаем серии для динамических порогов
+    thresholdSeriesIR = new QLineSeries(this);
+    thresholdSeriesIR->setName("Dynamic Threshold");
+    thresholdSeriesRED = new QLineSeries(this);
+    thresholdSeriesRED->setName("Dynamic Threshold");
+
+    // Инициализируем графики
+    redChartView         = new QChartView(this);
+    infraredChartView    = new QChartView(this);
+    beatsPerMinuteChartView = new QChartView(this);
+    averageBpmChartView  = new QChartView(this);
+    temperatureChartView = new QChartView(this);
+    spo2ChartView        = new QChartView(this);
+
+    {
+        QChart *redChart = new QChart();
+        redChart->legend()->setVisible(false);
+        redChart->setTitle("Red Data");
+        QValueAxis* axisRedXPtr = dataProcessor->getRedAxisX();
+        axisRedXPtr->setTitleText("Time (s)");
+        axisRedXPtr->setRange(0, 300);
+        redChart->addAxis(axisRedXPtr, Qt::AlignBottom);
+
+        redAxisY = new QValueAxis();
+        redAxisY->setTitleText("Red Value");
+        redAxisY->setRange(20000, 30000);
+        redChart->addAxis(redAxisY, Qt::AlignLeft);
+
+        redChart->addSeries(dataProcessor->getRedSeries());
+        dataProcessor->getRedSeries()->attachAxis(axisRedXPtr);
+        dataProcessor->getRedSeries()->attachAxis(redAxisY);
+
+        redChart->addSeries(thresholdSeriesRED);
+        thresholdSeriesRED->attachAxis(axisRedXPtr);
+        thresholdSeriesRED->attachAxis(redAxisY);
+
+        redChartView->setChart(redChart);
+    }
+
+    {
+        QChart *irChart = new QChart();
+        irChart->legend()->setVisible(false);
+        irChart->setTitle("Infrared (IR) Data");
+        QValueAxis *axisIrXPtr = dataProcessor->getIrAxisX();
+        axisIrXPtr->setTitleText("Time (s)");
+        axisIrXPtr->setRange(0, 300);
+        irChart->addAxis(axisIrXPtr, Qt::AlignBottom);
+
+        infraredAxisY = new QValueAxis();
+        infraredAxisY->setTitleText("IR Value");
+        infraredAxisY->setRange(95000, 110000);
+        irChart->addAxis(infraredAxisY, Qt::AlignLeft);
+
+        // Основная серия IR
+        irChart->addSeries(dataProcessor->getIRSeries());
+        dataProcessor->getIRSeries()->attachAxis(axisIrXPtr);
+        dataProcessor->getIRSeries()->attachAxis(infraredAxisY);
+
+        // Пороговая серия (если используется)
+        irChart->addSeries(thresholdSeriesIR);
+        thresholdSeriesIR->attachAxis(axisIrXPtr);
+        thresholdSeriesIR->attachAxis(infraredAxisY);
+
+        // Добавляем серию пиков (красные точки)
+        irChart->addSeries(dataProcessor->getPeakSeries());
+        dataProcessor->getPeakSeries()->attachAxis(axisIrXPtr);
+        dataProcessor->getPeakSeries()->attachAxis(infraredAxisY);
+
+        infraredChartView->setChart(irChart);
+    }
+
+
+    {
+        QChart *bpmChart = new QChart();
+        bpmChart->legend()->setVisible(false);
+        bpmChart->setTitle("Beats Per Minute");
+        QValueAxis *axisBpmXPtr = dataProcessor->getBpmAxisX();
+        axisBpmXPtr->setTitleText("Time (s)");
+        axisBpmXPtr->setRange(0, 300);
+        bpmChart->addAxis(axisBpmXPtr, Qt::AlignBottom);
+
+        QValueAxis *bpmAxisY = new QValueAxis();
+        bpmAxisY->setTitleText("BPM Value");
+        bpmAxisY->setRange(50, 140);
+        bpmChart->addAxis(bpmAxisY, Qt::AlignLeft);
+
+        bpmChart->addSeries(dataProcessor->getBPMSeries());
+        dataProcessor->getBPMSeries()->attachAxis(axisBpmXPtr);
+        dataProcessor->getBPMSeries()->attachAxis(bpmAxisY);
+
+        // BPM по спектру IR — рядом с BPM по интервалам между пиками
+        QLineSeries *spectralSeries = dataProcessor->getSpectralBpmSeries();
+        spectralSeries->setName("Spectral BPM");
+        spectralSeries->setColor(Qt::darkMagenta);
+        bpmChart->addSeries(spectralSeries);
+        spectralSeries->attachAxis(axisBpmXPtr);
+        spectralSeries->attachAxis(bpmAxisY);
+
+        beatsPerMinuteChartView->setChart(bpmChart);
+    }
+
+    {
+        QChart *avgBpmChart = new QChart();
+        avgBpmChart->legend()->setVisible(false);
+        avgBpmChart->setTitle("Average BPM");
+        QValueAxis *axisAvgBpmXPtr = dataProcessor->getAvgBpmAxisX();
+        axisAvgBpmXPtr->setTitleText("Time (s)");
+        axisAvgBpmXPtr->setRange(0, 300);
+        avgBpmChart->addAxis(axisAvgBpmXPtr, Qt::AlignBottom);
+
+        QValueAxis *avgBpmAxisY = new QValueAxis();
+        avgBpmAxisY->setTitleText("Avg BPM");
+        avgBpmAxisY->setRange(50, 140);
+        avgBpmChart->addAxis(avgBpmAxisY, Qt::AlignLeft);
+
+        avgBpmChart->addSeries(dataProcessor->getAvgBPMSeries());
+        dataProcessor->getAvgBPMSeries()->attachAxis(axisAvgBpmXPtr);
+        dataProcessor->getAvgBPMSeries()->attachAxis(avgBpmAxisY);
+
+        averageBpmChartView->setChart(avgBpmChart);
+    }
+
+    {
+        QChart *tempChart = new QChart();
+        tempChart->legend()->setVisible(false);
+        tempChart->setTitle("Temperature Data");
+        QValueAxis *axisTempXPtr = dataProcessor->getTempAxisX();
+        axisTempXPtr->setTitleText("Time (s)");
+        axisTempXPtr->setRange(0, 300);
+        tempChart->addAxis(axisTempXPtr, Qt::AlignBottom);
+
+        QValueAxis *tempAxisY = new QValueAxis();
+        tempAxisY->setTitleText("Temp. (°C)");
+        tempAxisY->setRange(25, 38);
+        tempChart->addAxis(tempAxisY, Qt::AlignLeft);
+
+        tempChart->addSeries(dataProcessor->getTempSeries());
+        dataProcessor->getTempSeries()->attachAxis(axisTempXPtr);
+        dataProcessor->getTempSeries()->attachAxis(tempAxisY);
+
+        temperatureChartView->setChart(tempChart);
+    }
+
+    {
+        QChart *spo2Chart = new QChart();
+        spo2Chart->legend()->setVisible(false);
+        spo2Chart->setTitle("SpO₂ Data");
+        QValueAxis *axisSpo2XPtr = dataProcessor->getSpo2AxisX();
+        axisSpo2XPtr->setTitleText("Time (s)");
+        axisSpo2XPtr->setRange(0, 300);
+        spo2Chart->addAxis(axisSpo2XPtr, Qt::AlignBottom);
+
+        QValueAxis *spo2AxisY = new QValueAxis();
+        spo2AxisY->setTitleText("SpO₂ (%)");
+        spo2AxisY->setRange(90, 105);
+        spo2Chart->addAxis(spo2AxisY, Qt::AlignLeft);
+
+        spo2Chart->addSeries(dataProcessor->getSpo2Series());
+        spo2Chart->addSeries(dataProcessor->getSpo2PeakSeries());
+        dataProcessor->getSpo2Series()->setColor(Qt::blue);
+        dataProcessor->getSpo2PeakSeries()->setColor(Qt::darkGreen);
+        dataProcessor->getSpo2Series()->attachAxis(axisSpo2XPtr);
+        dataProcessor->getSpo2Series()->attachAxis(spo2AxisY);
+        dataProcessor->getSpo2PeakSeries()->attachAxis(axisSpo2XPtr);
+        dataProcessor->getSpo2PeakSeries()->attachAxis(spo2AxisY);
+
+        spo2ChartView->setChart(spo2Chart);
+    }
+
+    QWidget *chartsPage = new QWidget(this);
+    QGridLayout *chartsLayout = new QGridLayout(chartsPage);
+    chartsLayout->setContentsMargins(0, 0, 0, 0);
+    chartsLayout->addWidget(redChartView,            0, 0);
+    chartsLayout->addWidget(infraredChartView,       0, 1);
+    chartsLayout->addWidget(beatsPerMinuteChartView, 1, 0);
+    chartsLayout->addWidget(averageBpmChartView,     1, 1);
+    chartsLayout->addWidget(temperatureChartView,    2, 0);
+    chartsLayout->addWidget(spo2ChartView,           2, 1);
+
+    // Те же шесть графиков самописцами — для высоких частот отсчётов, только живой режим
+    redStrip         = new StripChart("Red Data", this);
+    infraredStrip    = new StripChart("Infrared (IR) Data", this);
+    bpmStrip         = new StripChart("Beats Per Minute", this);
+    averageBpmStrip  = new StripChart("Average BPM", this);
+    temperatureStrip = new StripChart("Temperature Data", this);
+    spo2Strip        = new StripChart("SpO₂ Data", this);
+    redStrip->setAutoRange(400);
+    infraredStrip->setAutoRange(1000);
+    infraredStrip->setMarkerColor(Qt::red);
+    bpmStrip->setValueRange(50, 140);
+    bpmStrip->setMarkerColor(Qt::darkMagenta); // BPM по спектру
+    averageBpmStrip->setValueRange(50, 140);
+    temperatureStrip->setValueRange(25, 38);
+    spo2Strip->setValueRange(90, 105);
+    spo2Strip->setMarkerColor(Qt::darkGreen);
+
+    QWidget *stripPage = new QWidget(this);
+    QGridLayout *stripLayout = new QGridLayout(stripPage);
+    stripLayout->setContentsMargins(0, 0, 0, 0);
+    stripLayout->addWidget(redStrip,         0, 0);
+    stripLayout->addWidget(infraredStrip,    0, 1);
+    stripLayout->addWidget(bpmStrip,         1, 0);
+    stripLayout->addWidget(averageBpmStrip,  1, 1);
+    stripLayout->addWidget(temperatureStrip, 2, 0);
+    stripLayout->addWidget(spo2Strip,        2, 1);
+
+    chartPages = new QStackedWidget(this);
+    chartPages->addWidget(chartsPage);
+    chartPages->addWidget(stripPage);
+
+    QGridLayout *layout = new QGridLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(chartPages,            0, 0, 1, 2);
+    layout->addWidget(averageMinuteBpmLabel, 3, 0, 1, 2);
+
+    // Навигация по истории: полоса прокрутки в секундах и кнопка живого режима
+    historyScrollBar = new QScrollBar(Qt::Horizontal, this);
+    historyScrollBar->setRange(0, 0);
+    liveButton = new QPushButton("Live", this);
+    liveButton->setCheckable(true);
+    liveButton->setChecked(true);
+    QHBoxLayout *navigationLayout = new QHBoxLayout();
+    navigationLayout->addWidget(historyScrollBar, 1);
+    navigationLayout->addWidget(liveButton);
+    layout->addLayout(navigationLayout, 4, 0, 1, 2);
+
+    connect(liveButton, &QPushButton::toggled, this, &SessionView::setLive);
+    connect(historyScrollBar, &QScrollBar::valueChanged, this, [this](int value) {
+        if (!this->dataProcessor->followsLive())
+            showHistoryAt(value);
+    });
+    // Перемещение ползунка в живом режиме — переход к просмотру истории
+    connect(historyScrollBar, &QScrollBar::sliderPressed, this, [this]() {
+        liveButton->setChecked(false);
+    });
+
+    for (QChartView *view : { redChartView, infraredChartView, beatsPerMinuteChartView,
+                              averageBpmChartView, temperatureChartView, spo2ChartView })
+        view->viewport()->installEventFilter(this);
+}
+
+void SessionView::render()
+{
+    if (stripCharts) {
+        TRACE_SPAN("StripChart::updateIfChanged");
+        for (StripChart *strip : { redStrip, infraredStrip, bpmStrip, averageBpmStrip, temperatureStrip, spo2Strip })
+            strip->updateIfChanged();
+        return;
+    }
+    updateNavigation();
+    // Один столбец огибающей на пиксель области построения
+    const int columns = qMax(1, int(infraredChartView->chart()->plotArea().width()));
+    if (!dataProcessor->render(columns))
+        return;
+
+    // Оси Y — один раз за кадр: в истории по размаху показанного интервала,
+    // в живом режиме — вокруг среднего последних 10 отсчётов
+    TRACE_SPAN("axis Y range");
+    if (!dataProcessor->followsLive()) {
+        fitAxisY(dataProcessor->getIRSeries(), infraredAxisY);
+        fitAxisY(dataProcessor->getRedSeries(), redAxisY);
+        return;
+    }
+    const SampleStore &samples = dataProcessor->history().samples();
+    const int lastCount = 10;
+    if (samples.size() < lastCount)
+        return;
+    double sumIr = 0.0;
+    double sumRed = 0.0;
+    samples.forEach(samples.size() - lastCount, samples.size(), [&](const SampleStore::Row &row) {
+        sumIr += row.ir;
+        sumRed += row.red;
+    });
+    const double avgIr = sumIr / lastCount;
+    const double avgRed = sumRed / lastCount;
+    infraredAxisY->setRange(avgIr - 500, avgIr + 500);
+    redAxisY->setRange(avgRed - 200, avgRed + 200);
+}
+
+void SessionView::updateNavigation()
+{
+    const double total = dataProcessor->getElapsedTime();
+    const double span = dataProcessor->followsLive() ? liveSpanSec : historySpanSec;
+    const QSignalBlocker blocker(historyScrollBar);
+    historyScrollBar->setRange(0, qMax(0, int(total - span)));
+    historyScrollBar->setPageStep(qMax(1, int(span)));
+    if (dataProcessor->followsLive())
+        historyScrollBar->setValue(historyScrollBar->maximum());
+}
+
+bool SessionView::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() != QEvent::Wheel)
+        return QWidget::eventFilter(watched, event);
+
+    QChartView *view = qobject_cast<QChartView *>(watched->parent());
+    if (!view)
+        return false;
+    QWheelEvent *wheel = static_cast<QWheelEvent *>(event);
+    if (wheel->angleDelta().y() == 0)
+        return false;
+
+    // Время под курсором — центр масштабирования; ось X у всех графиков общая
+    QChart *chart = view->chart();
+    const QPointF chartPos = chart->mapFromScene(view->mapToScene(wheel->position().toPoint()));
+    const double centerSec = chart->mapToValue(chartPos).x();
+    if (dataProcessor->followsLive()) {
+        QValueAxis *axis = dataProcessor->getIrAxisX();
+        historyFromSec = axis->min();
+        historySpanSec = axis->max() - axis->min();
+        liveButton->setChecked(false);
+    }
+    zoomHistory(centerSec, wheel->angleDelta().y() > 0 ? 0.8 : 1.25);
+    return true;
+}
+
+void SessionView::setLive(bool live)
+{
+    if (live) {
+        dataProcessor->setFollowLive(true);
+        return;
+    }
+    // Вход в историю с того же окна, что было на экране
+    QValueAxis *axis = dataProcessor->getIrAxisX();
+    historyFromSec = axis->min();
+    historySpanSec = axis->max() - axis->min();
+    dataProcessor->setFollowLive(false);
+    showHistoryAt(historyFromSec);
+}
+
+void SessionView::showHistoryAt(double fromSec)
+{
+    const double total = dataProcessor->getElapsedTime();
+    historyFromSec = qBound(0.0, fromSec, qMax(0.0, total - historySpanSec));
+    // Графики перестроит ближайший кадр render()
+    dataProcessor->setHistoryRange(historyFromSec, historyFromSec + historySpanSec);
+    updateNavigation();
+    const QSignalBlocker blocker(historyScrollBar);
+    historyScrollBar->setValue(qRound(historyFromSec));
+}
+
+void SessionView::zoomHistory(double centerSec, double factor)
+{
+    const double total = dataProcessor->getElapsedTime();
+    const double span = qBound(minimumSpanSec, historySpanSec * factor, qMax(minimumSpanSec, total));
+    // Точка под курсором остаётся на месте
+    const double fromSec = centerSec - (centerSec - historyFromSec) * span / historySpanSec;
+    historySpanSec = span;
+    showHistoryAt(fromSec);
+}
+
+void SessionView::setStripCharts(bool enabled)
+{
+    if (enabled == stripCharts)
+        return;
+    stripCharts = enabled;
+    chartPages->setCurrentIndex(enabled ? 1 : 0);
+    // Самописцы показывают только живой поток; прокрутка истории — у графиков Qt Charts
+    historyScrollBar->setVisible(!enabled);
+    liveButton->setVisible(!enabled);
+    liveButton->setChecked(true);
+    if (enabled)
+        fillStripCharts();
+}
+
+void SessionView::fillStripCharts()
+{
+    // Последнее окно самописцев — из накопленной истории
+    const SessionHistory &history = dataProcessor->history();
+    const double toSec = history.getElapsedTime();
+    const double fromSec = toSec - liveSpanSec;
+    for (StripChart *strip : { redStrip, infraredStrip, bpmStrip, averageBpmStrip, temperatureStrip, spo2Strip }) {
+        strip->setTimeSpan(liveSpanSec);
+        strip->clear();
+    }
+
+    const SampleStore &samples = history.samples();
+    const qint64 origin = history.getStartTime();
+    samples.forEach(samples.lowerBound(origin + qint64(fromSec * 1000.0)), samples.size(),
+                    [&](const SampleStore::Row &row) {
+        const double t = (row.time - origin) / 1000.0;
+        redStrip->addSample(t, row.red);
+        infraredStrip->addSample(t, row.ir);
+        temperatureStrip->addSample(t, row.temp);
+    });
+    const auto addPoints = [fromSec](const QVector<QPointF> &points, StripChart *strip, bool markers) {
+        const auto byX = [](const QPointF &p, double x) { return p.x() < x; };
+        for (auto it = std::lower_bound(points.begin(), points.end(), fromSec, byX); it != points.end(); ++it) {
+            if (markers)
+                strip->addMarker(it->x(), it->y());
+            else
+                strip->addSample(it->x(), it->y());
+        }
+    };
+    addPoints(dataProcessor->peaks(), infraredStrip, true);
+    addPoints(history.getAllBpmData(), bpmStrip, false);
+    addPoints(history.getAllSpectralBpmData(), bpmStrip, true);
+    addPoints(history.getAllAvgBpmData(), averageBpmStrip, false);
+    const SeriesStore &spo2 = history.getAllSpo2Data();
+    spo2.forEach(spo2.lowerBound(fromSec), spo2.size(), [this](const QPointF &p) { spo2Strip->addSample(p.x(), p.y()); });
+    addPoints(history.getAllSpo2PeakData(), spo2Strip, true);
+}
+
+void SessionView::appendLive(const PipelineEvent *events, const double *sessionTimes, int count)
+{
+    if (!stripCharts)
+        return;
+    for (int i = 0; i < count; ++i) {
+        const PipelineEvent &event = events[i];
+        // Время сессии, а не ESP32: после перезапуска платы самописец не отбрасывает новые точки
+        const double t = sessionTimes[i];
+        switch (event.type) {
+        case PipelineEvent::Sample:
+            infraredStrip->addSample(t, event.value);
+            redStrip->addSample(t, event.value2);
+            temperatureStrip->addSample(t, event.value3);
+            break;
+        case PipelineEvent::Spo2:
+            spo2Strip->addSample(t, event.value);
+            break;
+        case PipelineEvent::Peak:
+            infraredStrip->addMarker(t, event.value);
+            break;
+        case PipelineEvent::Bpm:
+            bpmStrip->addSample(t, event.value);
+            averageBpmStrip->addSample(t, event.value2);
+            break;
+        case PipelineEvent::Spo2Peak:
+            spo2Strip->addMarker(t, event.value);
+            break;
+        case PipelineEvent::SpectralBpm:
+            bpmStrip->addMarker(t, event.value);
+            break;
+        }
+    }
+}
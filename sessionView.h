@@ -0,0 +1,79 @@
+#ifndef SESSIONVIEW_H
+#define SESSIONVIEW_H
+
+#include <QWidget>
+#include <QLabel>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QStackedWidget>
+#include <QtCharts/QChartView>
+#include "dataProcessor.h"
+#include "stripChart.h"
+
+// Шесть графиков одного устройства (Red, IR, BPM, средний BPM, температура, SpO₂)
+class SessionView : public QWidget
+{
+    Q_OBJECT
+public:
+    SessionView(DataProcessor *dataProcessor, QLabel *averageMinuteBpmLabel, QWidget *parent = nullptr);
+
+    //! Кадр отрисовки (таймер кадров SessionManager): серии, оси и полоса прокрутки
+    void render();
+    //! Самописцы StripChart вместо Qt Charts (переключается на ходу)
+    void setStripCharts(bool enabled);
+    bool usesStripCharts() const { return stripCharts; }
+    //! Новые события для самописцев (при каждом заборе из кольцевого буфера);
+    //! sessionTimes — их время на оси сессии (DataProcessor::applyEvents), как при fillStripCharts
+    void appendLive(const PipelineEvent *events, const double *sessionTimes, int count);
+
+protected:
+    //! Колесо мыши над любым графиком — масштаб по времени вокруг курсора
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    //! Диапазон полосы прокрутки по длительности сессии
+    void updateNavigation();
+    void setLive(bool live);
+    void showHistoryAt(double fromSec);
+    void zoomHistory(double centerSec, double factor);
+    void fillStripCharts();
+
+    DataProcessor *dataProcessor;
+
+    // Виджеты-графики
+    QChartView *redChartView;
+    QChartView *infraredChartView;
+    QChartView *beatsPerMinuteChartView;
+    QChartView *averageBpmChartView;
+    QChartView *temperatureChartView;
+    QChartView *spo2ChartView;
+
+    // Самописцы — те же шесть графиков
+    QStackedWidget *chartPages;
+    StripChart *redStrip;
+    StripChart *infraredStrip;
+    StripChart *bpmStrip;
+    StripChart *averageBpmStrip;
+    StripChart *temperatureStrip;
+    StripChart *spo2Strip;
+    bool stripCharts = false;
+
+    // Оси Y
+    QValueAxis *infraredAxisY;
+    QValueAxis *redAxisY;
+
+    //! Линия динамического порога
+    QLineSeries *thresholdSeriesIR;
+    QLineSeries *thresholdSeriesRED;
+
+    //! Просмотр всей сессии: прокрутка по времени и возврат к живому режиму
+    QScrollBar *historyScrollBar;
+    QPushButton *liveButton;
+    double historyFromSec = 0.0;
+    double historySpanSec = 20.0;
+
+    //! Метка для среднего BPM за 1 мин.
+    QLabel *averageMinuteBpmLabel;
+};
+
+#endif // SESSIONVIEW_H
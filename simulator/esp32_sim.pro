@@ -0,0 +1,17 @@
+QT = core network
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = esp32_sim
+
+# Кодер двоичных кадров и SensorSample — общие с приложением
+include(../ingest.pri)
+
+SOURCES += \
+    main.cpp \
+    ppgGenerator.cpp \
+    simulatedDevice.cpp
+
+HEADERS += \
+    ppgGenerator.h \
+    simulatedDevice.h
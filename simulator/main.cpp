@@ -0,0 +1,87 @@
+#include "simulatedDevice.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QTimer>
+
+// Эмулятор ESP32 с MAX30102 для нагрузочных замеров без реального устройства.
+// Пример: esp32_sim --devices 8 --port 9000 --rate 400 --malformed 0.001 --dropouts 0.5
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("esp32_sim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Streams synthetic MAX30102 PPG data over TCP like the ESP32 firmware.");
+    parser.addHelpOption();
+    const QCommandLineOption portOption("port", "First TCP port; device N listens on port+N.", "port", "8080");
+    const QCommandLineOption devicesOption("devices", "Number of simulated devices.", "count", "1");
+    const QCommandLineOption rateOption("rate", "Sample rate, Hz (25 to several thousand).", "hz", "100");
+    const QCommandLineOption hrOption("hr", "Heart rate, beats per minute.", "bpm", "72");
+    const QCommandLineOption hrStepOption("hr-step", "Heart rate increment per device.", "bpm", "0");
+    const QCommandLineOption spo2Option("spo2", "Target SpO2, percent.", "percent", "97");
+    const QCommandLineOption noiseOption("noise", "White noise RMS, ADC counts.", "counts", "10");
+    const QCommandLineOption driftOption("drift", "Baseline drift amplitude, ADC counts.", "counts", "300");
+    const QCommandLineOption binaryOption("binary", "Send binary frames instead of CSV lines.");
+    const QCommandLineOption tickOption("tick-ms", "Send interval, ms.", "ms", "10");
+    const QCommandLineOption epochOption("epoch-timestamps",
+                                         "Use host Unix time (ms) as sample timestamps to measure end-to-end latency.");
+    const QCommandLineOption malformedOption("malformed", "Fraction of corrupted lines/frames.", "fraction", "0");
+    const QCommandLineOption dropoutsOption("dropouts", "Connection dropouts per minute.", "rate", "0");
+    const QCommandLineOption dropoutMsOption("dropout-ms", "Dropout duration, ms.", "ms", "3000");
+    const QCommandLineOption stallsOption("stalls", "Stalls (connected, no data) per minute.", "rate", "0");
+    const QCommandLineOption stallMsOption("stall-ms", "Stall duration, ms.", "ms", "15000");
+    const QCommandLineOption seedOption("seed", "Random seed (same seed - same signal).", "seed", "1");
+    parser.addOptions({ portOption, devicesOption, rateOption, hrOption, hrStepOption, spo2Option, noiseOption,
+                        driftOption, binaryOption, tickOption, epochOption, malformedOption, dropoutsOption,
+                        dropoutMsOption, stallsOption, stallMsOption, seedOption });
+    parser.process(app);
+
+    const int devices = qMax(1, parser.value(devicesOption).toInt());
+    const int basePort = parser.value(portOption).toInt();
+
+    QList<SimulatedDevice*> simulated;
+    for (int i = 0; i < devices; ++i) {
+        SimulatedDevice::Settings settings;
+        settings.port = static_cast<quint16>(basePort + i);
+        settings.binary = parser.isSet(binaryOption);
+        settings.tickMs = qMax(1, parser.value(tickOption).toInt());
+        settings.epochTimestamps = parser.isSet(epochOption);
+
+        PpgGenerator::Settings& signal = settings.signal;
+        signal.sampleRateHz = qBound(1.0, parser.value(rateOption).toDouble(), 100000.0);
+        signal.heartRateBpm = parser.value(hrOption).toDouble() + i * parser.value(hrStepOption).toDouble();
+        signal.spo2Percent = parser.value(spo2Option).toDouble();
+        signal.noise = parser.value(noiseOption).toDouble();
+        signal.driftAmplitude = parser.value(driftOption).toDouble();
+        signal.seed = parser.value(seedOption).toUInt() + i;
+
+        SimulatedDevice::Faults& faults = settings.faults;
+        faults.malformedProbability = parser.value(malformedOption).toDouble();
+        faults.dropoutsPerMinute = parser.value(dropoutsOption).toDouble();
+        faults.dropoutMs = parser.value(dropoutMsOption).toInt();
+        faults.stallsPerMinute = parser.value(stallsOption).toDouble();
+        faults.stallMs = parser.value(stallMsOption).toInt();
+
+        SimulatedDevice* device = new SimulatedDevice(settings, &app);
+        if (!device->start())
+            return 1;
+        simulated.append(device);
+    }
+
+    // Сводка раз в 5 секунд
+    QTimer statsTimer;
+    QObject::connect(&statsTimer, &QTimer::timeout, [&simulated]() {
+        for (const SimulatedDevice* device : std::as_const(simulated)) {
+            const SimulatedDevice::Counters& c = device->counters();
+            qDebug().noquote() << QString("port %1: clients %2, samples %3, bytes %4, malformed %5, "
+                                          "dropouts %6, stalls %7, overruns %8")
+                                      .arg(device->port()).arg(c.clients).arg(c.samplesSent).arg(c.bytesSent)
+                                      .arg(c.malformed).arg(c.dropouts).arg(c.stalls).arg(c.overruns);
+        }
+    });
+    statsTimer.start(5000);
+
+    return app.exec();
+}
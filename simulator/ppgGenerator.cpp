@@ -0,0 +1,82 @@
+#include "ppgGenerator.h"
+
+#include <cmath>
+
+namespace {
+
+constexpr double twoPi = 6.283185307179586;
+constexpr double adcMax = 262143.0; // 18 бит
+
+} // namespace
+
+PpgGenerator::PpgGenerator(const Settings& settings)
+    : settings(settings),
+    random(settings.seed)
+{
+    redModulation = settings.perfusionIndex * ratioForSpo2(settings.spo2Percent);
+    startBeat();
+}
+
+double PpgGenerator::ratioForSpo2(double spo2Percent)
+{
+    // Обратная к SpO₂ = 110 − 25·R (SignalProcessor)
+    return qMax(0.0, (110.0 - spo2Percent) / 25.0);
+}
+
+void PpgGenerator::startBeat()
+{
+    const double meanPeriod = 60.0 / qMax(1.0, settings.heartRateBpm);
+    beatPeriodSec = meanPeriod * (1.0 + settings.heartRateVariability * gaussian());
+}
+
+double PpgGenerator::pulseShape(double phase) const
+{
+    // Быстрый систолический подъём, затем спад до следующего удара с дикротическим
+    // «плечом» (не отдельным пиком), максимум = 1 при phase = 0.15
+    constexpr double riseEnd = 0.15;
+    if (phase < riseEnd) {
+        const double s = std::sin(0.25 * twoPi * phase / riseEnd);
+        return s * s;
+    }
+    const double decay = 1.0 - (phase - riseEnd) / (1.0 - riseEnd);
+    const double shoulder = 0.06 * std::exp(-std::pow((phase - 0.45) / 0.06, 2.0));
+    return decay + shoulder;
+}
+
+double PpgGenerator::gaussian()
+{
+    // Бокс — Мюллер
+    const double u1 = qMax(random.generateDouble(), 1e-12);
+    const double u2 = random.generateDouble();
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(twoPi * u2);
+}
+
+SensorSample PpgGenerator::next()
+{
+    const double dt = 1.0 / settings.sampleRateHz;
+    const double t = sampleIndex * dt;
+
+    beatPhase += dt / beatPeriodSec;
+    if (beatPhase >= 1.0) {
+        beatPhase -= 1.0;
+        startBeat();
+    }
+    const double pulse = pulseShape(beatPhase);
+
+    walk += settings.driftAmplitude * 0.01 * gaussian() * std::sqrt(dt);
+    walk *= 1.0 - dt * 0.1; // медленно возвращается к нулю
+    const double drift = settings.driftAmplitude * std::sin(twoPi * t / settings.driftPeriodSec) + walk;
+
+    // Пики направлены вверх — так их ищет детектор SignalProcessor
+    const double ir = settings.irDc * (1.0 + settings.perfusionIndex * pulse) + drift + settings.noise * gaussian();
+    const double red = settings.redDc * (1.0 + redModulation * pulse)
+                       + drift * settings.redDc / settings.irDc + settings.noise * gaussian();
+
+    SensorSample sample;
+    sample.timestamp = settings.startTimestampMs + qint64(t * 1000.0);
+    sample.irValue = std::round(qBound(0.0, ir, adcMax));
+    sample.redValue = std::round(qBound(0.0, red, adcMax));
+    sample.tempValue = settings.temperature + 0.05 * std::sin(twoPi * t / 60.0);
+    ++sampleIndex;
+    return sample;
+}
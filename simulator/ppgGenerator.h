@@ -0,0 +1,52 @@
+#ifndef PPGGENERATOR_H
+#define PPGGENERATOR_H
+
+#include <QRandomGenerator>
+#include "sensorSample.h"
+
+// Синтетический сигнал MAX30102: фотоплетизмограмма IR/Red с заданными пульсом и SpO₂,
+// шумом и дрейфом базовой линии. Детерминирован при одинаковом seed.
+class PpgGenerator
+{
+public:
+    struct Settings {
+        double sampleRateHz = 100.0;
+        double heartRateBpm = 72.0;
+        double heartRateVariability = 0.03; // разброс длительности ударов (доля)
+        double spo2Percent = 97.0;          // пересчитывается в отношение R по формуле приложения
+        double perfusionIndex = 0.02;       // амплитуда пульсаций IR относительно постоянной составляющей
+        double irDc = 100000.0;
+        double redDc = 60000.0;
+        double noise = 10.0;                // СКО белого шума, отсчёты АЦП
+        double driftAmplitude = 300.0;      // дыхательный/двигательный дрейф, отсчёты АЦП
+        double driftPeriodSec = 4.0;
+        double temperature = 36.6;
+        qint64 startTimestampMs = 0;        // начальное значение millis()
+        quint32 seed = 1;
+    };
+
+    explicit PpgGenerator(const Settings& settings);
+
+    SensorSample next();
+
+    // Отношение R = (ACr/DCr)/(ACir/DCir), при котором приложение покажет spo2Percent
+    static double ratioForSpo2(double spo2Percent);
+
+    const Settings& generatorSettings() const { return settings; }
+    quint64 samplesGenerated() const { return sampleIndex; }
+
+private:
+    double pulseShape(double phase) const;
+    double gaussian();
+    void startBeat();
+
+    Settings settings;
+    QRandomGenerator random;
+    double redModulation;
+    quint64 sampleIndex = 0;
+    double beatPhase = 0.0;    // 0..1 внутри текущего удара
+    double beatPeriodSec = 1.0;
+    double walk = 0.0;         // медленное случайное блуждание базовой линии
+};
+
+#endif // PPGGENERATOR_H
@@ -0,0 +1,203 @@
+#include "simulatedDevice.h"
+#include "binaryProtocol.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QTimer>
+#include <cmath>
+#include <cstdio>
+
+SimulatedDevice::SimulatedDevice(const Settings& settings, QObject* parent)
+    : QObject(parent),
+    settings(settings),
+    generator(settings.signal),
+    random(settings.signal.seed ^ 0x5eedu)
+{
+    server = new QTcpServer(this);
+    connect(server, &QTcpServer::newConnection, this, &SimulatedDevice::onNewConnection);
+
+    tickTimer = new QTimer(this);
+    tickTimer->setTimerType(Qt::PreciseTimer);
+    connect(tickTimer, &QTimer::timeout, this, &SimulatedDevice::tick);
+
+    dropoutTimer = new QTimer(this);
+    dropoutTimer->setSingleShot(true);
+    connect(dropoutTimer, &QTimer::timeout, this, &SimulatedDevice::endDropout);
+}
+
+bool SimulatedDevice::start()
+{
+    if (!server->listen(QHostAddress::Any, settings.port)) {
+        qDebug() << "Port" << settings.port << ":" << server->errorString();
+        return false;
+    }
+    if (settings.epochTimestamps) {
+        // Метки времени совпадают с часами хоста — приёмник может считать задержку доставки
+        PpgGenerator::Settings signal = settings.signal;
+        signal.startTimestampMs = QDateTime::currentMSecsSinceEpoch();
+        generator = PpgGenerator(signal);
+    }
+    clock.start();
+    lastTickMs = 0;
+    tickTimer->start(settings.tickMs);
+    qDebug() << "Simulated ESP32 listening on port" << settings.port
+             << (settings.binary ? "(binary frames)" : "(CSV)");
+    return true;
+}
+
+void SimulatedDevice::onNewConnection()
+{
+    while (server->hasPendingConnections()) {
+        QTcpSocket* client = server->nextPendingConnection();
+        client->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        clients.append(client);
+        connect(client, &QTcpSocket::disconnected, this, [this, client]() {
+            clients.removeOne(client);
+            stats.clients = clients.size();
+            client->deleteLater();
+        });
+        qDebug() << "Port" << settings.port << ": client connected";
+    }
+    stats.clients = clients.size();
+}
+
+bool SimulatedDevice::chance(double eventsPerMinute, qint64 intervalMs)
+{
+    return eventsPerMinute > 0.0 && random.generateDouble() < eventsPerMinute * intervalMs / 60000.0;
+}
+
+void SimulatedDevice::tick()
+{
+    const qint64 now = clock.elapsed();
+    const qint64 intervalMs = now - lastTickMs;
+    lastTickMs = now;
+
+    // Отсчёты генерируются по реальному времени, а не по числу срабатываний таймера,
+    // поэтому частота точна при любой дискретности таймера
+    const double due = intervalMs * settings.signal.sampleRateHz / 1000.0 + sampleDebt;
+    const int count = int(qMin(std::floor(due), settings.signal.sampleRateHz * 2.0));
+    sampleDebt = qMin(due - count, 1.0);
+    tickSamples.resize(count);
+    for (int i = 0; i < count; ++i)
+        tickSamples[i] = generator.next();
+
+    // Во время обрыва и зависания millis() на устройстве продолжает идти, данные теряются
+    const Faults& faults = settings.faults;
+    if (inDropout)
+        return;
+    if (chance(faults.dropoutsPerMinute, intervalMs)) {
+        beginDropout();
+        return;
+    }
+    if (stallUntilMs < 0 && chance(faults.stallsPerMinute, intervalMs)) {
+        ++stats.stalls;
+        stallUntilMs = now + faults.stallMs;
+        qDebug() << "Port" << settings.port << ": stall for" << faults.stallMs << "ms";
+    }
+    if (stallUntilMs >= 0) {
+        if (now < stallUntilMs)
+            return;
+        stallUntilMs = -1;
+    }
+    if (count == 0 || clients.isEmpty())
+        return;
+
+    outBuffer.resize(0);
+    if (settings.binary) {
+        for (int offset = 0; offset < count; offset += BinaryProtocol::maxSamplesPerFrame)
+            flushBinary(tickSamples.constData() + offset, qMin(count - offset, BinaryProtocol::maxSamplesPerFrame));
+    } else {
+        for (int i = 0; i < count; ++i) {
+            const qsizetype lineStart = outBuffer.size();
+            appendCsv(tickSamples[i]);
+            if (faults.malformedProbability > 0.0 && random.generateDouble() < faults.malformedProbability)
+                corruptCsvLine(lineStart);
+        }
+    }
+    broadcast(outBuffer, count);
+}
+
+void SimulatedDevice::appendCsv(const SensorSample& sample)
+{
+    // Формат прошивки: "timestamp,IR,Red,Temp\n"
+    char line[96];
+    const int n = std::snprintf(line, sizeof(line), "%lld,%.0f,%.0f,%.2f\n",
+                                static_cast<long long>(sample.timestamp),
+                                sample.irValue, sample.redValue, sample.tempValue);
+    outBuffer.append(line, n);
+}
+
+void SimulatedDevice::corruptCsvLine(qsizetype lineStart)
+{
+    QByteArray line = outBuffer.mid(lineStart);
+    outBuffer.truncate(lineStart);
+    switch (random.bounded(4)) {
+    case 0: // строка оборвана на середине
+        line = line.left(line.size() / 2) + '\n';
+        break;
+    case 1: { // нечисловое значение IR
+        const qsizetype first = line.indexOf(',');
+        line = line.left(first + 1) + "abc" + line.mid(line.indexOf(',', first + 1));
+        break;
+    }
+    case 2: // лишнее поле
+        line.insert(line.size() - 1, ",0");
+        break;
+    default: // мусор длиннее любой допустимой строки
+        line = QByteArray(300, '#') + '\n';
+        break;
+    }
+    outBuffer.append(line);
+    ++stats.malformed;
+}
+
+void SimulatedDevice::flushBinary(const SensorSample* samples, int count)
+{
+    const qsizetype frameStart = outBuffer.size();
+    BinaryProtocol::encodeFrame(frameSequence++, samples, count, outBuffer);
+    const double probability = settings.faults.malformedProbability;
+    if (probability > 0.0 && random.generateDouble() < 1.0 - std::pow(1.0 - probability, count)) {
+        // Один испорченный байт в теле кадра — приёмник должен отбросить кадр по CRC
+        const qsizetype size = outBuffer.size() - frameStart;
+        const qsizetype at = frameStart + BinaryProtocol::headerSize
+                             + random.bounded(int(size - BinaryProtocol::headerSize));
+        outBuffer[at] = char(outBuffer[at] ^ 0x5A);
+        ++stats.malformed;
+    }
+}
+
+void SimulatedDevice::broadcast(const QByteArray& data, int samples)
+{
+    bool delivered = false;
+    for (QTcpSocket* client : std::as_const(clients)) {
+        // Медленный клиент не должен раздувать память симулятора
+        if (client->bytesToWrite() > settings.maxPendingBytes) {
+            ++stats.overruns;
+            continue;
+        }
+        client->write(data);
+        stats.bytesSent += data.size();
+        delivered = true;
+    }
+    if (delivered)
+        stats.samplesSent += samples;
+}
+
+void SimulatedDevice::beginDropout()
+{
+    inDropout = true;
+    ++stats.dropouts;
+    qDebug() << "Port" << settings.port << ": dropout for" << settings.faults.dropoutMs << "ms";
+    const QList<QTcpSocket*> connected = clients;
+    for (QTcpSocket* client : connected)
+        client->abort();
+    server->close();
+    dropoutTimer->start(settings.faults.dropoutMs);
+}
+
+void SimulatedDevice::endDropout()
+{
+    inDropout = false;
+    if (!server->listen(QHostAddress::Any, settings.port))
+        qDebug() << "Port" << settings.port << ": cannot listen again:" << server->errorString();
+}
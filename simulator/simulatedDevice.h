@@ -0,0 +1,90 @@
+#ifndef SIMULATEDDEVICE_H
+#define SIMULATEDDEVICE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QVector>
+#include "ppgGenerator.h"
+
+class QTimer;
+
+// Один эмулируемый ESP32: TCP-сервер на своём порту, поток отсчётов всем подключённым клиентам
+// и управляемые сбои (обрыв связи, битые строки, зависание).
+class SimulatedDevice : public QObject
+{
+    Q_OBJECT
+public:
+    struct Faults {
+        double malformedProbability = 0.0; // доля испорченных строк (кадров)
+        double dropoutsPerMinute = 0.0;    // обрыв: клиенты отключаются, порт закрыт dropoutMs
+        int dropoutMs = 3000;
+        double stallsPerMinute = 0.0;      // зависание: соединение живо, данных нет stallMs
+        int stallMs = 15000;
+    };
+
+    struct Settings {
+        quint16 port = 80;
+        bool binary = false;           // двоичные кадры вместо CSV
+        int tickMs = 10;               // период отправки; отсчёты за тик уходят одним блоком
+        bool epochTimestamps = false;  // метки — мс от эпохи Unix (для замера сквозной задержки)
+        qint64 maxPendingBytes = 4 * 1024 * 1024; // клиент не успевает читать — данные пропускаются
+        PpgGenerator::Settings signal;
+        Faults faults;
+    };
+
+    struct Counters {
+        quint64 samplesSent = 0;
+        quint64 bytesSent = 0;
+        quint64 malformed = 0;
+        quint64 dropouts = 0;
+        quint64 stalls = 0;
+        quint64 overruns = 0; // блоки, не отправленные из-за переполнения буфера сокета
+        int clients = 0;
+    };
+
+    explicit SimulatedDevice(const Settings& settings, QObject* parent = nullptr);
+
+    bool start();
+    quint16 port() const { return settings.port; }
+    const Counters& counters() const { return stats; }
+
+private slots:
+    void onNewConnection();
+    void tick();
+    void endDropout();
+
+private:
+    void appendCsv(const SensorSample& sample);
+    void corruptCsvLine(qsizetype lineStart);
+    void flushBinary(const SensorSample* samples, int count);
+    void broadcast(const QByteArray& data, int samples);
+    bool chance(double eventsPerMinute, qint64 intervalMs);
+    void beginDropout();
+
+    Settings settings;
+    PpgGenerator generator;
+    QRandomGenerator random;
+    QTcpServer* server;
+    QTimer* tickTimer;
+    QTimer* dropoutTimer;
+    QList<QTcpSocket*> clients;
+
+    QElapsedTimer clock;
+    qint64 lastTickMs = 0;
+    double sampleDebt = 0.0;   // дробная часть отсчётов, не выданных на прошлом тике
+    qint64 stallUntilMs = -1;
+    bool inDropout = false;
+    qint64 epochOffsetMs = 0;
+    quint32 frameSequence = 0;
+
+    QByteArray outBuffer;
+    QVector<SensorSample> tickSamples;
+    Counters stats;
+};
+
+#endif // SIMULATEDDEVICE_H
@@ -0,0 +1,72 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+// Кольцевой буфер без блокировок для одного писателя и одного читателя.
+// Писатель никогда не ждёт читателя: при переполнении tryPush() возвращает false.
+template<typename T>
+class SpscRingBuffer
+{
+public:
+    // Ёмкость округляется вверх до степени двойки
+    explicit SpscRingBuffer(int minCapacity)
+    {
+        int capacity = 2;
+        while (capacity < minCapacity)
+            capacity <<= 1;
+        cells.resize(capacity);
+        mask = size_t(capacity) - 1;
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Вызывается только потоком-писателем
+    bool tryPush(const T& value)
+    {
+        const size_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - cachedReadIndex > mask) {
+            cachedReadIndex = readIndex.load(std::memory_order_acquire);
+            if (head - cachedReadIndex > mask)
+                return false;
+        }
+        cells[int(head & mask)] = value;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Вызывается только потоком-читателем; извлекает до maxCount элементов, возвращает их число
+    int tryPop(T* out, int maxCount)
+    {
+        const size_t tail = readIndex.load(std::memory_order_relaxed);
+        const size_t available = writeIndex.load(std::memory_order_acquire) - tail;
+        const int count = int(std::min<size_t>(available, size_t(maxCount)));
+        for (int i = 0; i < count; ++i)
+            out[i] = cells[int((tail + i) & mask)];
+        readIndex.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    int capacity() const { return int(mask + 1); }
+
+    // Приблизительное заполнение (для статистики)
+    int sizeApprox() const
+    {
+        return int(writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire));
+    }
+
+private:
+    QVector<T> cells;
+    size_t mask = 0;
+
+    // Индексы писателя и читателя в разных кэш-линиях, чтобы потоки не мешали друг другу
+    alignas(64) std::atomic<size_t> writeIndex { 0 };
+    size_t cachedReadIndex = 0; // копия readIndex у писателя
+    alignas(64) std::atomic<size_t> readIndex { 0 };
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -0,0 +1,139 @@
+#include "streamRecording.h"
+
+#include <QDateTime>
+#include <QLoggingCategory>
+#include <QtEndian>
+#include <cstring>
+
+Q_LOGGING_CATEGORY(lcRecord, "esp32.record")
+
+using StreamRecording::Chunk;
+
+StreamRecorder::~StreamRecorder()
+{
+    close();
+}
+
+bool StreamRecorder::open(const QString& path)
+{
+    close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(lcRecord) << "StreamRecorder: cannot open" << path << ":" << file.errorString();
+        return false;
+    }
+
+    char header[StreamRecording::fileHeaderSize];
+    memcpy(header, StreamRecording::magic, 4);
+    qToLittleEndian<quint16>(StreamRecording::version, header + 4);
+    qToLittleEndian<quint16>(0, header + 6);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), header + 8);
+    file.write(header, sizeof(header));
+
+    clock.start();
+    sinceFlush.start();
+    payloadBytes = 0;
+    chunks = 0;
+    failed = false;
+    qCInfo(lcRecord) << "Recording raw stream to" << path;
+    return true;
+}
+
+void StreamRecorder::close()
+{
+    if (file.isOpen()) {
+        file.close();
+        qCInfo(lcRecord) << "Recording closed:" << file.fileName() << chunks << "chunks," << payloadBytes << "bytes";
+    }
+}
+
+void StreamRecorder::recordData(const char* data, qsizetype size)
+{
+    if (size > 0)
+        writeChunk(Chunk::Data, data, size);
+}
+
+void StreamRecorder::recordStreamReset()
+{
+    writeChunk(Chunk::StreamReset, nullptr, 0);
+}
+
+void StreamRecorder::writeChunk(Chunk::Type type, const char* data, qsizetype size)
+{
+    if (!file.isOpen() || failed)
+        return;
+
+    char header[StreamRecording::chunkHeaderSize];
+    qToLittleEndian<qint64>(clock.nsecsElapsed(), header);
+    header[8] = char(type);
+    qToLittleEndian<quint32>(quint32(size), header + 9);
+    if (file.write(header, sizeof(header)) != sizeof(header) || (size > 0 && file.write(data, size) != size)) {
+        // Диск заполнен и т. п. — запись прекращается, приём данных продолжается
+        qCWarning(lcRecord) << "StreamRecorder: write failed:" << file.errorString();
+        failed = true;
+        return;
+    }
+    payloadBytes += size;
+    ++chunks;
+
+    // Не реже раза в секунду данные уходят из буфера QFile, чтобы при аварии терялось немного
+    if (sinceFlush.elapsed() >= 1000) {
+        file.flush();
+        sinceFlush.restart();
+    }
+}
+
+bool StreamRecordingReader::open(const QString& path)
+{
+    error.clear();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+
+    char header[StreamRecording::fileHeaderSize];
+    if (file.read(header, sizeof(header)) != sizeof(header) || memcmp(header, StreamRecording::magic, 4) != 0) {
+        error = "not a stream recording";
+        file.close();
+        return false;
+    }
+    const quint16 fileVersion = qFromLittleEndian<quint16>(header + 4);
+    if (fileVersion != StreamRecording::version) {
+        error = QString("unsupported recording version %1").arg(fileVersion);
+        file.close();
+        return false;
+    }
+    startMs = qFromLittleEndian<qint64>(header + 8);
+    return true;
+}
+
+bool StreamRecordingReader::readNext(Chunk& chunk)
+{
+    if (!file.isOpen())
+        return false;
+
+    char header[StreamRecording::chunkHeaderSize];
+    const qint64 headerRead = file.read(header, sizeof(header));
+    if (headerRead == 0)
+        return false;
+    if (headerRead != sizeof(header)) {
+        qCWarning(lcRecord) << "StreamRecordingReader: truncated chunk header at end of" << file.fileName();
+        return false;
+    }
+
+    chunk.offsetNs = qFromLittleEndian<qint64>(header);
+    chunk.type = static_cast<Chunk::Type>(quint8(header[8]));
+    const quint32 size = qFromLittleEndian<quint32>(header + 9);
+    if (size > StreamRecording::maxChunkSize || chunk.type > Chunk::StreamReset) {
+        error = QString("corrupted chunk at offset %1").arg(file.pos() - sizeof(header));
+        return false;
+    }
+
+    chunk.data.resize(size);
+    if (size > 0 && file.read(chunk.data.data(), size) != qint64(size)) {
+        qCWarning(lcRecord) << "StreamRecordingReader: truncated chunk at end of" << file.fileName();
+        return false;
+    }
+    return true;
+}
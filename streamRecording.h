@@ -0,0 +1,86 @@
+#ifndef STREAMRECORDING_H
+#define STREAMRECORDING_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+
+// Запись сырого потока ESP32 в файл (.esprec) — ровно те байты, что пришли из сокета,
+// с моментом приёма на хосте. Повторная подача тех же блоков в декодер и обработку
+// даёт побитово тот же результат.
+//
+// Формат (little-endian):
+//   заголовок, 16 байт: magic "ESPR" | version u16 | reserved u16 | startEpochMs i64
+//   блоки, 13 байт + данные: offsetNs i64 (от начала записи, монотонные часы) | type u8 | size u32 | данные
+namespace StreamRecording {
+
+constexpr char magic[4] = { 'E', 'S', 'P', 'R' };
+constexpr quint16 version = 1;
+constexpr int fileHeaderSize = 16;
+constexpr int chunkHeaderSize = 13;
+constexpr quint32 maxChunkSize = 16 * 1024 * 1024;
+
+struct Chunk {
+    enum Type : quint8 {
+        Data = 0,
+        StreamReset = 1 // новое соединение: декодер начинает поток заново
+    };
+    Type type = Data;
+    qint64 offsetNs = 0;
+    QByteArray data;
+};
+
+} // namespace StreamRecording
+
+class StreamRecorder
+{
+public:
+    StreamRecorder() = default;
+    ~StreamRecorder();
+
+    StreamRecorder(const StreamRecorder&) = delete;
+    StreamRecorder& operator=(const StreamRecorder&) = delete;
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+    QString fileName() const { return file.fileName(); }
+
+    void recordData(const char* data, qsizetype size);
+    void recordStreamReset();
+
+    quint64 bytesRecorded() const { return payloadBytes; }
+    quint64 chunksRecorded() const { return chunks; }
+
+private:
+    void writeChunk(StreamRecording::Chunk::Type type, const char* data, qsizetype size);
+
+    QFile file;
+    QElapsedTimer clock;
+    QElapsedTimer sinceFlush;
+    quint64 payloadBytes = 0;
+    quint64 chunks = 0;
+    bool failed = false;
+};
+
+class StreamRecordingReader
+{
+public:
+    bool open(const QString& path);
+    void close() { file.close(); }
+
+    // false — конец файла или ошибка (см. errorString()); оборванный последний блок считается концом
+    bool readNext(StreamRecording::Chunk& chunk);
+
+    qint64 startEpochMs() const { return startMs; }
+    bool hasError() const { return !error.isEmpty(); }
+    QString errorString() const { return error; }
+
+private:
+    QFile file;
+    qint64 startMs = 0;
+    QString error;
+};
+
+#endif // STREAMRECORDING_H
@@ -0,0 +1,324 @@
+#include "stripChart.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <cmath>
+#include <utility>
+
+namespace {
+const int defaultColumns = 600;
+const int autoRangeCheckColumns = 32; // как часто проверять, не пора ли сузить автодиапазон
+}
+
+StripChart::StripChart(const QString &title, QWidget *parent)
+    : QWidget(parent)
+    , title(title)
+    , columnSec(spanSec / defaultColumns)
+    , ring(defaultColumns)
+{
+    // Фон рисуем сами целиком
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumHeight(120);
+}
+
+void StripChart::setTimeSpan(double seconds)
+{
+    if (seconds <= 0.0 || seconds == spanSec)
+        return;
+    spanSec = seconds;
+    resizeRing(ring.size());
+}
+
+void StripChart::setValueRange(double minimum, double maximum)
+{
+    autoSpan = 0.0;
+    rangeMin = minimum;
+    rangeMax = maximum;
+    fullRedraw = true;
+    changed = true;
+}
+
+void StripChart::setAutoRange(double minimumSpan)
+{
+    autoSpan = qMax(minimumSpan, 1e-9);
+    if (lastValidColumn >= 0)
+        fitAutoRange(lastValue);
+}
+
+void StripChart::setColor(const QColor &newColor)
+{
+    color = newColor;
+    fullRedraw = true;
+    changed = true;
+}
+
+void StripChart::setMarkerColor(const QColor &newColor)
+{
+    markerColor = newColor;
+    changed = true;
+}
+
+void StripChart::addSample(double timeSec, double value)
+{
+    const qint64 column = qint64(std::floor(qMax(0.0, timeSec) / columnSec));
+    const int size = ring.size();
+    if (column > headColumn) {
+        // Новые столбцы вытесняют самые старые; пропущенные по времени остаются пустыми
+        for (qint64 c = qMax(headColumn + 1, column - size + 1); c <= column; ++c)
+            columnAt(c).valid = false;
+        headColumn = column;
+        if (autoSpan > 0.0 && column % autoRangeCheckColumns == 0)
+            fitAutoRange(value);
+    } else if (column <= headColumn - size) {
+        return; // уже за левым краем окна
+    }
+
+    Column &slot = columnAt(column);
+    const float v = float(value);
+    if (!slot.valid) {
+        const bool ordered = lastValidColumn < column;
+        slot = { v, v, v, v, ordered ? lastValidColumn : -1, float(lastValue), true };
+    } else {
+        slot.minimum = qMin(slot.minimum, v);
+        slot.maximum = qMax(slot.maximum, v);
+        slot.last = v;
+    }
+    if (column >= lastValidColumn) {
+        lastValidColumn = column;
+        lastValue = value;
+    }
+    // Столбец уже на картинке — при следующем кадре перерисовать с него
+    if (column <= paintedColumn && (dirtyFrom < 0 || column < dirtyFrom))
+        dirtyFrom = column;
+    if (autoSpan > 0.0 && (value < rangeMin || value > rangeMax))
+        fitAutoRange(value);
+    changed = true;
+}
+
+void StripChart::addMarker(double timeSec, double value)
+{
+    // Скрытый график тоже получает данные, а paintEvent у него не вызывается — чистим здесь
+    dropExpiredMarkers();
+    if (headColumn >= 0 && timeSec < windowStartSec())
+        return;
+    markers.append(QPointF(timeSec, value));
+    changed = true;
+}
+
+void StripChart::dropExpiredMarkers()
+{
+    // Отметки приходят по времени: ушедшие за левый край окна — в начале
+    const double startSec = windowStartSec();
+    int expired = 0;
+    while (expired < markers.size() && markers[expired].x() < startSec)
+        ++expired;
+    if (expired > 0)
+        markers.remove(0, expired);
+}
+
+void StripChart::clear()
+{
+    for (Column &column : ring)
+        column.valid = false;
+    headColumn = -1;
+    lastValidColumn = -1;
+    lastValue = 0.0;
+    markers.clear();
+    paintedColumn = -1;
+    dirtyFrom = -1;
+    fullRedraw = true;
+    changed = true;
+}
+
+void StripChart::updateIfChanged()
+{
+    if (changed && isVisible())
+        update();
+}
+
+QRect StripChart::plotRect() const
+{
+    // Слева — подписи диапазона, сверху — заголовок, снизу — время краёв окна
+    const QFontMetrics metrics = fontMetrics();
+    const int left = metrics.horizontalAdvance("0000000") + 6;
+    const int top = metrics.height() + 4;
+    const int bottom = metrics.height() + 4;
+    return rect().adjusted(left, top, -6, -bottom);
+}
+
+double StripChart::valueToY(double value) const
+{
+    return (rangeMax - value) / (rangeMax - rangeMin) * (plot.height() - 1);
+}
+
+void StripChart::resizeRing(int columns)
+{
+    if (columns <= 0)
+        return;
+    // Старые столбцы переносятся в новую сетку: min/max сливаются, данные окна не теряются
+    const QVector<Column> old = ring;
+    const double oldColumnSec = columnSec;
+    const qint64 oldHead = headColumn;
+    ring = QVector<Column>(columns);
+    columnSec = spanSec / columns;
+    headColumn = -1;
+    lastValidColumn = -1;
+    paintedColumn = -1;
+    dirtyFrom = -1;
+    fullRedraw = true;
+    changed = true;
+    if (oldHead < 0)
+        return;
+
+    const auto remap = [&](qint64 column) { return qint64(std::floor((column + 0.5) * oldColumnSec / columnSec)); };
+    headColumn = remap(oldHead);
+    for (qint64 c = qMax<qint64>(0, oldHead - old.size() + 1); c <= oldHead; ++c) {
+        const Column &from = old[int(c % old.size())];
+        const qint64 target = remap(c);
+        if (!from.valid || target <= headColumn - columns)
+            continue;
+        Column &to = columnAt(target);
+        if (!to.valid || target > lastValidColumn) {
+            to = from;
+            to.previous = lastValidColumn;
+            to.previousValue = float(lastValue);
+        } else {
+            to.minimum = qMin(to.minimum, from.minimum);
+            to.maximum = qMax(to.maximum, from.maximum);
+            to.last = from.last;
+        }
+        lastValidColumn = target;
+        lastValue = from.last;
+    }
+}
+
+void StripChart::fitAutoRange(double value)
+{
+    // Диапазон по видимым данным с запасом 10% с каждой стороны
+    double low = value;
+    double high = value;
+    for (qint64 c = qMax<qint64>(0, headColumn - ring.size() + 1); c <= headColumn; ++c) {
+        const Column &column = columnAt(c);
+        if (!column.valid)
+            continue;
+        low = qMin(low, double(column.minimum));
+        high = qMax(high, double(column.maximum));
+    }
+    const bool inside = low >= rangeMin && high <= rangeMax;
+    const bool tooWide = (rangeMax - rangeMin) > 3.0 * qMax(autoSpan, high - low);
+    if (inside && !tooWide)
+        return;
+    const double span = qMax(autoSpan, (high - low) * 1.2);
+    const double center = (low + high) / 2.0;
+    rangeMin = center - span / 2.0;
+    rangeMax = center + span / 2.0;
+    fullRedraw = true;
+}
+
+void StripChart::updatePlot()
+{
+    const int width = plot.width();
+    const QColor background = palette().color(QPalette::Base);
+    const qint64 oldest = headColumn - width + 1;
+    qint64 from = oldest;
+    const bool full = fullRedraw || paintedColumn < 0 || headColumn < paintedColumn
+                      || headColumn - paintedColumn >= width;
+    if (full) {
+        plot.fill(background);
+    } else {
+        // Сдвиг готовой картинки на число новых столбцов; последний нарисованный столбец мог
+        // быть неполным, поэтому он перерисовывается вместе с новыми
+        const int shift = int(headColumn - paintedColumn);
+        if (shift > 0)
+            plot.scroll(-shift, 0, plot.rect());
+        from = qMax(oldest, dirtyFrom >= 0 ? qMin(dirtyFrom, paintedColumn) : paintedColumn);
+    }
+
+    QPainter painter(&plot);
+    if (!full) {
+        const int x = columnToX(from);
+        painter.fillRect(QRect(x, 0, width - x, plot.height()), background);
+    }
+    drawColumns(painter, from, headColumn);
+
+    paintedColumn = headColumn;
+    dirtyFrom = -1;
+    fullRedraw = false;
+}
+
+void StripChart::drawColumns(QPainter &painter, qint64 from, qint64 to) const
+{
+    painter.setPen(QPen(color, 1));
+    for (qint64 c = qMax<qint64>(0, from); c <= to; ++c) {
+        const Column &column = columnAt(c);
+        if (!column.valid)
+            continue;
+        const int x = columnToX(c);
+        // Линия от последнего значения предыдущего непустого столбца (он может быть за краем)
+        if (column.previous >= 0)
+            painter.drawLine(QPointF(columnToX(column.previous), valueToY(column.previousValue)),
+                             QPointF(x, valueToY(column.first)));
+        painter.drawLine(QPointF(x, valueToY(column.maximum)), QPointF(x, valueToY(column.minimum)));
+    }
+}
+
+void StripChart::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    const QRect area = plotRect();
+    if (area.width() > 0 && area.width() != ring.size())
+        resizeRing(area.width());
+}
+
+void StripChart::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().color(QPalette::Window));
+    changed = false;
+
+    const QRect area = plotRect();
+    if (area.width() <= 0 || area.height() <= 0)
+        return;
+    if (area.width() != ring.size())
+        resizeRing(area.width());
+    if (plot.size() != area.size()) {
+        plot = QPixmap(area.size());
+        fullRedraw = true;
+    }
+    updatePlot();
+    painter.drawPixmap(area.topLeft(), plot);
+
+    // Отметки пиков — поверх картинки, их немного; ушедшие за левый край удаляем
+    dropExpiredMarkers();
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(markerColor);
+    for (const QPointF &marker : std::as_const(markers)) {
+        const qint64 column = qint64(std::floor(marker.x() / columnSec));
+        if (column > headColumn)
+            continue;
+        const QPointF center(area.left() + columnToX(column), area.top() + valueToY(marker.y()));
+        if (area.contains(center.toPoint()))
+            painter.drawEllipse(center, 4.0, 4.0);
+    }
+    painter.setRenderHint(QPainter::Antialiasing, false);
+
+    // Рамка и подписи
+    const QFontMetrics metrics = fontMetrics();
+    painter.setPen(palette().color(QPalette::WindowText));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(area.adjusted(0, 0, -1, -1));
+    painter.drawText(QRect(area.left(), 0, area.width(), area.top()), Qt::AlignLeft | Qt::AlignVCenter, title);
+    if (lastValidColumn >= 0)
+        painter.drawText(QRect(area.left(), 0, area.width(), area.top()), Qt::AlignRight | Qt::AlignVCenter,
+                         QString::number(lastValue, 'f', 1));
+    const QRect labels(0, area.top(), area.left() - 4, area.height());
+    painter.drawText(labels, Qt::AlignRight | Qt::AlignTop, QString::number(rangeMax, 'f', 0));
+    painter.drawText(labels, Qt::AlignRight | Qt::AlignBottom, QString::number(rangeMin, 'f', 0));
+    if (headColumn >= 0) {
+        const QRect times(area.left(), area.bottom() + 2, area.width(), metrics.height());
+        painter.drawText(times, Qt::AlignLeft, QString::number(qMax(0.0, windowStartSec()), 'f', 1) + " s");
+        painter.drawText(times, Qt::AlignRight, QString::number((headColumn + 1) * columnSec, 'f', 1) + " s");
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef STRIPCHART_H
+#define STRIPCHART_H
+
+#include <QColor>
+#include <QPixmap>
+#include <QPointF>
+#include <QVector>
+#include <QWidget>
+
+// Лёгкий самописец на QPainter — замена QChartView для непрерывно бегущих графиков.
+// Видимые данные хранятся кольцом по столбцам экрана: у каждого столбца минимум, максимум,
+// первое и последнее значение, поэтому отсчёт стоит O(1) при любой частоте дискретизации.
+// Готовое изображение лежит в QPixmap; за кадр он сдвигается на число новых столбцов и
+// дорисовываются только они. Полностью картинка перерисовывается при смене масштаба по Y
+// или размера виджета.
+class StripChart : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit StripChart(const QString &title, QWidget *parent = nullptr);
+
+    //! Длительность видимого окна, с
+    void setTimeSpan(double seconds);
+    //! Постоянный диапазон по Y
+    void setValueRange(double minimum, double maximum);
+    //! Диапазон по Y по видимым данным, не уже minimumSpan
+    void setAutoRange(double minimumSpan);
+    void setColor(const QColor &color);
+    void setMarkerColor(const QColor &color);
+
+    //! Время — секунды от начала сессии, не убывает (более старые отсчёты окна допустимы)
+    void addSample(double timeSec, double value);
+    //! Отметка поверх графика (пик)
+    void addMarker(double timeSec, double value);
+    void clear();
+
+    //! Запрос перерисовки, только если с прошлого кадра пришли данные
+    void updateIfChanged();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    struct Column {
+        float minimum;
+        float maximum;
+        float first;
+        float last;
+        qint64 previous;     // предыдущий непустой столбец (-1 — нет): линия через пропуски
+        float previousValue;
+        bool valid;
+    };
+
+    QRect plotRect() const;
+    Column &columnAt(qint64 column) { return ring[int(column % ring.size())]; }
+    const Column &columnAt(qint64 column) const { return ring[int(column % ring.size())]; }
+    double valueToY(double value) const;
+    int columnToX(qint64 column) const { return ring.size() - 1 - int(headColumn - column); }
+    double windowStartSec() const { return (headColumn - ring.size() + 1) * columnSec; } // левый край окна
+
+    void resizeRing(int columns);
+    void fitAutoRange(double value);
+    void dropExpiredMarkers();
+    void updatePlot();
+    void drawColumns(QPainter &painter, qint64 from, qint64 to) const;
+
+    QString title;
+    QColor color = Qt::blue;
+    QColor markerColor = Qt::red;
+    double spanSec = 20.0;
+    double columnSec;
+    double rangeMin = 0.0;
+    double rangeMax = 1.0;
+    double autoSpan = 0.0; // 0 — постоянный диапазон
+
+    QVector<Column> ring;
+    qint64 headColumn = -1;      // номер самого нового столбца (от начала сессии)
+    qint64 lastValidColumn = -1;
+    double lastValue = 0.0;
+    QVector<QPointF> markers;    // (время, значение), только видимые
+
+    QPixmap plot;
+    qint64 paintedColumn = -1;   // самый новый столбец, уже нарисованный в plot
+    qint64 dirtyFrom = -1;       // самый старый изменённый столбец среди нарисованных
+    bool fullRedraw = true;
+    bool changed = false;
+};
+
+#endif // STRIPCHART_H